@@ -0,0 +1,388 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "halfHelpers.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define HALF_HELPERS_F16C 1
+#define HALF_HELPERS_F16C_TARGET __attribute__((target("f16c")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define HALF_HELPERS_F16C 1
+#define HALF_HELPERS_F16C_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__)
+#define HALF_HELPERS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// One entry per sign and biased exponent of the source format. A finite
+// result is base + (significand >> shift), plus a rounding increment that
+// depends on the bits shifted out. base holds the sign and, for results that
+// are normal halfs, the exponent minus one so that the implicit bit of the
+// significand carries it into place. A shift of zero marks an exponent that
+// overflows half.
+struct HalfTableEntry
+{
+    uint16_t base;
+    uint8_t shift;
+};
+
+// UInt is the bit pattern of the source format, which has MantBits explicit
+// mantissa bits and ExpBits exponent bits.
+template <typename UInt, int MantBits, int ExpBits> struct HalfTable
+{
+    static const int kExpMax = (1 << ExpBits) - 1;
+    static const int kBias = (1 << (ExpBits - 1)) - 1;
+
+    HalfTableEntry entries[2 << ExpBits];
+
+    HalfTable()
+    {
+        // Exponents of the smallest normal half and the first overflowing one
+        const int normalExp = kBias - 14;
+        const int overflowExp = kBias + 16;
+        // Shifting by this much leaves nothing of any significand, and its
+        // halfway point is above all of them, so it also covers underflow.
+        const int maxShift = MantBits + 2;
+
+        for (int sign = 0; sign < 2; sign++)
+        {
+            for (int exp = 0; exp <= kExpMax; exp++)
+            {
+                HalfTableEntry &e = entries[(sign << ExpBits) | exp];
+                e.base = (uint16_t)(sign << 15);
+                if (exp >= overflowExp)
+                {
+                    e.shift = 0;
+                }
+                else if (exp >= normalExp)
+                {
+                    e.base |= (uint16_t)((exp - normalExp) << 10);
+                    e.shift = MantBits - 10;
+                }
+                else
+                {
+                    // Subnormal half. Subnormal inputs have the same scale as
+                    // the smallest normal exponent, without the implicit bit.
+                    int shift = MantBits - 10 + normalExp - (exp ? exp : 1);
+                    e.shift = (uint8_t)(shift < maxShift ? shift : maxShift);
+                }
+            }
+        }
+    }
+
+    template <cl_half_rounding_mode Mode> cl_half convert(UInt bits) const
+    {
+        const UInt mantMask = ((UInt)1 << MantBits) - 1;
+        const unsigned signExp = (unsigned)(bits >> MantBits);
+        const unsigned exp = signExp & kExpMax;
+        const uint16_t sign = (uint16_t)(signExp >> ExpBits);
+        const UInt mant = bits & mantMask;
+
+        if (exp == kExpMax)
+        {
+            // Infinity, or NaN with its payload truncated and quieted
+            if (mant)
+                return (cl_half)((sign << 15) | 0x7e00
+                                 | (uint16_t)(mant >> (MantBits - 10)));
+            return (cl_half)((sign << 15) | 0x7c00);
+        }
+
+        const HalfTableEntry &e = entries[signExp];
+        if (0 == e.shift) return overflow<Mode>(sign);
+
+        const UInt sig = exp ? (mant | ((UInt)1 << MantBits)) : mant;
+        const UInt rem = sig & (((UInt)1 << e.shift) - 1);
+        const UInt halfway = (UInt)1 << (e.shift - 1);
+        cl_half h = (cl_half)(e.base + (uint16_t)(sig >> e.shift));
+
+        // A carry out of the mantissa bumps the exponent, up to infinity
+        switch (Mode)
+        {
+            case CL_HALF_RTE:
+                h += (rem > halfway || (rem == halfway && (h & 1))) ? 1 : 0;
+                break;
+            case CL_HALF_RTP: h += (rem && !sign) ? 1 : 0; break;
+            case CL_HALF_RTN: h += (rem && sign) ? 1 : 0; break;
+            default: break;
+        }
+        return h;
+    }
+
+    template <cl_half_rounding_mode Mode>
+    static cl_half overflow(uint16_t sign)
+    {
+        const cl_half maxFinite = (cl_half)((sign << 15) | 0x7bff);
+        const cl_half infinity = (cl_half)((sign << 15) | 0x7c00);
+        switch (Mode)
+        {
+            case CL_HALF_RTZ: return maxFinite;
+            case CL_HALF_RTP: return sign ? maxFinite : infinity;
+            case CL_HALF_RTN: return sign ? infinity : maxFinite;
+            default: return infinity;
+        }
+    }
+};
+
+typedef HalfTable<uint32_t, 23, 8> FloatHalfTable;
+typedef HalfTable<uint64_t, 52, 11> DoubleHalfTable;
+
+const FloatHalfTable &float_table()
+{
+    static const FloatHalfTable table;
+    return table;
+}
+
+const DoubleHalfTable &double_table()
+{
+    static const DoubleHalfTable table;
+    return table;
+}
+
+template <cl_half_rounding_mode Mode, typename Table, typename T>
+void table_convert(const Table &table, cl_half *dst, const T *src,
+                   size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type
+            bits;
+        memcpy(&bits, src + i, sizeof(bits));
+        dst[i] = table.template convert<Mode>(bits);
+    }
+}
+
+template <typename Table, typename T>
+void table_convert(const Table &table, cl_half *dst, const T *src,
+                   size_t count, cl_half_rounding_mode rounding_mode)
+{
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTZ:
+            table_convert<CL_HALF_RTZ>(table, dst, src, count);
+            break;
+        case CL_HALF_RTP:
+            table_convert<CL_HALF_RTP>(table, dst, src, count);
+            break;
+        case CL_HALF_RTN:
+            table_convert<CL_HALF_RTN>(table, dst, src, count);
+            break;
+        default: table_convert<CL_HALF_RTE>(table, dst, src, count); break;
+    }
+}
+
+#if defined(HALF_HELPERS_F16C)
+
+bool host_has_f16c()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const int osxsave = 1 << 27, avx = 1 << 28, f16c = 1 << 29;
+    if ((info[2] & (osxsave | avx | f16c)) != (osxsave | avx | f16c))
+        return false;
+    // The OS must also save the upper halves of the YMM registers
+    return (_xgetbv(0) & 6) == 6;
+#else
+    return __builtin_cpu_supports("f16c");
+#endif
+}
+
+// Imm is the VCVTPS2PH rounding control: nearest even, down, up, truncate
+template <int Imm>
+HALF_HELPERS_F16C_TARGET void f16c_convert(cl_half *dst, const float *src,
+                                           size_t count,
+                                           cl_half_rounding_mode rounding_mode)
+{
+    const __m128i expMask = _mm_set1_epi32(0x7f800000);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(src + i);
+
+        // VCVTPS2PH honours MXCSR.DAZ, so leave inputs with a zero exponent
+        // to the table to stay independent of the caller's FPU state.
+        __m128i exp = _mm_and_si128(_mm_castps_si128(v), expMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(exp, zero)))
+        {
+            table_convert(float_table(), dst + i, src + i, 4, rounding_mode);
+            continue;
+        }
+
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_cvtps_ph(v, Imm));
+    }
+
+    table_convert(float_table(), dst + i, src + i, count - i, rounding_mode);
+}
+
+HALF_HELPERS_F16C_TARGET void f16c_half_to_float(float *dst,
+                                                 const cl_half *src,
+                                                 size_t count)
+{
+    const __m128i expMask = _mm_set1_epi16(0x7c00);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i *)(src + i));
+
+        // Leave zero exponents to the scalar code so subnormals do not
+        // depend on MXCSR.DAZ, and all-ones exponents so that signaling NaNs
+        // are not quieted.
+        __m128i exp = _mm_and_si128(h, expMask);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi16(exp, zero),
+                                           _mm_cmpeq_epi16(exp, expMask))))
+        {
+            for (size_t j = i; j < i + 8; j++)
+                dst[j] = cl_half_to_float(src[j]);
+            continue;
+        }
+
+        _mm_storeu_ps(dst + i, _mm_cvtph_ps(h));
+        _mm_storeu_ps(dst + i + 4, _mm_cvtph_ps(_mm_srli_si128(h, 8)));
+    }
+
+    for (; i < count; i++) dst[i] = cl_half_to_float(src[i]);
+}
+
+#elif defined(HALF_HELPERS_NEON)
+
+// FCVTN rounds according to FPCR, so run it with the requested rounding
+// mode and with flush-to-zero, default-NaN and alternative half precision
+// disabled. FPCR is per thread, so this is safe inside ThreadPool jobs.
+void neon_convert(cl_half *dst, const float *src, size_t count,
+                  cl_half_rounding_mode rounding_mode)
+{
+    const uint64_t rmodeShift = 22;
+    const uint64_t clearBits = (3ULL << rmodeShift) | (1ULL << 19) // FZ16
+        | (1ULL << 24) // FZ
+        | (1ULL << 25) // DN
+        | (1ULL << 26); // AHP
+    uint64_t rmode;
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTP: rmode = 1; break;
+        case CL_HALF_RTN: rmode = 2; break;
+        case CL_HALF_RTZ: rmode = 3; break;
+        default: rmode = 0; break;
+    }
+
+    uint64_t fpcr;
+    __asm__ volatile("mrs %0, fpcr" : "=r"(fpcr));
+    uint64_t newFpcr = (fpcr & ~clearBits) | (rmode << rmodeShift);
+    __asm__ volatile("msr fpcr, %0" ::"r"(newFpcr) : "memory");
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float16x4_t h = vcvt_f16_f32(vld1q_f32(src + i));
+        vst1_u16((uint16_t *)(dst + i), vreinterpret_u16_f16(h));
+    }
+
+    __asm__ volatile("msr fpcr, %0" ::"r"(fpcr) : "memory");
+
+    table_convert(float_table(), dst + i, src + i, count - i, rounding_mode);
+}
+
+#endif
+
+} // namespace
+
+void float_to_half_array(cl_half *dst, const float *src, size_t count,
+                         cl_half_rounding_mode rounding_mode)
+{
+#if defined(HALF_HELPERS_F16C)
+    static const bool hasF16C = host_has_f16c();
+    if (hasF16C)
+    {
+        switch (rounding_mode)
+        {
+            case CL_HALF_RTN:
+                f16c_convert<1>(dst, src, count, rounding_mode);
+                break;
+            case CL_HALF_RTP:
+                f16c_convert<2>(dst, src, count, rounding_mode);
+                break;
+            case CL_HALF_RTZ:
+                f16c_convert<3>(dst, src, count, rounding_mode);
+                break;
+            default: f16c_convert<0>(dst, src, count, rounding_mode); break;
+        }
+        return;
+    }
+    table_convert(float_table(), dst, src, count, rounding_mode);
+#elif defined(HALF_HELPERS_NEON)
+    neon_convert(dst, src, count, rounding_mode);
+#else
+    table_convert(float_table(), dst, src, count, rounding_mode);
+#endif
+}
+
+void double_to_half_array(cl_half *dst, const double *src, size_t count,
+                          cl_half_rounding_mode rounding_mode)
+{
+    table_convert(double_table(), dst, src, count, rounding_mode);
+}
+
+void half_to_float_array(float *dst, const cl_half *src, size_t count)
+{
+#if defined(HALF_HELPERS_F16C)
+    static const bool hasF16C = host_has_f16c();
+    if (hasF16C)
+    {
+        f16c_half_to_float(dst, src, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) dst[i] = cl_half_to_float(src[i]);
+}
+
+cl_half float_to_half_table(float f, cl_half_rounding_mode rounding_mode)
+{
+    cl_half h;
+    table_convert(float_table(), &h, &f, 1, rounding_mode);
+    return h;
+}
+
+cl_half double_to_half_table(double d, cl_half_rounding_mode rounding_mode)
+{
+    cl_half h;
+    table_convert(double_table(), &h, &d, 1, rounding_mode);
+    return h;
+}
+
+const char *get_float_to_half_engine_name(void)
+{
+#if defined(HALF_HELPERS_F16C)
+    static const bool hasF16C = host_has_f16c();
+    return hasF16C ? "F16C" : "lookup table";
+#elif defined(HALF_HELPERS_NEON)
+    return "NEON";
+#else
+    return "lookup table";
+#endif
+}
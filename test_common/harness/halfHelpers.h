@@ -0,0 +1,47 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _halfHelpers_h
+#define _halfHelpers_h
+
+#include <stddef.h>
+
+#include <CL/cl_half.h>
+
+// Bulk conversions to half precision. The results are bit-identical to
+// calling cl_half_from_float()/cl_half_from_double() on every element with
+// the same rounding mode, including NaN payloads and subnormal results.
+//
+// Floats are converted with F16C on x86 hosts that have it and with NEON on
+// AArch64. Everything else, including all double conversions, goes through
+// a lookup table indexed by the sign and exponent of the input, so the per
+// element work is a shift and a rounding increment.
+void float_to_half_array(cl_half *dst, const float *src, size_t count,
+                         cl_half_rounding_mode rounding_mode);
+void double_to_half_array(cl_half *dst, const double *src, size_t count,
+                          cl_half_rounding_mode rounding_mode);
+
+// Bulk conversion from half precision, bit-identical to cl_half_to_float() on
+// every element. F16C is used on x86 hosts that have it.
+void half_to_float_array(float *dst, const cl_half *src, size_t count);
+
+// Table-driven scalar conversions, for callers that need a single value.
+cl_half float_to_half_table(float f, cl_half_rounding_mode rounding_mode);
+cl_half double_to_half_table(double d, cl_half_rounding_mode rounding_mode);
+
+// Describes the path float_to_half_array() takes on this host, for logging.
+const char *get_float_to_half_engine_name(void);
+
+#endif // _halfHelpers_h
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "hostArrays.h"
+#include "alloc.h"
+#include "errorHelpers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t kHostArrayAlignment = 4096;
+
+void HostArrayAllocator::Init(cl_context context, cl_device_id device,
+                              bool zeroCopy)
+{
+    mContext = context;
+    mZeroCopy = zeroCopy;
+    mUseSVM = false;
+    if (!zeroCopy) return;
+
+    cl_device_svm_capabilities svmCaps = 0;
+    if (clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES, sizeof(svmCaps),
+                        &svmCaps, NULL))
+        svmCaps = 0;
+    mUseSVM = 0 != (svmCaps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER);
+}
+
+void *HostArrayAllocator::Alloc(size_t size) const
+{
+    void *p;
+    if (!mZeroCopy)
+        p = malloc(size);
+    else if (mUseSVM)
+        p = clSVMAlloc(mContext,
+                       CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER, size,
+                       kHostArrayAlignment);
+    else
+        p = align_malloc(size, kHostArrayAlignment);
+
+    if (NULL == p)
+        log_error("Failed to allocate a %zu byte host array%s\n", size,
+                  mUseSVM ? " with clSVMAlloc" : "");
+    return p;
+}
+
+void HostArrayAllocator::Free(void *p) const
+{
+    if (NULL == p) return;
+    if (!mZeroCopy)
+        free(p);
+    else if (mUseSVM)
+        clSVMFree(mContext, p);
+    else
+        align_free(p);
+}
+
+cl_mem HostArrayAllocator::CreateBuffer(cl_mem_flags flags, size_t size,
+                                        void *hostPtr, cl_int *error) const
+{
+    if (mZeroCopy)
+        return clCreateBuffer(mContext,
+                              (flags & ~CL_MEM_ALLOC_HOST_PTR)
+                                  | CL_MEM_USE_HOST_PTR,
+                              size, hostPtr, error);
+
+    return clCreateBuffer(mContext, flags, size, NULL, error);
+}
+
+cl_int HostArrayAllocator::BeginWrite(cl_command_queue queue, cl_mem buffer,
+                                      size_t size, void **mapped) const
+{
+    *mapped = NULL;
+    if (!mZeroCopy) return CL_SUCCESS;
+
+    // Waits for earlier work on buffer, so hostPtr is free to be refilled.
+    cl_int error;
+    *mapped = clEnqueueMapBuffer(queue, buffer, CL_TRUE,
+                                 CL_MAP_WRITE_INVALIDATE_REGION, 0, size, 0,
+                                 NULL, NULL, &error);
+    if (error || NULL == *mapped)
+    {
+        log_error("clEnqueueMapBuffer failed for writing. (%d)\n", error);
+        *mapped = NULL;
+        return error ? error : CL_INVALID_VALUE;
+    }
+    return CL_SUCCESS;
+}
+
+cl_int HostArrayAllocator::EndWrite(cl_command_queue queue, cl_mem buffer,
+                                    cl_bool blocking, size_t size,
+                                    const void *hostPtr, void *mapped)
+{
+    cl_int error;
+    if (NULL == mapped)
+    {
+        if ((error = clEnqueueWriteBuffer(queue, buffer, blocking, 0, size,
+                                          hostPtr, 0, NULL, NULL)))
+            log_error("clEnqueueWriteBuffer failed. (%d)\n", error);
+        return error;
+    }
+
+    // The spec guarantees the mapping is derived from the host_ptr the
+    // buffer was created with, but fall back to a copy rather than trust it.
+    if (mapped != hostPtr)
+        memcpy(mapped, hostPtr, size);
+    else
+        mBytesSaved += size;
+
+    if ((error = clEnqueueUnmapMemObject(queue, buffer, mapped, 0, NULL, NULL)))
+        log_error("clEnqueueUnmapMemObject failed. (%d)\n", error);
+    return error;
+}
+
+cl_int HostArrayAllocator::Read(cl_command_queue queue, cl_mem buffer,
+                                size_t size, void *hostPtr)
+{
+    cl_int error;
+    if (!mZeroCopy)
+    {
+        if ((error = clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0, size,
+                                         hostPtr, 0, NULL, NULL)))
+            log_error("clEnqueueReadBuffer failed. (%d)\n", error);
+        return error;
+    }
+
+    void *p = clEnqueueMapBuffer(queue, buffer, CL_TRUE, CL_MAP_READ, 0, size,
+                                 0, NULL, NULL, &error);
+    if (error || NULL == p)
+    {
+        log_error("clEnqueueMapBuffer failed for reading. (%d)\n", error);
+        return error ? error : CL_INVALID_VALUE;
+    }
+
+    if (p != hostPtr)
+        memcpy(hostPtr, p, size);
+    else
+        mBytesSaved += size;
+
+    if ((error = clEnqueueUnmapMemObject(queue, buffer, p, 0, NULL, NULL)))
+        log_error("clEnqueueUnmapMemObject failed. (%d)\n", error);
+    return error;
+}
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _hostArrays_h
+#define _hostArrays_h
+
+#if defined(__APPLE__)
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <stddef.h>
+
+// Host arrays that can double as the backing store of device buffers.
+//
+// In zero-copy mode the arrays come from fine-grain SVM when the device
+// supports it and from page aligned host memory otherwise, and buffers
+// created over them use CL_MEM_USE_HOST_PTR. Otherwise the arrays are
+// plain malloc allocations and the buffers own their storage.
+//
+// Writes come in two halves so that in zero-copy mode the host only fills an
+// array while its buffer is mapped: BeginWrite maps the buffer, the caller
+// fills hostPtr, and EndWrite unmaps it. Outside zero-copy mode BeginWrite
+// does nothing and EndWrite copies hostPtr with clEnqueueWriteBuffer.
+class HostArrayAllocator {
+public:
+    HostArrayAllocator()
+        : mContext(NULL), mZeroCopy(false), mUseSVM(false), mBytesSaved(0)
+    {}
+
+    // Call once the context exists, before the first Alloc.
+    void Init(cl_context context, cl_device_id device, bool zeroCopy);
+
+    // Logs and returns NULL on failure.
+    void *Alloc(size_t size) const;
+    void Free(void *p) const;
+
+    // CL_MEM_ALLOC_HOST_PTR in flags only applies outside zero-copy mode.
+    cl_mem CreateBuffer(cl_mem_flags flags, size_t size, void *hostPtr,
+                        cl_int *error) const;
+
+    // *mapped receives the mapping to pass to EndWrite, or NULL.
+    cl_int BeginWrite(cl_command_queue queue, cl_mem buffer, size_t size,
+                      void **mapped) const;
+    cl_int EndWrite(cl_command_queue queue, cl_mem buffer, cl_bool blocking,
+                    size_t size, const void *hostPtr, void *mapped);
+    // Blocking read of the first size bytes of buffer into hostPtr.
+    cl_int Read(cl_command_queue queue, cl_mem buffer, size_t size,
+                void *hostPtr);
+
+    bool ZeroCopy() const { return mZeroCopy; }
+    bool UsesSVM() const { return mUseSVM; }
+    // Bytes that zero-copy mode did not have to copy.
+    cl_ulong BytesSaved() const { return mBytesSaved; }
+
+private:
+    cl_context mContext;
+    bool mZeroCopy;
+    bool mUseSVM;
+    cl_ulong mBytesSaved;
+};
+
+#endif // _hostArrays_h
@@ -0,0 +1,829 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "imageCodec.h"
+#include "halfHelpers.h"
+#include "imageHelpers.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)                                       \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_CODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+extern RoundingMode gFloatToHalfRoundingMode;
+
+namespace {
+
+// Pixels converted per step of the row functions, sized for the stack
+const size_t kCodecChunkPixels = 64;
+
+#define CLAMP_FLOAT(v) (fmaxf(fminf(v, 1.f), -1.f))
+
+//
+// Decoders. These write tempChannels floats per pixel in memory order.
+//
+template <typename T>
+void decode_integer(const ImageFormatCodec *codec, const void *src,
+                    size_t pixelCount, float *dst)
+{
+    const T *p = (const T *)src;
+    size_t n = pixelCount * codec->channelCount;
+    for (size_t i = 0; i < n; i++) dst[i] = (float)p[i];
+}
+
+template <typename T>
+void decode_snorm(const ImageFormatCodec *codec, const void *src,
+                  size_t pixelCount, float *dst)
+{
+    const float scale = (float)std::numeric_limits<T>::max();
+    const T *p = (const T *)src;
+    size_t n = pixelCount * codec->channelCount;
+    for (size_t i = 0; i < n; i++) dst[i] = CLAMP_FLOAT((float)p[i] / scale);
+}
+
+template <typename T> void unorm_to_float(const T *p, size_t n, float *dst)
+{
+    const float scale = (float)std::numeric_limits<T>::max();
+    for (size_t i = 0; i < n; i++) dst[i] = (float)p[i] / scale;
+}
+
+#if defined(IMAGE_CODEC_SSE2)
+// The division is correctly rounded in SSE2 as well, so these match the
+// scalar loop exactly.
+template <> void unorm_to_float(const cl_uchar *p, size_t n, float *dst)
+{
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i q[4] = { _mm_unpacklo_epi16(lo, zero),
+                         _mm_unpackhi_epi16(lo, zero),
+                         _mm_unpacklo_epi16(hi, zero),
+                         _mm_unpackhi_epi16(hi, zero) };
+        for (int k = 0; k < 4; k++)
+            _mm_storeu_ps(dst + i + 4 * k,
+                          _mm_div_ps(_mm_cvtepi32_ps(q[k]), scale));
+    }
+    for (; i < n; i++) dst[i] = (float)p[i] / 255.0f;
+}
+
+template <> void unorm_to_float(const cl_ushort *p, size_t n, float *dst)
+{
+    const __m128 scale = _mm_set1_ps(65535.0f);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        _mm_storeu_ps(dst + i,
+                      _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)),
+                                 scale));
+        _mm_storeu_ps(dst + i + 4,
+                      _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)),
+                                 scale));
+    }
+    for (; i < n; i++) dst[i] = (float)p[i] / 65535.0f;
+}
+#endif
+
+template <typename T>
+void decode_unorm(const ImageFormatCodec *codec, const void *src,
+                  size_t pixelCount, float *dst)
+{
+    unorm_to_float((const T *)src, pixelCount * codec->channelCount, dst);
+}
+
+// Steps per unit of the encode guess table
+const int kSRGBGuessSteps = 4096;
+
+// sRGBunmap and the rounded sRGBmap for 8 bit channels, as tables. Decoding
+// has only 256 inputs. Encoding looks up a lower bound for the result by the
+// input scaled to kSRGBGuessSteps, then steps up over the thresholds: the
+// sRGB curve is no steeper than 12.92 * 255 codes per unit, so that is one
+// or two steps at most.
+struct SRGBTables
+{
+    float decode[256];
+    // Smallest input in [0, 1] that encodes to each code
+    float threshold[257];
+    cl_uchar guess[kSRGBGuessSteps + 1];
+
+    SRGBTables()
+    {
+        cl_uchar codes[256];
+        for (int i = 0; i < 256; i++) codes[i] = (cl_uchar)i;
+        unorm_to_float(codes, 256, decode);
+        for (int i = 0; i < 256; i++) decode[i] = (float)sRGBunmap(decode[i]);
+
+        // sRGBmap is monotonic over [0, 1], and so are the bit patterns of
+        // positive floats, so search the bits for each code's first input
+        threshold[0] = 0.f;
+        for (int code = 1; code < 256; code++)
+        {
+            uint32_t lo = 0, hi = 0x3f800000;
+            while (lo < hi)
+            {
+                uint32_t mid = lo + (hi - lo) / 2;
+                if (encode_reference(bits_to_float(mid)) >= code)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            threshold[code] = bits_to_float(lo);
+        }
+        threshold[256] = std::numeric_limits<float>::infinity();
+
+        for (int i = 0; i <= kSRGBGuessSteps; i++)
+            guess[i] = encode_reference((float)i / kSRGBGuessSteps);
+    }
+
+    static int encode_reference(float f)
+    {
+        return (unsigned char)(sRGBmap(f) + 0.5);
+    }
+
+    static float bits_to_float(uint32_t bits)
+    {
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // c must already be clamped to [0, 1]
+    cl_uchar encode(float c) const
+    {
+        int code = guess[(int)(c * kSRGBGuessSteps)];
+        while (c >= threshold[code + 1]) code++;
+        return (cl_uchar)code;
+    }
+};
+
+const SRGBTables &get_srgb_tables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+void decode_unorm_srgb(const ImageFormatCodec *codec, const void *src,
+                       size_t pixelCount, float *dst)
+{
+    const SRGBTables &tables = get_srgb_tables();
+    const cl_uchar *p = (const cl_uchar *)src;
+    size_t channelCount = codec->channelCount;
+
+    // Only RGB need to be converted for sRGBA
+    for (size_t i = 0; i < pixelCount; i++, p += channelCount)
+    {
+        dst[0] = tables.decode[p[0]];
+        dst[1] = tables.decode[p[1]];
+        dst[2] = tables.decode[p[2]];
+        if (channelCount == 4) unorm_to_float(p + 3, 1, dst + 3);
+        dst += channelCount;
+    }
+}
+
+void decode_half(const ImageFormatCodec *codec, const void *src,
+                 size_t pixelCount, float *dst)
+{
+    half_to_float_array(dst, (const cl_half *)src,
+                        pixelCount * codec->channelCount);
+}
+
+void decode_float(const ImageFormatCodec *codec, const void *src,
+                  size_t pixelCount, float *dst)
+{
+    memcpy(dst, src, pixelCount * codec->channelCount * sizeof(float));
+}
+
+void decode_unorm_short_565(const ImageFormatCodec *codec, const void *src,
+                            size_t pixelCount, float *dst)
+{
+    const cl_ushort *p = (const cl_ushort *)src;
+    for (size_t i = 0; i < pixelCount; i++, dst += 3)
+    {
+        dst[0] = (float)(p[i] >> 11) / (float)31;
+        dst[1] = (float)((p[i] >> 5) & 63) / (float)63;
+        dst[2] = (float)(p[i] & 31) / (float)31;
+    }
+}
+
+void decode_unorm_short_555(const ImageFormatCodec *codec, const void *src,
+                            size_t pixelCount, float *dst)
+{
+    const cl_ushort *p = (const cl_ushort *)src;
+    for (size_t i = 0; i < pixelCount; i++, dst += 3)
+    {
+        dst[0] = (float)((p[i] >> 10) & 31) / (float)31;
+        dst[1] = (float)((p[i] >> 5) & 31) / (float)31;
+        dst[2] = (float)(p[i] & 31) / (float)31;
+    }
+}
+
+void decode_unorm_int_101010(const ImageFormatCodec *codec, const void *src,
+                             size_t pixelCount, float *dst)
+{
+    const cl_uint *p = (const cl_uint *)src;
+    for (size_t i = 0; i < pixelCount; i++, dst += 3)
+    {
+        dst[0] = (float)((p[i] >> 20) & 0x3ff) / (float)1023;
+        dst[1] = (float)((p[i] >> 10) & 0x3ff) / (float)1023;
+        dst[2] = (float)(p[i] & 0x3ff) / (float)1023;
+    }
+}
+
+void decode_unorm_int_101010_2(const ImageFormatCodec *codec, const void *src,
+                               size_t pixelCount, float *dst)
+{
+    const cl_uint *p = (const cl_uint *)src;
+    for (size_t i = 0; i < pixelCount; i++, dst += 4)
+    {
+        dst[0] = (float)((p[i] >> 22) & 0x3ff) / (float)1023;
+        dst[1] = (float)((p[i] >> 12) & 0x3ff) / (float)1023;
+        dst[2] = (float)(p[i] >> 2 & 0x3ff) / (float)1023;
+        dst[3] = (float)(p[i] >> 0 & 3) / (float)3;
+    }
+}
+
+void decode_unorm_int_2_101010(const ImageFormatCodec *codec, const void *src,
+                               size_t pixelCount, float *dst)
+{
+    const cl_uint *p = (const cl_uint *)src;
+    for (size_t i = 0; i < pixelCount; i++, dst += 4)
+    {
+        dst[0] = (float)((p[i] >> 30) & 0x3) / (float)3;
+        dst[1] = (float)((p[i] >> 20) & 0x3ff) / (float)1023;
+        dst[2] = (float)(p[i] >> 10 & 0x3ff) / (float)1023;
+        dst[3] = (float)(p[i] >> 0 & 0x3ff) / (float)1023;
+    }
+}
+
+#ifdef CL_SFIXED14_APPLE
+void decode_sfixed14(const ImageFormatCodec *codec, const void *src,
+                     size_t pixelCount, float *dst)
+{
+    const cl_ushort *p = (const cl_ushort *)src;
+    size_t n = pixelCount * codec->channelCount;
+    for (size_t i = 0; i < n; i++) dst[i] = ((int)p[i] - 16384) * 0x1.0p-14f;
+}
+#endif
+
+//
+// Encoders. These read four floats per pixel that are already in memory
+// order, as swizzle_vector_for_image leaves them.
+//
+void encode_half(const ImageFormatCodec *codec, const float *src,
+                 size_t pixelCount, void *dst)
+{
+    cl_half_rounding_mode mode = CL_HALF_RTE;
+    switch (gFloatToHalfRoundingMode)
+    {
+        case kRoundToNearestEven: mode = CL_HALF_RTE; break;
+        case kRoundTowardZero: mode = CL_HALF_RTZ; break;
+        default:
+            log_error("ERROR: Test internal error -- unhandled or "
+                      "unknown float->half rounding mode.\n");
+            exit(-1);
+            break;
+    }
+
+    // Gather the channels so they convert in one go
+    size_t channelCount = codec->channelCount;
+    float channels[kCodecChunkPixels * 4];
+    cl_half *ptr = (cl_half *)dst;
+    while (pixelCount)
+    {
+        size_t n = std::min(pixelCount, kCodecChunkPixels);
+        for (size_t i = 0; i < n; i++)
+            for (size_t c = 0; c < channelCount; c++)
+                channels[i * channelCount + c] = src[4 * i + c];
+        float_to_half_array(ptr, channels, n * channelCount, mode);
+        ptr += n * channelCount;
+        src += 4 * n;
+        pixelCount -= n;
+    }
+}
+
+template <typename T>
+void encode_float(const ImageFormatCodec *codec, const float *src,
+                  size_t pixelCount, void *dst)
+{
+    T *ptr = (T *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++) ptr[c] = src[c];
+}
+
+template <typename T>
+void encode_snorm(const ImageFormatCodec *codec, const float *src,
+                  size_t pixelCount, void *dst)
+{
+    const float max = (float)std::numeric_limits<T>::max();
+    T *ptr = (T *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (T)NORMALIZE_SIGNED(src[c], -max, max);
+}
+
+template <typename T>
+void encode_unorm(const ImageFormatCodec *codec, const float *src,
+                  size_t pixelCount, void *dst)
+{
+    const float max = (float)std::numeric_limits<T>::max();
+    T *ptr = (T *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (T)NORMALIZE(src[c], max);
+}
+
+void encode_unorm_int8(const ImageFormatCodec *codec, const float *src,
+                       size_t pixelCount, void *dst)
+{
+    cl_uchar *ptr = (cl_uchar *)dst;
+    size_t channelCount = codec->channelCount;
+
+    if (codec->sRGB)
+    {
+        const SRGBTables &tables = get_srgb_tables();
+        for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        {
+            // Clamp as sRGBmap does, with NaN going to 0
+            float c[4];
+#if defined(IMAGE_CODEC_SSE2)
+            _mm_storeu_ps(c,
+                          _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src),
+                                                _mm_setzero_ps()),
+                                     _mm_set1_ps(1.f)));
+#else
+            for (int k = 0; k < 3; k++)
+                c[k] = src[k] > 0.f ? (src[k] < 1.f ? src[k] : 1.f) : 0.f;
+#endif
+            ptr[0] = tables.encode(c[0]);
+            ptr[1] = tables.encode(c[1]);
+            ptr[2] = tables.encode(c[2]);
+            if (channelCount == 4)
+                ptr[3] = (unsigned char)NORMALIZE(src[3], 255.f);
+        }
+    }
+    else
+    {
+        encode_unorm<cl_uchar>(codec, src, pixelCount, dst);
+    }
+
+#ifdef CL_1RGB_APPLE
+    if (codec->format.image_channel_order == CL_1RGB_APPLE)
+        for (size_t i = 0; i < pixelCount; i++)
+            ((cl_uchar *)dst)[i * channelCount] = 255;
+#endif
+#ifdef CL_BGR1_APPLE
+    if (codec->format.image_channel_order == CL_BGR1_APPLE)
+        for (size_t i = 0; i < pixelCount; i++)
+            ((cl_uchar *)dst)[i * channelCount + 3] = 255;
+#endif
+}
+
+void encode_unorm_short_555(const ImageFormatCodec *codec, const float *src,
+                            size_t pixelCount, void *dst)
+{
+    cl_ushort *ptr = (cl_ushort *)dst;
+    for (size_t i = 0; i < pixelCount; i++, src += 4)
+        ptr[i] = (((unsigned short)NORMALIZE(src[0], 31.f) & 31) << 10)
+            | (((unsigned short)NORMALIZE(src[1], 31.f) & 31) << 5)
+            | (((unsigned short)NORMALIZE(src[2], 31.f) & 31) << 0);
+}
+
+void encode_unorm_short_565(const ImageFormatCodec *codec, const float *src,
+                            size_t pixelCount, void *dst)
+{
+    cl_ushort *ptr = (cl_ushort *)dst;
+    for (size_t i = 0; i < pixelCount; i++, src += 4)
+        ptr[i] = (((unsigned short)NORMALIZE(src[0], 31.f) & 31) << 11)
+            | (((unsigned short)NORMALIZE(src[1], 63.f) & 63) << 5)
+            | (((unsigned short)NORMALIZE(src[2], 31.f) & 31) << 0);
+}
+
+void encode_unorm_int_101010(const ImageFormatCodec *codec, const float *src,
+                             size_t pixelCount, void *dst)
+{
+    cl_uint *ptr = (cl_uint *)dst;
+    for (size_t i = 0; i < pixelCount; i++, src += 4)
+        ptr[i] = (((unsigned int)NORMALIZE(src[0], 1023.f) & 1023) << 20)
+            | (((unsigned int)NORMALIZE(src[1], 1023.f) & 1023) << 10)
+            | (((unsigned int)NORMALIZE(src[2], 1023.f) & 1023) << 0);
+}
+
+void encode_unorm_int_101010_2(const ImageFormatCodec *codec, const float *src,
+                               size_t pixelCount, void *dst)
+{
+    cl_uint *ptr = (cl_uint *)dst;
+    for (size_t i = 0; i < pixelCount; i++, src += 4)
+        ptr[i] = (((unsigned int)NORMALIZE(src[0], 1023.f) & 1023) << 22)
+            | (((unsigned int)NORMALIZE(src[1], 1023.f) & 1023) << 12)
+            | (((unsigned int)NORMALIZE(src[2], 1023.f) & 1023) << 2)
+            | (((unsigned int)NORMALIZE(src[3], 3.f) & 3) << 0);
+}
+
+void encode_unorm_int_2_101010(const ImageFormatCodec *codec, const float *src,
+                               size_t pixelCount, void *dst)
+{
+    cl_uint *ptr = (cl_uint *)dst;
+    for (size_t i = 0; i < pixelCount; i++, src += 4)
+        ptr[i] = (((unsigned int)NORMALIZE(src[0], 3.f) & 3) << 30)
+            | (((unsigned int)NORMALIZE(src[1], 1023.f) & 1023) << 20)
+            | (((unsigned int)NORMALIZE(src[2], 1023.f) & 1023) << 10)
+            | (((unsigned int)NORMALIZE(src[3], 1023.f) & 1023) << 0);
+}
+
+void encode_signed_int8(const ImageFormatCodec *codec, const float *src,
+                        size_t pixelCount, void *dst)
+{
+    cl_char *ptr = (cl_char *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (cl_char)CONVERT_INT(src[c], -127.0f, 127.f, 127);
+}
+
+void encode_signed_int16(const ImageFormatCodec *codec, const float *src,
+                         size_t pixelCount, void *dst)
+{
+    cl_short *ptr = (cl_short *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (short)CONVERT_INT(src[c], -32767.f, 32767.f, 32767);
+}
+
+void encode_signed_int32(const ImageFormatCodec *codec, const float *src,
+                         size_t pixelCount, void *dst)
+{
+    cl_int *ptr = (cl_int *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = round_to_even(src[c]);
+}
+
+void encode_unsigned_int8(const ImageFormatCodec *codec, const float *src,
+                          size_t pixelCount, void *dst)
+{
+    cl_uchar *ptr = (cl_uchar *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (cl_uchar)CONVERT_UINT(src[c], 255.f, CL_UCHAR_MAX);
+}
+
+void encode_unsigned_int16(const ImageFormatCodec *codec, const float *src,
+                           size_t pixelCount, void *dst)
+{
+    cl_ushort *ptr = (cl_ushort *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (cl_ushort)CONVERT_UINT(src[c], 32767.f, CL_USHRT_MAX);
+}
+
+void encode_unsigned_int32(const ImageFormatCodec *codec, const float *src,
+                           size_t pixelCount, void *dst)
+{
+    cl_uint *ptr = (cl_uint *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+        for (size_t c = 0; c < channelCount; c++)
+            ptr[c] = (cl_uint)CONVERT_UINT(
+                src[c], MAKE_HEX_FLOAT(0x1.fffffep31f, 0x1fffffe, 31 - 23),
+                CL_UINT_MAX);
+}
+
+#ifdef CL_SFIXED14_APPLE
+void encode_sfixed14(const ImageFormatCodec *codec, const float *src,
+                     size_t pixelCount, void *dst)
+{
+    cl_ushort *ptr = (cl_ushort *)dst;
+    size_t channelCount = codec->channelCount;
+    for (size_t i = 0; i < pixelCount; i++, src += 4, ptr += channelCount)
+    {
+        for (size_t c = 0; c < channelCount; c++)
+        {
+            cl_float f = fmaxf(src[c], -1.0f);
+            f = fminf(f, 3.0f);
+            cl_int d = rintf(f * 0x1.0p14f);
+            d += 16384;
+            if (d > CL_USHRT_MAX) d = CL_USHRT_MAX;
+            ptr[c] = d;
+        }
+    }
+}
+#endif
+
+void set_swizzle(int *swizzle, int c0, int c1, int c2, int c3)
+{
+    swizzle[0] = c0;
+    swizzle[1] = c1;
+    swizzle[2] = c2;
+    swizzle[3] = c3;
+}
+
+// Mirrors the channel order handling of read_image_pixel_float and
+// swizzle_vector_for_image.
+void set_order_swizzles(ImageFormatCodec *codec)
+{
+    const int Z = IMAGE_CODEC_ZERO, O = IMAGE_CODEC_ONE;
+    int *dec = codec->decodeSwizzle;
+    int *enc = codec->encodeSwizzle;
+
+    codec->validOrder = true;
+    set_swizzle(enc, 0, 1, 2, 3);
+    switch (codec->format.image_channel_order)
+    {
+        case CL_A:
+            set_swizzle(dec, Z, Z, Z, 0);
+            set_swizzle(enc, 3, 1, 2, 3);
+            break;
+        case CL_R:
+        case CL_Rx:
+        case CL_DEPTH: set_swizzle(dec, 0, Z, Z, O); break;
+        case CL_RA:
+            set_swizzle(dec, 0, Z, Z, 1);
+            set_swizzle(enc, 0, 3, 2, 3);
+            break;
+        case CL_RG:
+        case CL_RGx: set_swizzle(dec, 0, 1, Z, O); break;
+        case CL_RGB:
+        case CL_RGBx:
+        case CL_sRGB:
+        case CL_sRGBx: set_swizzle(dec, 0, 1, 2, O); break;
+        case CL_RGBA:
+        case CL_sRGBA: set_swizzle(dec, 0, 1, 2, 3); break;
+        case CL_ARGB:
+            set_swizzle(dec, 1, 2, 3, 0);
+            set_swizzle(enc, 3, 0, 1, 2);
+            break;
+        case CL_ABGR:
+            set_swizzle(dec, 3, 2, 1, 0);
+            set_swizzle(enc, 3, 2, 1, 0);
+            break;
+        case CL_BGRA:
+        case CL_sBGRA:
+            set_swizzle(dec, 2, 1, 0, 3);
+            set_swizzle(enc, 2, 1, 0, 3);
+            break;
+        case CL_INTENSITY:
+            set_swizzle(dec, 0, 0, 0, 0);
+            set_swizzle(enc, 0, 0, 0, 0);
+            break;
+        case CL_LUMINANCE:
+            set_swizzle(dec, 0, 0, 0, O);
+            set_swizzle(enc, 0, 0, 0, 3);
+            break;
+#ifdef CL_1RGB_APPLE
+        case CL_1RGB_APPLE:
+            set_swizzle(dec, 1, 2, 3, O);
+            set_swizzle(enc, 3, 0, 1, 2);
+            break;
+#endif
+#ifdef CL_BGR1_APPLE
+        case CL_BGR1_APPLE:
+            set_swizzle(dec, 2, 1, 0, O);
+            set_swizzle(enc, 2, 1, 0, 3);
+            break;
+#endif
+        default:
+            set_swizzle(dec, Z, Z, Z, O);
+            codec->validOrder = false;
+            break;
+    }
+
+    // Never read channels the decoder did not write
+    for (int k = 0; k < 4; k++)
+        if (dec[k] >= (int)codec->tempChannels) dec[k] = Z;
+}
+
+void set_type_functions(ImageFormatCodec *codec)
+{
+    codec->tempChannels = codec->channelCount;
+    codec->decode = NULL;
+    codec->encode = NULL;
+
+    switch (codec->format.image_channel_data_type)
+    {
+        case CL_SNORM_INT8:
+            codec->decode = decode_snorm<cl_char>;
+            codec->encode = encode_snorm<cl_char>;
+            break;
+        case CL_UNORM_INT8:
+            codec->decode =
+                codec->sRGB ? decode_unorm_srgb : decode_unorm<cl_uchar>;
+            codec->encode = encode_unorm_int8;
+            break;
+        case CL_SIGNED_INT8:
+            codec->decode = decode_integer<cl_char>;
+            codec->encode = encode_signed_int8;
+            break;
+        case CL_UNSIGNED_INT8:
+            codec->decode = decode_integer<cl_uchar>;
+            codec->encode = encode_unsigned_int8;
+            break;
+        case CL_SNORM_INT16:
+            codec->decode = decode_snorm<cl_short>;
+            codec->encode = encode_snorm<cl_short>;
+            break;
+        case CL_UNORM_INT16:
+            codec->decode = decode_unorm<cl_ushort>;
+            codec->encode = encode_unorm<cl_ushort>;
+            break;
+        case CL_SIGNED_INT16:
+            codec->decode = decode_integer<cl_short>;
+            codec->encode = encode_signed_int16;
+            break;
+        case CL_UNSIGNED_INT16:
+            codec->decode = decode_integer<cl_ushort>;
+            codec->encode = encode_unsigned_int16;
+            break;
+        case CL_HALF_FLOAT:
+            codec->decode = decode_half;
+            codec->encode = encode_half;
+            break;
+        case CL_SIGNED_INT32:
+            codec->decode = decode_integer<cl_int>;
+            codec->encode = encode_signed_int32;
+            break;
+        case CL_UNSIGNED_INT32:
+            codec->decode = decode_integer<cl_uint>;
+            codec->encode = encode_unsigned_int32;
+            break;
+        case CL_UNORM_SHORT_565:
+            codec->tempChannels = 3;
+            codec->decode = decode_unorm_short_565;
+            codec->encode = encode_unorm_short_565;
+            break;
+        case CL_UNORM_SHORT_555:
+            codec->tempChannels = 3;
+            codec->decode = decode_unorm_short_555;
+            codec->encode = encode_unorm_short_555;
+            break;
+        case CL_UNORM_INT_101010:
+            codec->tempChannels = 3;
+            codec->decode = decode_unorm_int_101010;
+            codec->encode = encode_unorm_int_101010;
+            break;
+        case CL_UNORM_INT_101010_2:
+            codec->tempChannels = 4;
+            codec->decode = decode_unorm_int_101010_2;
+            codec->encode = encode_unorm_int_101010_2;
+            break;
+        case CL_UNORM_INT_2_101010_EXT:
+            codec->tempChannels = 4;
+            codec->decode = decode_unorm_int_2_101010;
+            codec->encode = encode_unorm_int_2_101010;
+            break;
+        case CL_FLOAT:
+            codec->decode = decode_float;
+            codec->encode = encode_float<cl_float>;
+            break;
+#ifdef CL_SFIXED14_APPLE
+        case CL_SFIXED14_APPLE:
+            codec->decode = decode_sfixed14;
+            codec->encode = encode_sfixed14;
+            break;
+#endif
+        default: break;
+    }
+}
+
+ImageFormatCodec *build_image_format_codec(const cl_image_format *format)
+{
+    ImageFormatCodec *codec = new ImageFormatCodec;
+    codec->format = *format;
+    codec->pixelSize = get_pixel_size(format);
+    codec->channelCount = get_format_channel_count(format);
+    codec->sRGB = is_sRGBA_order(format->image_channel_order);
+    set_type_functions(codec);
+    set_order_swizzles(codec);
+    return codec;
+}
+
+bool same_format(const cl_image_format &a, const cl_image_format *b)
+{
+    return a.image_channel_order == b->image_channel_order
+        && a.image_channel_data_type == b->image_channel_data_type;
+}
+
+} // namespace
+
+const ImageFormatCodec *get_image_format_codec(const cl_image_format *format)
+{
+    typedef std::pair<cl_channel_order, cl_channel_type> FormatKey;
+    static std::mutex codecMutex;
+    static std::map<FormatKey, std::unique_ptr<ImageFormatCodec>> codecs;
+
+    // Callers tend to work on one format at a time, so remember the last one
+    // per thread and only take the lock when the format changes
+    static thread_local const ImageFormatCodec *last = NULL;
+    if (last && same_format(last->format, format)) return last;
+
+    std::lock_guard<std::mutex> lock(codecMutex);
+    std::unique_ptr<ImageFormatCodec> &codec = codecs[FormatKey(
+        format->image_channel_order, format->image_channel_data_type)];
+    if (!codec) codec.reset(build_image_format_codec(format));
+    last = codec.get();
+    return last;
+}
+
+void decode_image_pixels(const ImageFormatCodec *codec, const void *src,
+                         size_t count, float *dst)
+{
+    if (!codec->validOrder)
+    {
+        log_error("Invalid format:");
+        print_header(&codec->format, true);
+    }
+
+    const int *swizzle = codec->decodeSwizzle;
+    const size_t tempChannels = codec->tempChannels;
+    const char *s = (const char *)src;
+    bool identity = tempChannels == 4 && swizzle[0] == 0 && swizzle[1] == 1
+        && swizzle[2] == 2 && swizzle[3] == 3;
+    float temp[kCodecChunkPixels * 4];
+
+    while (count)
+    {
+        size_t n = std::min(count, kCodecChunkPixels);
+        if (identity && codec->decode)
+        {
+            codec->decode(codec, s, n, dst);
+        }
+        else
+        {
+            if (codec->decode)
+                codec->decode(codec, s, n, temp);
+            else
+                memset(temp, 0, sizeof(temp));
+
+            for (size_t i = 0; i < n; i++)
+            {
+                const float *t = temp + i * tempChannels;
+                for (int k = 0; k < 4; k++)
+                    dst[4 * i + k] = swizzle[k] >= 0
+                        ? t[swizzle[k]]
+                        : (swizzle[k] == IMAGE_CODEC_ONE ? 1.0f : 0.0f);
+            }
+        }
+        s += n * codec->pixelSize;
+        dst += 4 * n;
+        count -= n;
+    }
+}
+
+void encode_image_pixels(const ImageFormatCodec *codec, const float *src,
+                         size_t count, void *dst)
+{
+    if (!codec->encode)
+    {
+        log_error("INTERNAL ERROR: unknown format (%d)\n",
+                  codec->format.image_channel_data_type);
+        exit(-1);
+    }
+
+    const int *swizzle = codec->encodeSwizzle;
+    char *d = (char *)dst;
+    float temp[kCodecChunkPixels * 4];
+
+    while (count)
+    {
+        size_t n = std::min(count, kCodecChunkPixels);
+        for (size_t i = 0; i < n; i++)
+            for (int k = 0; k < 4; k++)
+                temp[4 * i + k] = src[4 * i + swizzle[k]];
+        codec->encode(codec, temp, n, d);
+        src += 4 * n;
+        d += n * codec->pixelSize;
+        count -= n;
+    }
+}
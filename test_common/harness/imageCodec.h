@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _imageCodec_h
+#define _imageCodec_h
+
+#include "compat.h"
+
+#include <stddef.h>
+
+#include <CL/opencl.h>
+
+struct ImageFormatCodec;
+
+// Converts pixelCount pixels between the memory layout of a format and its
+// channels in memory order, as floats with a stride of four per pixel for
+// encoding and of tempChannels per pixel for decoding.
+typedef void (*ImageChannelDecodeFn)(const ImageFormatCodec *codec,
+                                     const void *src, size_t pixelCount,
+                                     float *dst);
+typedef void (*ImageChannelEncodeFn)(const ImageFormatCodec *codec,
+                                     const float *src, size_t pixelCount,
+                                     void *dst);
+
+// Swizzle entries that are not channel indices
+#define IMAGE_CODEC_ZERO -1
+#define IMAGE_CODEC_ONE -2
+
+// Everything needed to convert whole runs of pixels of one image format to
+// and from RGBA floats. Codecs are built once for every format the harness
+// knows about, so looking one up does not switch on the channel order and
+// data type.
+struct ImageFormatCodec
+{
+    cl_image_format format;
+    size_t pixelSize;
+    // Channels stored per pixel, and channels produced per pixel by decode
+    size_t channelCount;
+    size_t tempChannels;
+    bool sRGB;
+    // RGBA output component k is decoded channel decodeSwizzle[k], or one of
+    // the IMAGE_CODEC_ZERO / IMAGE_CODEC_ONE constants. Memory channel k is
+    // encoded from RGBA component encodeSwizzle[k].
+    int decodeSwizzle[4];
+    int encodeSwizzle[4];
+    // False for channel orders the float conversions do not know about
+    bool validOrder;
+    // NULL for data types that cannot be read or written as floats
+    ImageChannelDecodeFn decode;
+    ImageChannelEncodeFn encode;
+};
+
+// Returns the codec for format. Unknown formats get a codec with NULL
+// functions; the result is never NULL and lives until the program exits.
+const ImageFormatCodec *get_image_format_codec(const cl_image_format *format);
+
+// Decodes count consecutive pixels into RGBA floats, four per pixel, with
+// the same results as read_image_pixel_float.
+void decode_image_pixels(const ImageFormatCodec *codec, const void *src,
+                         size_t count, float *dst);
+
+// Encodes count RGBA float pixels, four floats each, with the same results as
+// pack_image_pixel. The source is not modified.
+void encode_image_pixels(const ImageFormatCodec *codec, const float *src,
+                         size_t count, void *dst);
+
+#endif // _imageCodec_h
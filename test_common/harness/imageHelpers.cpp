@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "imageHelpers.h"
+#include "randomPool.h"
 #include <limits.h>
 #include <assert.h>
 #if defined(__APPLE__)
@@ -28,6 +29,11 @@
 #if !defined(_WIN32)
 #include <cmath>
 #endif
+#if defined(__SSE2__) || defined(_M_X64)                                       \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_HELPERS_SSE2 1
+#include <emmintrin.h>
+#endif
 
 RoundingMode gFloatToHalfRoundingMode = kDefaultRoundingMode;
 
@@ -462,71 +468,189 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
     }
 }
 
-size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
-                         const char *bPtr)
+// How the bits of a format are compared: in elements of elementSize bytes,
+// after masking off undefined bits, and for the SNORM types after folding
+// the two encodings of -1.0 into one.
+struct PixelCompareRule
 {
-    size_t pixel_size = get_pixel_size(imageInfo->format);
-    size_t column;
+    size_t elementSize;
+    cl_uint mask;
+    bool snorm;
+};
+
+static PixelCompareRule get_pixel_compare_rule(const cl_image_format *format)
+{
+    switch (format->image_channel_data_type)
+    {
+        // If the data type is 101010, then ignore bits 31 and 32
+        case CL_UNORM_INT_101010: return { 4, 0x3fffffff, false };
+        // If the data type is 555, ignore bit 15
+        case CL_UNORM_SHORT_555: return { 2, 0x7fff, false };
+        // -1.0 is defined as 0x80 and 0x81
+        case CL_SNORM_INT8: return { 1, 0xff, true };
+        // -1.0 is defined as 0x8000 and 0x8001
+        case CL_SNORM_INT16: return { 2, 0xffff, true };
+        default: return { 1, 0xff, false };
+    }
+}
 
-    for (column = 0; column < imageInfo->width; column++)
+// Returns the offset of the first element of type T in [offset, size) that
+// differs between a and b under rule, or size if there is none
+template <typename T>
+static size_t find_first_difference_scalar(const char *a, const char *b,
+                                           size_t offset, size_t size,
+                                           const PixelCompareRule &rule)
+{
+    const T mask = (T)rule.mask;
+    const T signBit = (T)((rule.mask >> 1) + 1);
+    for (; offset < size; offset += sizeof(T))
     {
-        switch (imageInfo->format->image_channel_data_type)
+        T aValue, bValue;
+        memcpy(&aValue, a + offset, sizeof(T));
+        memcpy(&bValue, b + offset, sizeof(T));
+        aValue &= mask;
+        bValue &= mask;
+        if (rule.snorm)
         {
-            // If the data type is 101010, then ignore bits 31 and 32 when
-            // comparing the row
-            case CL_UNORM_INT_101010: {
-                cl_uint aPixel = *(cl_uint *)aPtr;
-                cl_uint bPixel = *(cl_uint *)bPtr;
-                if ((aPixel & 0x3fffffff) != (bPixel & 0x3fffffff))
-                    return column;
-            }
-            break;
+            if (aValue == signBit) aValue++;
+            if (bValue == signBit) bValue++;
+        }
+        if (aValue != bValue) return offset;
+    }
+    return size;
+}
 
-            // If the data type is 555, ignore bit 15 when comparing the row
-            case CL_UNORM_SHORT_555: {
-                cl_ushort aPixel = *(cl_ushort *)aPtr;
-                cl_ushort bPixel = *(cl_ushort *)bPtr;
-                if ((aPixel & 0x7fff) != (bPixel & 0x7fff)) return column;
+// Returns the offset of the first element in [0, size) that differs between
+// a and b under rule, or size if there is none
+static size_t find_first_difference(const char *a, const char *b, size_t size,
+                                    const PixelCompareRule &rule)
+{
+    size_t offset = 0;
+#if defined(IMAGE_HELPERS_SSE2)
+    const __m128i mask = rule.elementSize == 4
+        ? _mm_set1_epi32((int)rule.mask)
+        : _mm_set1_epi16((short)(rule.elementSize == 2 ? rule.mask : 0xffff));
+    const __m128i signBit = rule.elementSize == 1
+        ? _mm_set1_epi8((char)0x80)
+        : _mm_set1_epi16((short)0x8000);
+    for (; offset + 16 <= size; offset += 16)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + offset));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + offset));
+        va = _mm_and_si128(va, mask);
+        vb = _mm_and_si128(vb, mask);
+        if (rule.snorm)
+        {
+            // Adding the all ones comparison result turns -1.0 encoded as
+            // the sign bit alone into the other encoding
+            if (rule.elementSize == 1)
+            {
+                va = _mm_sub_epi8(va, _mm_cmpeq_epi8(va, signBit));
+                vb = _mm_sub_epi8(vb, _mm_cmpeq_epi8(vb, signBit));
             }
-            break;
-
-            case CL_SNORM_INT8: {
-                cl_uchar aPixel = *(cl_uchar *)aPtr;
-                cl_uchar bPixel = *(cl_uchar *)bPtr;
-                // -1.0 is defined as 0x80 and 0x81
-                aPixel = (aPixel == 0x80) ? 0x81 : aPixel;
-                bPixel = (bPixel == 0x80) ? 0x81 : bPixel;
-                if (aPixel != bPixel)
-                {
-                    return column;
-                }
+            else
+            {
+                va = _mm_sub_epi16(va, _mm_cmpeq_epi16(va, signBit));
+                vb = _mm_sub_epi16(vb, _mm_cmpeq_epi16(vb, signBit));
             }
-            break;
-
-            case CL_SNORM_INT16: {
-                cl_ushort aPixel = *(cl_ushort *)aPtr;
-                cl_ushort bPixel = *(cl_ushort *)bPtr;
-                // -1.0 is defined as 0x8000 and 0x8001
-                aPixel = (aPixel == 0x8000) ? 0x8001 : aPixel;
-                bPixel = (bPixel == 0x8000) ? 0x8001 : bPixel;
-                if (aPixel != bPixel)
-                {
-                    return column;
-                }
+        }
+        int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (equal != 0xffff)
+        {
+            size_t byte = 0;
+            while (equal & (1 << byte)) byte++;
+            return offset + byte - byte % rule.elementSize;
+        }
+    }
+#endif
+    switch (rule.elementSize)
+    {
+        case 1:
+            if (!rule.snorm)
+            {
+                // Plain bytes, so let memcmp skip over matching runs
+                while (offset + 64 <= size
+                       && memcmp(a + offset, b + offset, 64) == 0)
+                    offset += 64;
             }
-            break;
+            return find_first_difference_scalar<cl_uchar>(a, b, offset, size,
+                                                          rule);
+        case 2:
+            return find_first_difference_scalar<cl_ushort>(a, b, offset, size,
+                                                           rule);
+        default:
+            return find_first_difference_scalar<cl_uint>(a, b, offset, size,
+                                                         rule);
+    }
+}
 
-            default:
-                if (memcmp(aPtr, bPtr, pixel_size) != 0) return column;
-                break;
+// Whether expected and actual differ only in ways allowed for stored floats:
+// any NaN for a NaN, zero for a denormal, and for CL_FLOAT zeros of either
+// sign
+static bool float_pixel_within_tolerance(const cl_image_format *format,
+                                         const char *expected,
+                                         const char *actual)
+{
+    size_t channelCount = get_format_channel_count(format);
+    if (format->image_channel_data_type == CL_FLOAT)
+    {
+        for (size_t j = 0; j < channelCount; j++)
+        {
+            float e, a;
+            memcpy(&e, expected + j * sizeof(float), sizeof(float));
+            memcpy(&a, actual + j * sizeof(float), sizeof(float));
+            if (isnan(e) && isnan(a)) continue;
+            if (IsFloatSubnormal(e) && a == 0.0f) continue;
+            if (e != a) return false;
+        }
+        return true;
+    }
+    if (format->image_channel_data_type == CL_HALF_FLOAT)
+    {
+        for (size_t j = 0; j < channelCount; j++)
+        {
+            cl_half e, a;
+            memcpy(&e, expected + j * sizeof(cl_half), sizeof(cl_half));
+            memcpy(&a, actual + j * sizeof(cl_half), sizeof(cl_half));
+            if (is_half_nan(e) && is_half_nan(a)) continue;
+            if (is_half_denorm(e) && is_half_zero(a)) continue;
+            if (e != a) return false;
         }
+        return true;
+    }
+    return false;
+}
 
-        aPtr += pixel_size;
-        bPtr += pixel_size;
+size_t compare_pixels(const cl_image_format *format, const char *expected,
+                      const char *actual, size_t count, PixelCompareMode mode)
+{
+    size_t pixelSize = get_pixel_size(format);
+    size_t size = count * pixelSize;
+    PixelCompareRule rule = get_pixel_compare_rule(format);
+
+    size_t offset = 0;
+    while (offset < size)
+    {
+        offset += find_first_difference(expected + offset, actual + offset,
+                                        size - offset, rule);
+        if (offset == size) break;
+
+        size_t pixel = offset / pixelSize;
+        if (mode != kPixelCompareFloatTolerant
+            || !float_pixel_within_tolerance(format,
+                                             expected + pixel * pixelSize,
+                                             actual + pixel * pixelSize))
+            return pixel;
+        offset = (pixel + 1) * pixelSize;
     }
+    return count;
+}
 
-    // If we didn't find a difference, return the width of the image
-    return column;
+size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
+                         const char *bPtr, PixelCompareMode mode)
+{
+    return compare_pixels(imageInfo->format, aPtr, bPtr, imageInfo->width,
+                          mode);
 }
 
 int random_log_in_range(int minV, int maxV, MTdata d)
@@ -796,7 +920,10 @@ void get_max_sizes(
     size_t other_sizes[] = { 2, 3, 5, 6, 7, 9, 11, 13 };
 #endif
 
-    static size_t other_size = 0;
+    // Local rather than carried over between calls, so that concurrent
+    // callers do not race on it and a call's sizes do not depend on the
+    // calls made before it
+    size_t other_size = 0;
     enum
     {
         num_other_sizes = sizeof(other_sizes) / sizeof(size_t)
@@ -1188,6 +1315,24 @@ void escape_inf_nan_subnormal_values(char *data, size_t allocSize)
     }
 }
 
+static void generate_image_data_pool(char *data, size_t size, MTdata d)
+{
+    for (size_t i = 0; i + 4 <= size; i += 4)
+    {
+        cl_uint r = genrand_int32(d);
+        memcpy(data + i, &r, sizeof(r));
+    }
+    escape_inf_nan_subnormal_values(data, size);
+}
+
+// Random image contents are copied out of this rather than drawn pixel by
+// pixel for every image
+static const RandomPool &get_image_data_pool()
+{
+    static const RandomPool pool(16 * 1024 * 1024, generate_image_data_pool);
+    return pool;
+}
+
 char *generate_random_image_data(image_descriptor *imageInfo,
                                  BufferOwningPtr<char> &P, MTdata d)
 {
@@ -1267,15 +1412,11 @@ char *generate_random_image_data(image_descriptor *imageInfo,
         return data;
     }
 
-    // Otherwise, we should be able to just fill with random bits no matter what
-    cl_uint *p = (cl_uint *)data;
-    for (i = 0; i + 4 <= allocSize; i += 4) p[i / 4] = genrand_int32(d);
-
-    for (; i < allocSize; i++) data[i] = genrand_int32(d);
-
-    // Note: inf or nan float values would cause problems, although we don't
-    // know this will actually be a float, so we just know what to look for
-    escape_inf_nan_subnormal_values(data, allocSize);
+    // Otherwise, we should be able to just fill with random bits no matter
+    // what. The pool has already been through
+    // escape_inf_nan_subnormal_values, since inf or nan float values would
+    // cause problems.
+    get_image_data_pool().Fill(data, allocSize, d);
 
     if (/*!gTestMipmaps*/ imageInfo->num_mip_levels < 2)
     {
@@ -1340,292 +1481,89 @@ char *generate_random_image_data(image_descriptor *imageInfo,
     return data;
 }
 
-#define CLAMP_FLOAT(v) (fmaxf(fminf(v, 1.f), -1.f))
+// Extent and pitches of one mip level, as read_image_pixel_float uses them
+struct ImageLodLayout
+{
+    size_t width, height, depth;
+    size_t rowPitch, slicePitch;
+};
 
+static const image_mip_pyramid &
+get_cached_mip_pyramid(const image_descriptor *imageInfo);
 
-void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
-                            int y, int z, float *outData, int lod)
+static void get_image_lod_layout(const image_descriptor *imageInfo, int lod,
+                                 ImageLodLayout *layout)
 {
-    size_t width_lod = imageInfo->width, height_lod = imageInfo->height,
-           depth_lod = imageInfo->depth;
-    size_t slice_pitch_lod = 0, row_pitch_lod = 0;
-
+    const image_descriptor *levelInfo = imageInfo;
     if (imageInfo->num_mip_levels > 1)
-    {
-        switch (imageInfo->type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                depth_lod =
-                    (imageInfo->depth >> lod) ? (imageInfo->depth >> lod) : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                height_lod =
-                    (imageInfo->height >> lod) ? (imageInfo->height >> lod) : 1;
-            default:
-                width_lod =
-                    (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
-        }
-        row_pitch_lod = width_lod * get_pixel_size(imageInfo->format);
-        if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
-            slice_pitch_lod = row_pitch_lod;
-        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D
-                 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
-            slice_pitch_lod = row_pitch_lod * height_lod;
-    }
-    else
-    {
-        row_pitch_lod = imageInfo->rowPitch;
-        slice_pitch_lod = imageInfo->slicePitch;
-    }
-    if (x < 0 || y < 0 || z < 0 || x >= (int)width_lod
-        || (height_lod != 0 && y >= (int)height_lod)
-        || (depth_lod != 0 && z >= (int)depth_lod)
-        || (imageInfo->arraySize != 0 && z >= (int)imageInfo->arraySize))
-    {
-        outData[0] = outData[1] = outData[2] = outData[3] = 0;
-        if (!has_alpha(imageInfo->format)) outData[3] = 1;
-        return;
-    }
+        levelInfo = &get_cached_mip_pyramid(imageInfo).levels[lod].info;
 
-    const cl_image_format *format = imageInfo->format;
+    layout->width = levelInfo->width;
+    layout->height = levelInfo->height;
+    layout->depth = levelInfo->depth;
+    layout->rowPitch = levelInfo->rowPitch;
+    layout->slicePitch = levelInfo->slicePitch;
+}
 
-    unsigned int i;
-    float tempData[4];
+static void get_float_border_color(const image_descriptor *imageInfo,
+                                   float *outData)
+{
+    outData[0] = outData[1] = outData[2] = outData[3] = 0;
+    if (!has_alpha(imageInfo->format)) outData[3] = 1;
+}
 
-    // Advance to the right spot
-    char *ptr = (char *)imageData;
-    size_t pixelSize = get_pixel_size(format);
+void read_image_row_float(void *imageData, image_descriptor *imageInfo, int x,
+                          int y, int z, size_t count, float *outData, int lod)
+{
+    ImageLodLayout layout;
+    get_image_lod_layout(imageInfo, lod, &layout);
 
-    ptr += z * slice_pitch_lod + y * row_pitch_lod + x * pixelSize;
+    float border[4];
+    get_float_border_color(imageInfo, border);
 
-    // OpenCL only supports reading floats from certain formats
-    size_t channelCount = get_format_channel_count(format);
-    switch (format->image_channel_data_type)
+    // Pixels of the row that lie inside the image, [first, last)
+    long long first = 0, last = 0;
+    if (y >= 0 && z >= 0 && (layout.height == 0 || y < (int)layout.height)
+        && (layout.depth == 0 || z < (int)layout.depth)
+        && (imageInfo->arraySize == 0 || z < (int)imageInfo->arraySize))
     {
-        case CL_SNORM_INT8: {
-            cl_char *dPtr = (cl_char *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = CLAMP_FLOAT((float)dPtr[i] / 127.0f);
-            break;
-        }
-
-        case CL_UNORM_INT8: {
-            unsigned char *dPtr = (unsigned char *)ptr;
-            for (i = 0; i < channelCount; i++)
-            {
-                if ((is_sRGBA_order(imageInfo->format->image_channel_order))
-                    && i < 3) // only RGB need to be converted for sRGBA
-                    tempData[i] = (float)sRGBunmap((float)dPtr[i] / 255.0f);
-                else
-                    tempData[i] = (float)dPtr[i] / 255.0f;
-            }
-            break;
-        }
-
-        case CL_SIGNED_INT8: {
-            cl_char *dPtr = (cl_char *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_UNSIGNED_INT8: {
-            cl_uchar *dPtr = (cl_uchar *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_SNORM_INT16: {
-            cl_short *dPtr = (cl_short *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = CLAMP_FLOAT((float)dPtr[i] / 32767.0f);
-            break;
-        }
-
-        case CL_UNORM_INT16: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = (float)dPtr[i] / 65535.0f;
-            break;
-        }
-
-        case CL_SIGNED_INT16: {
-            cl_short *dPtr = (cl_short *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_UNSIGNED_INT16: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_HALF_FLOAT: {
-            cl_half *dPtr = (cl_half *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = cl_half_to_float(dPtr[i]);
-            break;
-        }
-
-        case CL_SIGNED_INT32: {
-            cl_int *dPtr = (cl_int *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_UNSIGNED_INT32: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_UNORM_SHORT_565: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            tempData[0] = (float)(dPtr[0] >> 11) / (float)31;
-            tempData[1] = (float)((dPtr[0] >> 5) & 63) / (float)63;
-            tempData[2] = (float)(dPtr[0] & 31) / (float)31;
-            break;
-        }
-
-        case CL_UNORM_SHORT_555: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 10) & 31) / (float)31;
-            tempData[1] = (float)((dPtr[0] >> 5) & 31) / (float)31;
-            tempData[2] = (float)(dPtr[0] & 31) / (float)31;
-            break;
-        }
-
-        case CL_UNORM_INT_101010: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 20) & 0x3ff) / (float)1023;
-            tempData[1] = (float)((dPtr[0] >> 10) & 0x3ff) / (float)1023;
-            tempData[2] = (float)(dPtr[0] & 0x3ff) / (float)1023;
-            break;
-        }
-
-        case CL_UNORM_INT_101010_2: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 22) & 0x3ff) / (float)1023;
-            tempData[1] = (float)((dPtr[0] >> 12) & 0x3ff) / (float)1023;
-            tempData[2] = (float)(dPtr[0] >> 2 & 0x3ff) / (float)1023;
-            tempData[3] = (float)(dPtr[0] >> 0 & 3) / (float)3;
-            break;
-        }
-
-        case CL_UNORM_INT_2_101010_EXT: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 30) & 0x3) / (float)3;
-            tempData[1] = (float)((dPtr[0] >> 20) & 0x3ff) / (float)1023;
-            tempData[2] = (float)(dPtr[0] >> 10 & 0x3ff) / (float)1023;
-            tempData[3] = (float)(dPtr[0] >> 0 & 0x3ff) / (float)1023;
-            break;
-        }
-
-        case CL_FLOAT: {
-            float *dPtr = (float *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-#ifdef CL_SFIXED14_APPLE
-        case CL_SFIXED14_APPLE: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = ((int)dPtr[i] - 16384) * 0x1.0p-14f;
-            break;
-        }
-#endif
+        first = std::min(std::max(-(long long)x, 0LL), (long long)count);
+        last = std::max(
+            std::min((long long)layout.width - x, (long long)count), first);
     }
 
+    for (long long i = 0; i < first; i++) memcpy(outData + 4 * i, border, 16);
+    for (long long i = last; i < (long long)count; i++)
+        memcpy(outData + 4 * i, border, 16);
+    if (first == last) return;
 
-    outData[0] = outData[1] = outData[2] = 0;
-    outData[3] = 1;
+    const ImageFormatCodec *codec = get_image_format_codec(imageInfo->format);
+    char *ptr = (char *)imageData + z * layout.slicePitch + y * layout.rowPitch
+        + (x + first) * codec->pixelSize;
+    decode_image_pixels(codec, ptr, (size_t)(last - first),
+                        outData + 4 * first);
+}
 
-    switch (format->image_channel_order)
+void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
+                            int y, int z, float *outData, int lod)
+{
+    ImageLodLayout layout;
+    get_image_lod_layout(imageInfo, lod, &layout);
+
+    if (x < 0 || y < 0 || z < 0 || x >= (int)layout.width
+        || (layout.height != 0 && y >= (int)layout.height)
+        || (layout.depth != 0 && z >= (int)layout.depth)
+        || (imageInfo->arraySize != 0 && z >= (int)imageInfo->arraySize))
     {
-        case CL_A: outData[3] = tempData[0]; break;
-        case CL_R:
-        case CL_Rx: outData[0] = tempData[0]; break;
-        case CL_RA:
-            outData[0] = tempData[0];
-            outData[3] = tempData[1];
-            break;
-        case CL_RG:
-        case CL_RGx:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            break;
-        case CL_RGB:
-        case CL_RGBx:
-        case CL_sRGB:
-        case CL_sRGBx:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            outData[2] = tempData[2];
-            break;
-        case CL_RGBA:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            outData[2] = tempData[2];
-            outData[3] = tempData[3];
-            break;
-        case CL_ARGB:
-            outData[0] = tempData[1];
-            outData[1] = tempData[2];
-            outData[2] = tempData[3];
-            outData[3] = tempData[0];
-            break;
-        case CL_ABGR:
-            outData[0] = tempData[3];
-            outData[1] = tempData[2];
-            outData[2] = tempData[1];
-            outData[3] = tempData[0];
-            break;
-        case CL_BGRA:
-        case CL_sBGRA:
-            outData[0] = tempData[2];
-            outData[1] = tempData[1];
-            outData[2] = tempData[0];
-            outData[3] = tempData[3];
-            break;
-        case CL_INTENSITY:
-            outData[0] = tempData[0];
-            outData[1] = tempData[0];
-            outData[2] = tempData[0];
-            outData[3] = tempData[0];
-            break;
-        case CL_LUMINANCE:
-            outData[0] = tempData[0];
-            outData[1] = tempData[0];
-            outData[2] = tempData[0];
-            break;
-#ifdef CL_1RGB_APPLE
-        case CL_1RGB_APPLE:
-            outData[0] = tempData[1];
-            outData[1] = tempData[2];
-            outData[2] = tempData[3];
-            outData[3] = 1.0f;
-            break;
-#endif
-#ifdef CL_BGR1_APPLE
-        case CL_BGR1_APPLE:
-            outData[0] = tempData[2];
-            outData[1] = tempData[1];
-            outData[2] = tempData[0];
-            outData[3] = 1.0f;
-            break;
-#endif
-        case CL_sRGBA:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            outData[2] = tempData[2];
-            outData[3] = tempData[3];
-            break;
-        case CL_DEPTH: outData[0] = tempData[0]; break;
-        default:
-            log_error("Invalid format:");
-            print_header(format, true);
-            break;
+        get_float_border_color(imageInfo, outData);
+        return;
     }
+
+    // OpenCL only supports reading floats from certain formats
+    const ImageFormatCodec *codec = get_image_format_codec(imageInfo->format);
+    char *ptr = (char *)imageData + z * layout.slicePitch + y * layout.rowPitch
+        + x * codec->pixelSize;
+    decode_image_pixels(codec, ptr, 1, outData);
 }
 
 void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
@@ -2371,21 +2309,456 @@ FloatPixel sample_image_pixel_float_offset(
         zAddressOffset, imageSampler, outData, verbose, containsDenorms, 0);
 }
 
+//
+// Batched sampling
+//
 
-int debug_find_vector_in_image(void *imagePtr, image_descriptor *imageInfo,
-                               void *vectorToFind, size_t vectorSize, int *outX,
-                               int *outY, int *outZ, size_t lod)
-{
-    int foundCount = 0;
-    char *iPtr = (char *)imagePtr;
-    size_t width;
-    size_t depth;
-    size_t height;
-    size_t row_pitch;
-    size_t slice_pitch;
+// Coordinates handled per step of sample_image_pixels_float_offset
+static const size_t kSampleBatchSize = 64;
 
-    switch (imageInfo->type)
-    {
+// What sampling one image needs, worked out once per batch
+typedef struct
+{
+    image_descriptor *imageInfo;
+    const ImageFormatCodec *codec;
+    ImageLodLayout layout;
+    AddressFn adFn;
+    float border[4];
+} SampleBatchState;
+
+// Same as read_image_pixel_float, without recomputing the layout
+static inline void fetch_texel(const SampleBatchState &state, const char *base,
+                               int x, int y, int z, float *outData)
+{
+    const ImageLodLayout &layout = state.layout;
+    if (x < 0 || y < 0 || z < 0 || x >= (int)layout.width
+        || (layout.height != 0 && y >= (int)layout.height)
+        || (layout.depth != 0 && z >= (int)layout.depth)
+        || (state.imageInfo->arraySize != 0
+            && z >= (int)state.imageInfo->arraySize))
+    {
+        memcpy(outData, state.border, sizeof(state.border));
+        return;
+    }
+
+    const char *ptr = base + z * layout.slicePitch + y * layout.rowPitch
+        + x * state.codec->pixelSize;
+    decode_image_pixels(state.codec, ptr, 1, outData);
+}
+
+// Reads a texel and applies check_for_denorms to it
+static inline void fetch_filter_texel(const SampleBatchState &state,
+                                      const char *base, int x, int y, int z,
+                                      float *outData, int *containsDenorms)
+{
+    fetch_texel(state, base, x, y, z, outData);
+    check_for_denorms(outData, containsDenorms);
+}
+
+#if defined(IMAGE_HELPERS_SSE2)
+// floorf for four lanes. Lanes that are already integers, zeros or NaNs are
+// passed through, so the result matches floorf bit for bit.
+static inline __m128 floor_ps(__m128 v)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 absV = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    __m128 keep = _mm_or_ps(_mm_cmpnlt_ps(absV, _mm_set1_ps(0x1.0p23f)),
+                            _mm_cmpeq_ps(v, _mm_setzero_ps()));
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), one));
+    return _mm_or_ps(_mm_and_ps(keep, v), _mm_andnot_ps(keep, t));
+}
+#endif
+
+// Unnormalizes count coordinates the way unnormalize_coordinate does
+static void unnormalize_coordinates(float *coords, size_t count, float offset,
+                                    float extent,
+                                    cl_addressing_mode addressing_mode)
+{
+    if (addressing_mode == CL_ADDRESS_REPEAT
+        || addressing_mode == CL_ADDRESS_MIRRORED_REPEAT)
+    {
+        for (size_t i = 0; i < count; i++)
+            coords[i] = unnormalize_coordinate("", coords[i], offset, extent,
+                                               addressing_mode, 0);
+        return;
+    }
+
+    size_t i = 0;
+#if defined(IMAGE_HELPERS_SSE2)
+    const __m128 vExtent = _mm_set1_ps(extent), vOffset = _mm_set1_ps(offset);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(coords + i), vExtent);
+        _mm_storeu_ps(coords + i, _mm_add_ps(v, vOffset));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float ret = coords[i] * extent;
+        ret += offset;
+        coords[i] = ret;
+    }
+}
+
+// Integer coordinates for nearest filtering, before addressing
+static void floor_coordinates(const float *coords, size_t count, int *out)
+{
+    size_t i = 0;
+#if defined(IMAGE_HELPERS_SSE2)
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i *)(out + i),
+                         _mm_cvttps_epi32(floor_ps(_mm_loadu_ps(coords + i))));
+#endif
+    for (; i < count; i++) out[i] = static_cast<int>(floorf(coords[i]));
+}
+
+// The two texel coordinates either side of each coordinate, before
+// addressing, and the fractional weight of the upper one
+static void split_linear_coordinates(const float *coords, size_t count,
+                                     int *lower, int *upper, float *fracs)
+{
+    size_t i = 0;
+#if defined(IMAGE_HELPERS_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f), one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_sub_ps(_mm_loadu_ps(coords + i), half);
+        __m128 f = floor_ps(v);
+        _mm_storeu_si128((__m128i *)(lower + i), _mm_cvttps_epi32(f));
+        _mm_storeu_si128((__m128i *)(upper + i),
+                         _mm_cvttps_epi32(_mm_add_ps(f, one)));
+        _mm_storeu_ps(fracs + i, _mm_sub_ps(v, f));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float f = floorf(coords[i] - 0.5f);
+        lower[i] = static_cast<int>(f);
+        upper[i] = static_cast<int>(f + 1);
+        fracs[i] = frac(coords[i] - 0.5f);
+    }
+}
+
+// pixelMax(a, b) into result, which may alias a or b
+static inline void texel_max(const float *a, const float *b, float *result)
+{
+#if defined(IMAGE_HELPERS_SSE2)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 x = _mm_andnot_ps(signMask, _mm_loadu_ps(a));
+    __m128 y = _mm_andnot_ps(signMask, _mm_loadu_ps(b));
+    // errMax keeps a NaN in x, where maxps would return y
+    __m128 xNaN = _mm_cmpunord_ps(x, x);
+    __m128 m = _mm_max_ps(x, y);
+    _mm_storeu_ps(result,
+                  _mm_or_ps(_mm_and_ps(xNaN, x), _mm_andnot_ps(xNaN, m)));
+#else
+    pixelMax(a, b, result);
+#endif
+}
+
+// Weighted sum of texels, accumulated in double in texel order as the
+// unbatched filter does
+static inline void blend_texels(const float (*texels)[4], const double *weights,
+                                int texelCount, bool flushDenorms,
+                                float *outData)
+{
+#if defined(IMAGE_HELPERS_SSE2)
+    __m128 t = _mm_loadu_ps(texels[0]);
+    __m128d w = _mm_set1_pd(weights[0]);
+    __m128d lo = _mm_mul_pd(_mm_cvtps_pd(t), w);
+    __m128d hi = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(t, t)), w);
+    for (int k = 1; k < texelCount; k++)
+    {
+        t = _mm_loadu_ps(texels[k]);
+        w = _mm_set1_pd(weights[k]);
+        lo = _mm_add_pd(lo, _mm_mul_pd(_mm_cvtps_pd(t), w));
+        hi = _mm_add_pd(hi, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(t, t)), w));
+    }
+    _mm_storeu_ps(outData, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+#else
+    for (int i = 0; i < 4; i++)
+    {
+        double sum = texels[0][i] * weights[0];
+        for (int k = 1; k < texelCount; k++) sum += texels[k][i] * weights[k];
+        outData[i] = (float)sum;
+    }
+#endif
+
+    // flush subnormal results to zero if necessary
+    if (flushDenorms)
+        for (int i = 0; i < 4; i++)
+            if (fabs(outData[i]) < FLT_MIN)
+                outData[i] = copysignf(0.0f, outData[i]);
+}
+
+static void sample_nearest_batch(const SampleBatchState &state, void *imageData,
+                                 const float *x, const float *y,
+                                 const float *z, size_t count, float *outData,
+                                 FloatPixel *maxPixels, int *containsDenorms)
+{
+    image_descriptor *imageInfo = state.imageInfo;
+    const ImageLodLayout &layout = state.layout;
+    AddressFn adFn = state.adFn;
+    int ix[kSampleBatchSize], iy[kSampleBatchSize], iz[kSampleBatchSize];
+
+    floor_coordinates(x, count, ix);
+    floor_coordinates(y, count, iy);
+    floor_coordinates(z, count, iz);
+
+    float lastIndex = (float)(imageInfo->arraySize - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        ix[i] = adFn(ix[i], layout.width);
+        switch (imageInfo->type)
+        {
+            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+                iy[i] =
+                    static_cast<int>(calculate_array_index(y[i], lastIndex));
+                iz[i] = 0;
+                break;
+            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+                iy[i] = adFn(iy[i], layout.height);
+                iz[i] =
+                    static_cast<int>(calculate_array_index(z[i], lastIndex));
+                break;
+            default:
+                iy[i] = adFn(iy[i], layout.height);
+                iz[i] = layout.depth != 0 ? adFn(iz[i], layout.depth) : 0;
+        }
+
+        float *out = outData + 4 * i;
+        fetch_filter_texel(state, (const char *)imageData, ix[i], iy[i], iz[i],
+                           out, containsDenorms ? containsDenorms + i : NULL);
+        if (maxPixels)
+            for (int c = 0; c < 4; c++) maxPixels[i].p[c] = fabsf(out[c]);
+    }
+}
+
+// Linear filtering of 1D and 2D images and of 1D and 2D image arrays
+static void sample_linear_2d_batch(const SampleBatchState &state,
+                                   void *imageData, const float *x,
+                                   const float *y, const float *z, size_t count,
+                                   float *outData, FloatPixel *maxPixels,
+                                   int *containsDenorms)
+{
+    image_descriptor *imageInfo = state.imageInfo;
+    const ImageLodLayout &layout = state.layout;
+    AddressFn adFn = state.adFn;
+    int x1[kSampleBatchSize], x2[kSampleBatchSize];
+    int y1[kSampleBatchSize], y2[kSampleBatchSize];
+    float fx[kSampleBatchSize], fy[kSampleBatchSize];
+
+    // 1D arrays filter a single row of the selected slice
+    size_t height = layout.height;
+    if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY) height = 1;
+
+    split_linear_coordinates(x, count, x1, x2, fx);
+    bool is1D = imageInfo->type == CL_MEM_OBJECT_IMAGE1D
+        || imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY
+        || imageInfo->type == CL_MEM_OBJECT_IMAGE1D_BUFFER;
+    if (is1D)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            y1[i] = y2[i] = 0;
+            fy[i] = frac(0.5f - 0.5f);
+        }
+    }
+    else
+    {
+        split_linear_coordinates(y, count, y1, y2, fy);
+    }
+
+    float lastIndex = (float)(imageInfo->arraySize - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t layer_offset = 0;
+        if (imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+            layer_offset = layout.slicePitch
+                * (size_t)calculate_array_index(z[i], lastIndex);
+        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+            layer_offset = layout.slicePitch
+                * (size_t)calculate_array_index(y[i], lastIndex);
+        const char *imgPtr = (const char *)imageData + layer_offset;
+
+        int ix1 = adFn(x1[i], layout.width), ix2 = adFn(x2[i], layout.width);
+        int iy1 = 0, iy2 = 0;
+        if (!is1D)
+        {
+            iy1 = adFn(y1[i], height);
+            iy2 = adFn(y2[i], height);
+        }
+
+        int *denorms = containsDenorms ? containsDenorms + i : NULL;
+        float texels[4][4], maxUp[4], maxLow[4], maxAll[4];
+        fetch_filter_texel(state, imgPtr, ix1, iy1, 0, texels[0], denorms);
+        fetch_filter_texel(state, imgPtr, ix2, iy1, 0, texels[1], denorms);
+        texel_max(texels[0], texels[1], maxUp);
+        fetch_filter_texel(state, imgPtr, ix1, iy2, 0, texels[2], denorms);
+        fetch_filter_texel(state, imgPtr, ix2, iy2, 0, texels[3], denorms);
+        texel_max(texels[2], texels[3], maxLow);
+        texel_max(maxUp, maxLow, maxAll);
+        if (maxPixels) memcpy(maxPixels[i].p, maxAll, sizeof(maxAll));
+
+        double wx0 = 1.0 - fx[i], wx1 = fx[i];
+        double wy0 = 1.0 - fy[i], wy1 = fy[i];
+        double weights[4] = { wx0 * wy0, wx1 * wy0, wx0 * wy1, wx1 * wy1 };
+        blend_texels(texels, weights, 4, NULL == containsDenorms,
+                     outData + 4 * i);
+    }
+}
+
+static void sample_linear_3d_batch(const SampleBatchState &state,
+                                   void *imageData, const float *x,
+                                   const float *y, const float *z, size_t count,
+                                   float *outData, FloatPixel *maxPixels,
+                                   int *containsDenorms)
+{
+    const ImageLodLayout &layout = state.layout;
+    AddressFn adFn = state.adFn;
+    int x1[kSampleBatchSize], x2[kSampleBatchSize];
+    int y1[kSampleBatchSize], y2[kSampleBatchSize];
+    int z1[kSampleBatchSize], z2[kSampleBatchSize];
+    float fx[kSampleBatchSize], fy[kSampleBatchSize], fz[kSampleBatchSize];
+
+    split_linear_coordinates(x, count, x1, x2, fx);
+    split_linear_coordinates(y, count, y1, y2, fy);
+    split_linear_coordinates(z, count, z1, z2, fz);
+
+    const char *base = (const char *)imageData;
+    for (size_t i = 0; i < count; i++)
+    {
+        int ix1 = adFn(x1[i], layout.width), ix2 = adFn(x2[i], layout.width);
+        int iy1 = adFn(y1[i], layout.height), iy2 = adFn(y2[i], layout.height);
+        int iz1 = adFn(z1[i], layout.depth), iz2 = adFn(z2[i], layout.depth);
+
+        // Texels in the order the weights below expect them
+        int *denorms = containsDenorms ? containsDenorms + i : NULL;
+        float texels[8][4], maxA[4], maxB[4], maxAll[4];
+        fetch_filter_texel(state, base, ix1, iy1, iz1, texels[0], denorms);
+        fetch_filter_texel(state, base, ix2, iy1, iz1, texels[1], denorms);
+        texel_max(texels[0], texels[1], maxA);
+        fetch_filter_texel(state, base, ix1, iy2, iz1, texels[2], denorms);
+        fetch_filter_texel(state, base, ix2, iy2, iz1, texels[3], denorms);
+        texel_max(texels[2], texels[3], maxB);
+        texel_max(maxA, maxB, maxAll);
+        fetch_filter_texel(state, base, ix1, iy1, iz2, texels[4], denorms);
+        fetch_filter_texel(state, base, ix2, iy1, iz2, texels[5], denorms);
+        texel_max(texels[4], texels[5], maxA);
+        fetch_filter_texel(state, base, ix1, iy2, iz2, texels[6], denorms);
+        fetch_filter_texel(state, base, ix2, iy2, iz2, texels[7], denorms);
+        texel_max(texels[6], texels[7], maxB);
+        texel_max(maxA, maxB, maxA);
+        texel_max(maxA, maxAll, maxAll);
+        if (maxPixels) memcpy(maxPixels[i].p, maxAll, sizeof(maxAll));
+
+        // The 3D weights are formed in float before widening, unlike 2D
+        double wa[2] = { 1.f - fx[i], fx[i] };
+        double wb[2] = { 1.f - fy[i], fy[i] };
+        double wc[2] = { 1.f - fz[i], fz[i] };
+        double weights[8];
+        for (int k = 0; k < 8; k++)
+            weights[k] = wa[k & 1] * wb[(k >> 1) & 1] * wc[k >> 2];
+        blend_texels(texels, weights, 8, NULL == containsDenorms,
+                     outData + 4 * i);
+    }
+}
+
+void sample_image_pixels_float_offset(
+    void *imageData, image_descriptor *imageInfo, const float *x,
+    const float *y, const float *z, size_t count, float xAddressOffset,
+    float yAddressOffset, float zAddressOffset,
+    image_sampler_data *imageSampler, float *outData, FloatPixel *maxPixels,
+    int *containsDenorms, int lod)
+{
+    SampleBatchState state;
+    state.imageInfo = imageInfo;
+    state.codec = get_image_format_codec(imageInfo->format);
+    state.adFn = sAddressingTable[imageSampler];
+    get_image_lod_layout(imageInfo, lod, &state.layout);
+    get_float_border_color(imageInfo, state.border);
+
+    const ImageLodLayout &layout = state.layout;
+    cl_addressing_mode addressing_mode = imageSampler->addressing_mode;
+    bool linear3D = imageSampler->filter_mode != CL_FILTER_NEAREST
+        && layout.depth != 0 && imageInfo->type != CL_MEM_OBJECT_IMAGE2D_ARRAY
+        && imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY;
+    float cx[kSampleBatchSize], cy[kSampleBatchSize], cz[kSampleBatchSize];
+
+    for (size_t start = 0; start < count; start += kSampleBatchSize)
+    {
+        size_t n = std::min(count - start, kSampleBatchSize);
+        memcpy(cx, x + start, n * sizeof(float));
+        if (y)
+            memcpy(cy, y + start, n * sizeof(float));
+        else
+            memset(cy, 0, n * sizeof(float));
+        if (z)
+            memcpy(cz, z + start, n * sizeof(float));
+        else
+            memset(cz, 0, n * sizeof(float));
+
+        int *denorms = NULL;
+        if (containsDenorms)
+        {
+            denorms = containsDenorms + start;
+            memset(denorms, 0, n * sizeof(int));
+        }
+
+        if (imageSampler->normalized_coords)
+        {
+            unnormalize_coordinates(cx, n, xAddressOffset, (float)layout.width,
+                                    addressing_mode);
+            switch (imageInfo->type)
+            {
+                case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+                    memset(cz, 0, n * sizeof(float));
+                    break;
+                case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+                    unnormalize_coordinates(cy, n, yAddressOffset,
+                                            (float)layout.height,
+                                            addressing_mode);
+                    break;
+                default:
+                    unnormalize_coordinates(cy, n, yAddressOffset,
+                                            (float)layout.height,
+                                            addressing_mode);
+                    unnormalize_coordinates(cz, n, zAddressOffset,
+                                            (float)layout.depth,
+                                            addressing_mode);
+            }
+        }
+
+        float *out = outData + 4 * start;
+        FloatPixel *maxOut = maxPixels ? maxPixels + start : NULL;
+        if (imageSampler->filter_mode == CL_FILTER_NEAREST)
+            sample_nearest_batch(state, imageData, cx, cy, cz, n, out, maxOut,
+                                 denorms);
+        else if (linear3D)
+            sample_linear_3d_batch(state, imageData, cx, cy, cz, n, out,
+                                   maxOut, denorms);
+        else
+            sample_linear_2d_batch(state, imageData, cx, cy, cz, n, out,
+                                   maxOut, denorms);
+    }
+}
+
+
+int debug_find_vector_in_image(void *imagePtr, image_descriptor *imageInfo,
+                               void *vectorToFind, size_t vectorSize, int *outX,
+                               int *outY, int *outZ, size_t lod)
+{
+    int foundCount = 0;
+    char *iPtr = (char *)imagePtr;
+    size_t width;
+    size_t depth;
+    size_t height;
+    size_t row_pitch;
+    size_t slice_pitch;
+
+    switch (imageInfo->type)
+    {
         case CL_MEM_OBJECT_IMAGE1D_BUFFER:
         case CL_MEM_OBJECT_IMAGE1D:
             width = (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
@@ -2691,188 +3064,16 @@ void pack_image_pixel(float *srcVector, const cl_image_format *imageFormat,
                       void *outData)
 {
     swizzle_vector_for_image<float>(srcVector, imageFormat);
-    size_t channelCount = get_format_channel_count(imageFormat);
-    switch (imageFormat->image_channel_data_type)
-    {
-        case CL_HALF_FLOAT: {
-            cl_half *ptr = (cl_half *)outData;
 
-            switch (gFloatToHalfRoundingMode)
-            {
-                case kRoundToNearestEven:
-                    for (unsigned int i = 0; i < channelCount; i++)
-                        ptr[i] = cl_half_from_float(srcVector[i], CL_HALF_RTE);
-                    break;
-                case kRoundTowardZero:
-                    for (unsigned int i = 0; i < channelCount; i++)
-                        ptr[i] = cl_half_from_float(srcVector[i], CL_HALF_RTZ);
-                    break;
-                default:
-                    log_error("ERROR: Test internal error -- unhandled or "
-                              "unknown float->half rounding mode.\n");
-                    exit(-1);
-                    break;
-            }
-            break;
-        }
-
-        case CL_FLOAT: {
-            cl_float *ptr = (cl_float *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] = srcVector[i];
-            break;
-        }
-
-        case CL_SNORM_INT8: {
-            cl_char *ptr = (cl_char *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] =
-                    (cl_char)NORMALIZE_SIGNED(srcVector[i], -127.0f, 127.f);
-            break;
-        }
-        case CL_SNORM_INT16: {
-            cl_short *ptr = (cl_short *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] =
-                    (short)NORMALIZE_SIGNED(srcVector[i], -32767.f, 32767.f);
-            break;
-        }
-        case CL_UNORM_INT8: {
-            cl_uchar *ptr = (cl_uchar *)outData;
-            if (is_sRGBA_order(imageFormat->image_channel_order))
-            {
-                ptr[0] = (unsigned char)(sRGBmap(srcVector[0]) + 0.5);
-                ptr[1] = (unsigned char)(sRGBmap(srcVector[1]) + 0.5);
-                ptr[2] = (unsigned char)(sRGBmap(srcVector[2]) + 0.5);
-                if (channelCount == 4)
-                    ptr[3] = (unsigned char)NORMALIZE(srcVector[3], 255.f);
-            }
-            else
-            {
-                for (unsigned int i = 0; i < channelCount; i++)
-                    ptr[i] = (unsigned char)NORMALIZE(srcVector[i], 255.f);
-            }
-#ifdef CL_1RGB_APPLE
-            if (imageFormat->image_channel_order == CL_1RGB_APPLE)
-                ptr[0] = 255.0f;
-#endif
-#ifdef CL_BGR1_APPLE
-            if (imageFormat->image_channel_order == CL_BGR1_APPLE)
-                ptr[3] = 255.0f;
-#endif
-            break;
-        }
-        case CL_UNORM_INT16: {
-            cl_ushort *ptr = (cl_ushort *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] = (unsigned short)NORMALIZE(srcVector[i], 65535.f);
-            break;
-        }
-        case CL_UNORM_SHORT_555: {
-            cl_ushort *ptr = (cl_ushort *)outData;
-            ptr[0] =
-                (((unsigned short)NORMALIZE(srcVector[0], 31.f) & 31) << 10)
-                | (((unsigned short)NORMALIZE(srcVector[1], 31.f) & 31) << 5)
-                | (((unsigned short)NORMALIZE(srcVector[2], 31.f) & 31) << 0);
-            break;
-        }
-        case CL_UNORM_SHORT_565: {
-            cl_ushort *ptr = (cl_ushort *)outData;
-            ptr[0] =
-                (((unsigned short)NORMALIZE(srcVector[0], 31.f) & 31) << 11)
-                | (((unsigned short)NORMALIZE(srcVector[1], 63.f) & 63) << 5)
-                | (((unsigned short)NORMALIZE(srcVector[2], 31.f) & 31) << 0);
-            break;
-        }
-        case CL_UNORM_INT_101010: {
-            cl_uint *ptr = (cl_uint *)outData;
-            ptr[0] =
-                (((unsigned int)NORMALIZE(srcVector[0], 1023.f) & 1023) << 20)
-                | (((unsigned int)NORMALIZE(srcVector[1], 1023.f) & 1023) << 10)
-                | (((unsigned int)NORMALIZE(srcVector[2], 1023.f) & 1023) << 0);
-            break;
-        }
-        case CL_UNORM_INT_101010_2: {
-            cl_uint *ptr = (cl_uint *)outData;
-            ptr[0] =
-                (((unsigned int)NORMALIZE(srcVector[0], 1023.f) & 1023) << 22)
-                | (((unsigned int)NORMALIZE(srcVector[1], 1023.f) & 1023) << 12)
-                | (((unsigned int)NORMALIZE(srcVector[2], 1023.f) & 1023) << 2)
-                | (((unsigned int)NORMALIZE(srcVector[3], 3.f) & 3) << 0);
-            break;
-        }
-        case CL_UNORM_INT_2_101010_EXT: {
-            cl_uint *ptr = (cl_uint *)outData;
-            ptr[0] = (((unsigned int)NORMALIZE(srcVector[0], 3.f) & 3) << 30)
-                | (((unsigned int)NORMALIZE(srcVector[1], 1023.f) & 1023) << 20)
-                | (((unsigned int)NORMALIZE(srcVector[2], 1023.f) & 1023) << 10)
-                | (((unsigned int)NORMALIZE(srcVector[3], 1023.f) & 1023) << 0);
-            break;
-        }
-        case CL_SIGNED_INT8: {
-            cl_char *ptr = (cl_char *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] =
-                    (cl_char)CONVERT_INT(srcVector[i], -127.0f, 127.f, 127);
-            break;
-        }
-        case CL_SIGNED_INT16: {
-            cl_short *ptr = (cl_short *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] =
-                    (short)CONVERT_INT(srcVector[i], -32767.f, 32767.f, 32767);
-            break;
-        }
-        case CL_SIGNED_INT32: {
-            cl_int *ptr = (cl_int *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] = round_to_even(srcVector[i]);
-            break;
-        }
-        case CL_UNSIGNED_INT8: {
-            cl_uchar *ptr = (cl_uchar *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] =
-                    (cl_uchar)CONVERT_UINT(srcVector[i], 255.f, CL_UCHAR_MAX);
-            break;
-        }
-        case CL_UNSIGNED_INT16: {
-            cl_ushort *ptr = (cl_ushort *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] = (cl_ushort)CONVERT_UINT(srcVector[i], 32767.f,
-                                                 CL_USHRT_MAX);
-            break;
-        }
-        case CL_UNSIGNED_INT32: {
-            cl_uint *ptr = (cl_uint *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-                ptr[i] = (cl_uint)CONVERT_UINT(
-                    srcVector[i],
-                    MAKE_HEX_FLOAT(0x1.fffffep31f, 0x1fffffe, 31 - 23),
-                    CL_UINT_MAX);
-            break;
-        }
-#ifdef CL_SFIXED14_APPLE
-        case CL_SFIXED14_APPLE: {
-            cl_ushort *ptr = (cl_ushort *)outData;
-            for (unsigned int i = 0; i < channelCount; i++)
-            {
-                cl_float f = fmaxf(srcVector[i], -1.0f);
-                f = fminf(f, 3.0f);
-                cl_int d = rintf(f * 0x1.0p14f);
-                d += 16384;
-                if (d > CL_USHRT_MAX) d = CL_USHRT_MAX;
-                ptr[i] = d;
-            }
-            break;
-        }
-#endif
-        default:
-            log_error("INTERNAL ERROR: unknown format (%d)\n",
-                      imageFormat->image_channel_data_type);
-            exit(-1);
-            break;
+    // The vector is already in memory order, so encode it as RGBA
+    const ImageFormatCodec *codec = get_image_format_codec(imageFormat);
+    if (!codec->encode)
+    {
+        log_error("INTERNAL ERROR: unknown format (%d)\n",
+                  imageFormat->image_channel_data_type);
+        exit(-1);
     }
+    codec->encode(codec, srcVector, 1, outData);
 }
 
 void pack_image_pixel_error(const float *srcVector,
@@ -3602,6 +3803,69 @@ void get_sampler_kernel_code(image_sampler_data *imageSampler, char *outLine)
             addressMode, filterMode, normalized);
 }
 
+void copy_pitched_region(void *dst, size_t dstRowPitch, size_t dstSlicePitch,
+                         const void *src, size_t srcRowPitch,
+                         size_t srcSlicePitch, size_t rowBytes, size_t rows,
+                         size_t slices)
+{
+    if (rowBytes == 0 || rows == 0 || slices == 0) return;
+
+    // Fold contiguous rows into one, then contiguous slices
+    if (rows == 1 || (srcRowPitch == rowBytes && dstRowPitch == rowBytes))
+    {
+        rowBytes *= rows;
+        rows = 1;
+        if (slices == 1
+            || (srcSlicePitch == rowBytes && dstSlicePitch == rowBytes))
+        {
+            rowBytes *= slices;
+            slices = 1;
+        }
+    }
+
+    const char *srcSlice = (const char *)src;
+    char *dstSlice = (char *)dst;
+    for (size_t z = 0; z < slices; z++)
+    {
+        const char *srcRow = srcSlice;
+        char *dstRow = dstSlice;
+        for (size_t y = 0; y < rows; y++)
+        {
+            memcpy(dstRow, srcRow, rowBytes);
+            srcRow += srcRowPitch;
+            dstRow += dstRowPitch;
+        }
+        srcSlice += srcSlicePitch;
+        dstSlice += dstSlicePitch;
+    }
+}
+
+void fill_pitched_region(void *dst, size_t rowPitch, size_t slicePitch,
+                         const void *pattern, size_t patternSize, size_t count,
+                         size_t rows, size_t slices)
+{
+    size_t rowBytes = patternSize * count;
+    if (rowBytes == 0 || rows == 0 || slices == 0) return;
+
+    // Build the first row by doubling, then copy it to the others
+    char *first = (char *)dst;
+    memcpy(first, pattern, patternSize);
+    for (size_t filled = patternSize; filled < rowBytes;)
+    {
+        size_t n = std::min(filled, rowBytes - filled);
+        memcpy(first + filled, first, n);
+        filled += n;
+    }
+
+    char *slice = first;
+    for (size_t z = 0; z < slices; z++, slice += slicePitch)
+    {
+        char *row = slice;
+        for (size_t y = 0; y < rows; y++, row += rowPitch)
+            if (row != first) memcpy(row, first, rowBytes);
+    }
+}
+
 void copy_image_data(image_descriptor *srcImageInfo,
                      image_descriptor *dstImageInfo, void *imageValues,
                      void *destImageValues, const size_t sourcePos[],
@@ -3740,20 +4004,10 @@ void copy_image_data(image_descriptor *srcImageInfo,
         + destPos_lod[1] * dst_row_pitch_lod + pixelSize * destPos_lod[0]
         + dst_mip_level_offset;
 
-    for (size_t z = 0; z < (regionSize[2] > 0 ? regionSize[2] : 1); z++)
-    {
-        char *rowSourcePtr = sourcePtr;
-        char *rowDestPtr = destPtr;
-        for (size_t y = 0; y < regionSize[1]; y++)
-        {
-            memcpy(rowDestPtr, rowSourcePtr, pixelSize * regionSize[0]);
-            rowSourcePtr += src_row_pitch_lod;
-            rowDestPtr += dst_row_pitch_lod;
-        }
-
-        sourcePtr += src_slice_pitch_lod;
-        destPtr += dst_slice_pitch_lod;
-    }
+    copy_pitched_region(destPtr, dst_row_pitch_lod, dst_slice_pitch_lod,
+                        sourcePtr, src_row_pitch_lod, src_slice_pitch_lod,
+                        pixelSize * regionSize[0], regionSize[1],
+                        regionSize[2] > 0 ? regionSize[2] : 1);
 }
 
 float random_float(float low, float high, MTdata d)
@@ -4134,92 +4388,50 @@ cl_uint compute_max_mip_levels(size_t width, size_t height, size_t depth)
     return retMaxMipLevels;
 }
 
-cl_ulong compute_mipmapped_image_size(image_descriptor imageInfo)
+void compute_mip_pyramid(const image_descriptor *imageInfo,
+                         image_mip_pyramid *pyramid)
 {
-    cl_ulong retSize = 0;
-    size_t curr_width, curr_height, curr_depth, curr_array_size;
-    curr_width = imageInfo.width;
-    curr_height = imageInfo.height;
-    curr_depth = imageInfo.depth;
-    curr_array_size = imageInfo.arraySize;
-
-    for (int i = 0; i < (int)imageInfo.num_mip_levels; i++)
-    {
-        switch (imageInfo.type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                retSize += (cl_ulong)curr_width * curr_height * curr_depth
-                    * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retSize += (cl_ulong)curr_width * curr_height
-                    * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D:
-                retSize +=
-                    (cl_ulong)curr_width * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retSize += (cl_ulong)curr_width * curr_array_size
-                    * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retSize += (cl_ulong)curr_width * curr_height * curr_array_size
-                    * get_pixel_size(imageInfo.format);
-                break;
-        }
+    pyramid->levels.clear();
+    pyramid->totalSize = 0;
 
-        switch (imageInfo.type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                curr_depth = curr_depth >> 1 ? curr_depth >> 1 : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                curr_height = curr_height >> 1 ? curr_height >> 1 : 1;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D:
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                curr_width = curr_width >> 1 ? curr_width >> 1 : 1;
-        }
+    if (imageInfo->num_mip_levels < 2)
+    {
+        image_mip_level level = { *imageInfo, 0,
+                                  (size_t)get_image_size(imageInfo) };
+        pyramid->levels.push_back(level);
+        pyramid->totalSize = level.size;
+        return;
     }
 
-    return retSize;
-}
-
-size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod)
-{
-    size_t retOffset = 0;
-    size_t width, height, depth;
-    width = imageInfo->width;
-    height = imageInfo->height;
-    depth = imageInfo->depth;
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+    size_t width = imageInfo->width;
+    size_t height = imageInfo->height;
+    size_t depth = imageInfo->depth;
 
-    for (size_t i = 0; i < lod; i++)
+    for (cl_uint lod = 0; lod < imageInfo->num_mip_levels; lod++)
     {
+        image_mip_level level;
+        level.info = *imageInfo;
+        level.info.width = width;
+        level.info.height = height;
+        level.info.depth = depth;
+        level.info.num_mip_levels = 0;
+        level.info.rowPitch = width * pixelSize;
         switch (imageInfo->type)
         {
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retOffset += (size_t)width * height * imageInfo->arraySize
-                    * get_pixel_size(imageInfo->format);
-                break;
-            case CL_MEM_OBJECT_IMAGE3D:
-                retOffset += (size_t)width * height * depth
-                    * get_pixel_size(imageInfo->format);
-                break;
             case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retOffset += (size_t)width * imageInfo->arraySize
-                    * get_pixel_size(imageInfo->format);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retOffset +=
-                    (size_t)width * height * get_pixel_size(imageInfo->format);
+                level.info.slicePitch = level.info.rowPitch;
                 break;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D:
-                retOffset += (size_t)width * get_pixel_size(imageInfo->format);
+            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            case CL_MEM_OBJECT_IMAGE3D:
+                level.info.slicePitch = level.info.rowPitch * height;
                 break;
+            default: level.info.slicePitch = 0; break;
         }
+        level.offset = pyramid->totalSize;
+        level.size = (size_t)get_image_size(&level.info);
+        pyramid->totalSize += level.size;
+        pyramid->levels.push_back(level);
 
         // Compute next lod dimensions
         switch (imageInfo->type)
@@ -4228,12 +4440,53 @@ size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod)
             case CL_MEM_OBJECT_IMAGE2D:
             case CL_MEM_OBJECT_IMAGE2D_ARRAY:
                 height = (height >> 1) ? (height >> 1) : 1;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-            case CL_MEM_OBJECT_IMAGE1D: width = (width >> 1) ? (width >> 1) : 1;
+            default: width = (width >> 1) ? (width >> 1) : 1;
         }
     }
-    return retOffset;
+}
+
+static bool same_mip_shape(const image_descriptor *a, const image_descriptor *b)
+{
+    return a->type == b->type && a->width == b->width
+        && a->height == b->height && a->depth == b->depth
+        && a->arraySize == b->arraySize && a->rowPitch == b->rowPitch
+        && a->slicePitch == b->slicePitch
+        && a->num_mip_levels == b->num_mip_levels
+        && a->format->image_channel_order == b->format->image_channel_order
+        && a->format->image_channel_data_type
+        == b->format->image_channel_data_type;
+}
+
+// The reference readers look up the level layout for every pixel, and
+// callers work on one image at a time, so keep the last image's pyramid per
+// thread
+static const image_mip_pyramid &
+get_cached_mip_pyramid(const image_descriptor *imageInfo)
+{
+    static thread_local image_descriptor shape;
+    static thread_local cl_image_format format;
+    static thread_local image_mip_pyramid pyramid;
+
+    if (pyramid.levels.empty() || !same_mip_shape(&shape, imageInfo))
+    {
+        compute_mip_pyramid(imageInfo, &pyramid);
+        shape = *imageInfo;
+        format = *imageInfo->format;
+        shape.format = &format;
+    }
+    return pyramid;
+}
+
+cl_ulong compute_mipmapped_image_size(image_descriptor imageInfo)
+{
+    return get_cached_mip_pyramid(&imageInfo).totalSize;
+}
+
+size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod)
+{
+    const image_mip_pyramid &pyramid = get_cached_mip_pyramid(imageInfo);
+    if (lod >= pyramid.levels.size()) return pyramid.totalSize;
+    return pyramid.levels[lod].offset;
 }
 
 const char *convert_image_type_to_string(cl_mem_object_type image_type)
@@ -40,6 +40,7 @@
 #include "mt19937.h"
 #include "rounding_mode.h"
 #include "clImageHelper.h"
+#include "imageCodec.h"
 
 #include <CL/cl_half.h>
 
@@ -140,8 +141,27 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
                                         image_descriptor *imageInfo, size_t y,
                                         size_t thirdDim);
 
+enum PixelCompareMode
+{
+    // Every defined bit must match
+    kPixelCompareExact,
+    // For CL_FLOAT and CL_HALF_FLOAT, also accept any NaN for an expected NaN
+    // and zero for an expected denormal, as allowed for stored values. CL_FLOAT
+    // channels are compared as values, so zeros of either sign match.
+    kPixelCompareFloatTolerant
+};
+
+// Compares count pixels of format and returns the index of the first one
+// that differs, or count if they all match. Undefined bits are ignored and
+// both encodings of -1.0 are accepted for the SNORM types.
+size_t compare_pixels(const cl_image_format *format, const char *expected,
+                      const char *actual, size_t count,
+                      PixelCompareMode mode = kPixelCompareExact);
+
+// compare_pixels() on the first imageInfo->width pixels of two scanlines
 size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
-                         const char *bPtr);
+                         const char *bPtr,
+                         PixelCompareMode mode = kPixelCompareExact);
 
 void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
                    size_t sizes[][3], size_t maxWidth, size_t maxHeight,
@@ -177,6 +197,20 @@ extern int debug_find_pixel_in_image(void *imagePtr,
                                      float *valuesToFind, int *outX, int *outY,
                                      int *outZ, int lod = 0);
 
+// Copies slices of rows rows of rowBytes bytes each between two pitched
+// layouts. Rows and slices that are contiguous on both sides are merged, so a
+// tightly packed region is copied by a single memcpy.
+void copy_pitched_region(void *dst, size_t dstRowPitch, size_t dstSlicePitch,
+                         const void *src, size_t srcRowPitch,
+                         size_t srcSlicePitch, size_t rowBytes, size_t rows,
+                         size_t slices);
+
+// Writes count copies of the patternSize bytes at pattern to each row of a
+// pitched region of rows by slices rows
+void fill_pitched_region(void *dst, size_t rowPitch, size_t slicePitch,
+                         const void *pattern, size_t patternSize, size_t count,
+                         size_t rows, size_t slices);
+
 extern void copy_image_data(image_descriptor *srcImageInfo,
                             image_descriptor *dstImageInfo, void *imageValues,
                             void *destImageValues, const size_t sourcePos[],
@@ -188,6 +222,28 @@ extern bool is_sRGBA_order(cl_channel_order image_channel_order);
 
 inline float calculate_array_index(float coord, float extent);
 
+// One level of a mipmapped image. info describes the level as an image of its
+// own, with tightly packed pitches and no mip levels, so the single level
+// helpers work on it at offset bytes into the image's host data.
+typedef struct
+{
+    image_descriptor info;
+    size_t offset;
+    size_t size;
+} image_mip_level;
+
+// Every level of an image, stored one after the other as the tests lay out
+// mipmapped host data. An image without mip levels has a single level with
+// its own pitches.
+typedef struct
+{
+    std::vector<image_mip_level> levels;
+    size_t totalSize;
+} image_mip_pyramid;
+
+void compute_mip_pyramid(const image_descriptor *imageInfo,
+                         image_mip_pyramid *pyramid);
+
 cl_uint compute_max_mip_levels(size_t width, size_t height, size_t depth);
 cl_ulong compute_mipmapped_image_size(image_descriptor imageInfo);
 size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod);
@@ -686,6 +742,25 @@ FloatPixel sample_image_pixel_float_offset(
     image_sampler_data *imageSampler, float *outData, int verbose,
     int *containsDenorms, int lod);
 
+// Samples count coordinates at once, with the same results as calling
+// sample_image_pixel_float_offset for each of them without verbose output.
+// y and z may be NULL when the image has no such coordinate. outData receives
+// four floats per coordinate and maxPixels, if not NULL, the largest texel
+// magnitudes touched. If containsDenorms is NULL denormals are flushed to
+// zero, otherwise it receives one flag per coordinate.
+void sample_image_pixels_float_offset(
+    void *imageData, image_descriptor *imageInfo, const float *x,
+    const float *y, const float *z, size_t count, float xAddressOffset,
+    float yAddressOffset, float zAddressOffset,
+    image_sampler_data *imageSampler, float *outData, FloatPixel *maxPixels,
+    int *containsDenorms, int lod);
+
+// Reads count pixels of row (y, z) starting at x as RGBA floats, four per
+// pixel. Pixels outside the mip level get the border color, so this matches
+// calling read_image_pixel_float for each pixel.
+extern void read_image_row_float(void *imageData, image_descriptor *imageInfo,
+                                 int x, int y, int z, size_t count,
+                                 float *outData, int lod);
 
 extern void pack_image_pixel(unsigned int *srcVector,
                              const cl_image_format *imageFormat, void *outData);
@@ -764,6 +839,7 @@ static int inline is_half_denorm(cl_half half) { return IsHalfSubnormal(half); }
 static int inline is_half_zero(cl_half half) { return (half & 0x7fff) == 0; }
 
 extern double sRGBmap(float fc);
+extern double sRGBunmap(float fc);
 
 extern const char *convert_image_type_to_string(cl_mem_object_type imageType);
 
@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "randomPool.h"
+#include "errorHelpers.h"
+#include "testHarness.h"
+
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+
+// Bytes copied per draw from the caller's stream. Blocks start on four byte
+// boundaries of both the pool and the destination, so word-wise processing
+// of the pool carries over to the copies.
+static const size_t kRandomPoolBlockSize = 64 * 1024;
+
+// Mixed into the startup seed so the pool is not the same stream that
+// callers seeded from gRandomSeed draw their offsets from.
+static const cl_uint kRandomPoolSeed = 0x7a5c3e11;
+
+static void generate_random_bytes(char *data, size_t size, MTdata d)
+{
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        cl_uint r = genrand_int32(d);
+        memcpy(data + i, &r, sizeof(r));
+    }
+    for (; i < size; i++) data[i] = (char)genrand_int32(d);
+}
+
+RandomPool::RandomPool(size_t size, RandomPoolGenerateFn generate)
+    : mData(std::max(size, kRandomPoolBlockSize))
+{
+    cl_uint seed = gStartupRandomSeed ^ kRandomPoolSeed;
+    log_info("Random pool of %zu bytes seeded with %u.\n", mData.size(),
+             seed);
+    MTdataHolder d(seed);
+    if (generate == NULL) generate = generate_random_bytes;
+    generate(mData.data(), mData.size(), d);
+}
+
+void RandomPool::Fill(void *dst, size_t count, MTdata d) const
+{
+    char *out = (char *)dst;
+    while (count)
+    {
+        size_t n = std::min(count, kRandomPoolBlockSize);
+        cl_ulong starts = (mData.size() - n) / 4 + 1;
+        size_t offset = (size_t)((genrand_int32(d) * starts) >> 32) * 4;
+        assert(offset + n <= mData.size());
+        memcpy(out, mData.data() + offset, n);
+        out += n;
+        count -= n;
+    }
+}
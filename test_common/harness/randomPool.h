@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _randomPool_h
+#define _randomPool_h
+
+#include "mt19937.h"
+
+#include <stddef.h>
+#include <vector>
+
+// Fills size bytes of a pool from d
+typedef void (*RandomPoolGenerateFn)(char *data, size_t size, MTdata d);
+
+// A block of random data generated once per run, for tests that need far
+// more random bytes than they can afford to draw one word at a time.
+//
+// The pool is generated from gStartupRandomSeed, so it is the same however
+// many tests ran before it was created, and its seed is logged. Fill copies
+// blocks from offsets drawn from the caller's MTdata, one draw per block, so
+// what a caller gets is reproducible per seed.
+class RandomPool {
+public:
+    // generate may be NULL for uniformly random bytes
+    RandomPool(size_t size, RandomPoolGenerateFn generate);
+
+    void Fill(void *dst, size_t count, MTdata d) const;
+
+    size_t Size() const { return mData.size(); }
+
+private:
+    RandomPool(const RandomPool &); // do not implement
+    void operator=(const RandomPool &); // do not implement
+
+    std::vector<char> mData;
+};
+
+#endif // _randomPool_h
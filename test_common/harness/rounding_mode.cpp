@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "rounding_mode.h"
+#include "fpcontrol.h"
 
 #if (defined(__arm__) || defined(__aarch64__))
 #define FPSCR_FZ (1 << 24) // Flush-To-Zero mode
@@ -261,3 +262,76 @@ void UnFlushToZero(void *p)
 #error  Please configure FlushToZero and UnFlushToZero to behave properly on this operating system.
 #endif
 }
+
+FPUStateGuard::FPUStateGuard()
+    : savedRound(get_round()), currentRound(savedRound), currentFTZ(-1),
+      ftzChanged(false), changed(false), savedFPMode(0), transitionCount(0)
+{}
+
+FPUStateGuard::FPUStateGuard(const FPUState &state): FPUStateGuard()
+{
+    Apply(state);
+}
+
+FPUStateGuard::~FPUStateGuard() { Restore(); }
+
+void FPUStateGuard::Restore()
+{
+    if (!changed) return;
+
+    // The control word saved by the first SetFTZ() also holds the rounding
+    // mode of that moment on some hosts, so restore it first and always put
+    // the rounding mode back after.
+    if (ftzChanged)
+    {
+        FPU_mode_type mode = (FPU_mode_type)savedFPMode;
+        RestoreFPState(&mode);
+    }
+    if (savedRound != kDefaultRoundingMode) set_round(savedRound, kfloat);
+
+    currentRound = savedRound;
+    currentFTZ = -1;
+    ftzChanged = false;
+    changed = false;
+}
+
+void FPUStateGuard::SetRound(RoundingMode r, Type outType)
+{
+    // set_round() maps the default mode to what the output type uses, so
+    // resolve it here to tell whether the hardware state would change.
+    if (r == kDefaultRoundingMode)
+        r = (outType == kfloat || outType == kdouble) ? kRoundToNearestEven
+                                                      : kRoundTowardZero;
+    if (r == currentRound) return;
+
+    set_round(r, kfloat);
+    currentRound = r;
+    changed = true;
+    transitionCount++;
+}
+
+void FPUStateGuard::SetFTZ(bool ftz)
+{
+    if (currentFTZ == (int)ftz) return;
+
+    FPU_mode_type oldMode = 0;
+    if (ftz)
+        ForceFTZ(&oldMode);
+    else
+        DisableFTZ(&oldMode);
+
+    if (!ftzChanged)
+    {
+        savedFPMode = oldMode;
+        ftzChanged = true;
+    }
+    currentFTZ = ftz;
+    changed = true;
+    transitionCount++;
+}
+
+void FPUStateGuard::Apply(const FPUState &state)
+{
+    SetFTZ(state.ftz);
+    SetRound(state.round, state.type);
+}
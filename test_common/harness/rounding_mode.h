@@ -57,5 +57,56 @@ extern RoundingMode get_round(void);
 extern void *FlushToZero(void);
 extern void UnFlushToZero(void *p);
 
+// The floating point environment a host reference computation needs. The
+// round and type fields have the meaning of the arguments to set_round().
+// Plain data, so it can be handed to ThreadPool jobs through their userInfo.
+struct FPUState
+{
+    RoundingMode round;
+    Type type;
+    bool ftz;
+};
+
+// Scoped control of the calling thread's rounding mode and denorm flushing.
+// The state the thread had when the guard was created is restored when the
+// guard goes out of scope, including when an exception unwinds through it.
+// Requests that match the state the guard last set are not sent to the
+// hardware again, so hot loops may call SetRound()/SetFTZ() freely, and
+// GetTransitionCount() reports how many changes actually happened.
+//
+// FPU control registers are per thread. A guard must be created and
+// destroyed on the same thread, so jobs should receive an FPUState and create
+// their own guard from it rather than share a guard.
+class FPUStateGuard {
+public:
+    FPUStateGuard();
+    explicit FPUStateGuard(const FPUState &state);
+    ~FPUStateGuard();
+
+    FPUStateGuard(const FPUStateGuard &) = delete;
+    FPUStateGuard &operator=(const FPUStateGuard &) = delete;
+
+    void SetRound(RoundingMode r, Type outType);
+    void SetFTZ(bool ftz);
+    void Apply(const FPUState &state);
+    // Put the saved state back before the guard goes out of scope
+    void Restore();
+
+    RoundingMode GetRound() const { return currentRound; }
+    unsigned GetTransitionCount() const { return transitionCount; }
+
+private:
+    RoundingMode savedRound;
+    RoundingMode currentRound;
+    // -1 until SetFTZ() is first called, since the initial state is not
+    // known in a portable way.
+    int currentFTZ;
+    bool ftzChanged;
+    bool changed;
+    // FPU_mode_type, widened so that this header does not need fpcontrol.h
+    int64_t savedFPMode;
+    unsigned transitionCount;
+};
+
 
 #endif /* __ROUNDING_MODE_H__ */
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SCAN_REDUCE_REFERENCE_H
+#define SCAN_REDUCE_REFERENCE_H
+
+#include "ThreadPool.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <type_traits>
+
+// Host references for work-group, sub-group and clustered scans and
+// reductions. Op provides a static combine(a, b) so the operation is known at
+// compile time and inlined into the loops. Integer reductions are exact in any
+// order and run on independent accumulators the compiler can vectorize;
+// floating point values are always combined in index order.
+
+// Reduction of in[0, n), n > 0, starting from in[0].
+template <typename Op, typename T> T reference_reduce(const T *in, size_t n)
+{
+    const size_t lanes = 8;
+    T result = in[0];
+    size_t i = 1;
+    if (std::is_integral<T>::value && n > 2 * lanes)
+    {
+        T partial[lanes];
+        for (size_t k = 0; k < lanes; k++) partial[k] = in[i + k];
+        for (i += lanes; i + lanes <= n; i += lanes)
+            for (size_t k = 0; k < lanes; k++)
+                partial[k] = Op::combine(partial[k], in[i + k]);
+        for (size_t k = 0; k < lanes; k++)
+            result = Op::combine(result, partial[k]);
+    }
+    for (; i < n; i++) result = Op::combine(result, in[i]);
+    return result;
+}
+
+template <typename Op, typename T>
+void reference_scan_inclusive(const T *in, T *out, size_t n, T identity)
+{
+    T result = identity;
+    for (size_t i = 0; i < n; i++)
+    {
+        result = Op::combine(result, in[i]);
+        out[i] = result;
+    }
+}
+
+template <typename Op, typename T>
+void reference_scan_exclusive(const T *in, T *out, size_t n, T identity)
+{
+    T result = identity;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = result;
+        result = Op::combine(result, in[i]);
+    }
+}
+
+// Each item of out receives the reduction of its cluster of cluster_size
+// consecutive items of in; the last cluster may be shorter.
+template <typename Op, typename T>
+void reference_clustered_reduce(const T *in, T *out, size_t n,
+                                size_t cluster_size)
+{
+    for (size_t i = 0; i < n; i += cluster_size)
+    {
+        size_t count = std::min(cluster_size, n - i);
+        T result = reference_reduce<Op>(in + i, count);
+        std::fill(out + i, out + i + count, result);
+    }
+}
+
+template <typename Fn> struct ReferenceSegmentJobs
+{
+    size_t n;
+    size_t segment_size;
+    size_t segments_per_job;
+    Fn *fn;
+
+    static cl_int Run(cl_uint job_id, cl_uint thread_id, void *userInfo)
+    {
+        ReferenceSegmentJobs *jobs = (ReferenceSegmentJobs *)userInfo;
+        size_t step = jobs->segments_per_job * jobs->segment_size;
+        size_t end = std::min(jobs->n, (job_id + 1) * step);
+        for (size_t begin = job_id * step; begin < end;
+             begin += jobs->segment_size)
+        {
+            int error = (*jobs->fn)(
+                begin, std::min(jobs->segment_size, jobs->n - begin));
+            if (error) return error;
+        }
+        return CL_SUCCESS;
+    }
+};
+
+// Calls fn(begin, count) for each segment of segment_size items of [0, n),
+// such as the work-groups of an NDRange; the last segment may be shorter.
+// Large inputs are split across the thread pool, so fn must be safe to call
+// concurrently for different segments. Returns the first nonzero result of
+// fn, after which the remaining segments may be skipped. Must not be called
+// from a thread pool job.
+template <typename Fn>
+int reference_for_each_segment(size_t n, size_t segment_size, Fn fn)
+{
+    const size_t parallel_items = 1 << 16;
+    size_t segments = (n + segment_size - 1) / segment_size;
+    cl_uint threads = n >= parallel_items ? GetThreadCount() : 1;
+    if (threads < 2 || segments < 2)
+    {
+        for (size_t begin = 0; begin < n; begin += segment_size)
+        {
+            int error = fn(begin, std::min(segment_size, n - begin));
+            if (error) return error;
+        }
+        return 0;
+    }
+
+    // A few jobs per thread to balance uneven segments
+    size_t jobs_wanted = std::min(segments, (size_t)threads * 4);
+    ReferenceSegmentJobs<Fn> jobs;
+    jobs.n = n;
+    jobs.segment_size = segment_size;
+    jobs.segments_per_job = (segments + jobs_wanted - 1) / jobs_wanted;
+    jobs.fn = &fn;
+    size_t job_count =
+        (segments + jobs.segments_per_job - 1) / jobs.segments_per_job;
+    return ThreadPool_Do(ReferenceSegmentJobs<Fn>::Run, (cl_uint)job_count,
+                         &jobs);
+}
+
+#endif // SCAN_REDUCE_REFERENCE_H
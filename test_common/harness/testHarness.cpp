@@ -53,6 +53,7 @@ int gFailCount;
 int gTestCount;
 cl_uint gRandomSeed = 0;
 cl_uint gReSeed = 0;
+cl_uint gStartupRandomSeed = 0;
 
 int gFlushDenormsToZero = 0;
 int gInfNanSupport = 1;
@@ -294,6 +295,7 @@ int runTestHarnessWithCheck(int argc, const char *argv[], int testNum,
         gRandomSeed = (cl_uint)time(NULL);
         log_info("Random seed: %u.\n", gRandomSeed);
         gReSeed = 1;
+        gStartupRandomSeed = gRandomSeed;
         argc--;
     }
     else
@@ -165,6 +165,10 @@ extern int gFailCount;
 extern int gTestCount;
 extern cl_uint gReSeed;
 extern cl_uint gRandomSeed;
+// gRandomSeed as parsed from the command line. With randomize, gRandomSeed
+// changes after every test, so state that lives for the whole run seeds from
+// this instead.
+extern cl_uint gStartupRandomSeed;
 
 // Supply a list of functions to test here. This will allocate a CL device,
 // create a context, all that setup work, and then call each function in turn as
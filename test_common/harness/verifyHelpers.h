@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef VERIFY_HELPERS_H
+#define VERIFY_HELPERS_H
+
+#include "errorHelpers.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Linear time checks for result sets produced by many threads racing on one
+// atomic: permutations of thread ids or counter values, and the old values
+// returned by fetch_add/fetch_sub.
+
+template <typename T> std::string verify_value_string(T value)
+{
+    if (std::is_signed<T>::value) return std::to_string((long long)value);
+    return std::to_string((unsigned long long)value);
+}
+
+// One bit per value of [0, size).
+class ValueBitmap {
+public:
+    explicit ValueBitmap(size_t size): words((size + 63) / 64), bits(size) {}
+
+    size_t size() const { return bits; }
+
+    bool test(size_t value) const
+    {
+        return (words[value / 64] >> (value % 64)) & 1;
+    }
+
+    // Marks value and returns whether it was marked before.
+    bool test_and_set(size_t value)
+    {
+        uint64_t mask = (uint64_t)1 << (value % 64);
+        bool wasSet = (words[value / 64] & mask) != 0;
+        words[value / 64] |= mask;
+        return wasSet;
+    }
+
+    // Returns the first unmarked value, or size() when all are marked.
+    size_t find_first_clear() const
+    {
+        for (size_t w = 0; w < words.size(); w++)
+        {
+            if (words[w] == ~(uint64_t)0) continue;
+            size_t value = w * 64;
+            while (value < bits && test(value)) value++;
+            if (value < bits) return value;
+        }
+        return bits;
+    }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bits;
+};
+
+// Checks that the values added, taken together, hold every value of
+// [base, base + range) exactly once and, when a special value is given, that
+// value exactly once as well. The special value is matched before the range,
+// so it may lie inside it. Each problem found is logged.
+template <typename T> class PermutationVerifier {
+public:
+    PermutationVerifier(T base, size_t range)
+        : base(base), seen(range), hasSpecial(false), special(0),
+          specialCount(0)
+    {}
+    PermutationVerifier(T base, size_t range, T special)
+        : base(base), seen(range), hasSpecial(true), special(special),
+          specialCount(0)
+    {}
+
+    // Returns false if value is out of range or repeated.
+    bool add(T value)
+    {
+        if (hasSpecial && value == special)
+        {
+            if (++specialCount == 2)
+            {
+                log_error("ERROR: Special value %s occurred more than once\n",
+                          verify_value_string(special).c_str());
+                return false;
+            }
+            return specialCount == 1;
+        }
+        uint64_t offset = (uint64_t)value - (uint64_t)base;
+        if (offset >= seen.size())
+        {
+            log_error("ERROR: Value %s outside of valid range [%s, %s + %zu)\n",
+                      verify_value_string(value).c_str(),
+                      verify_value_string(base).c_str(),
+                      verify_value_string(base).c_str(), seen.size());
+            return false;
+        }
+        if (seen.test_and_set((size_t)offset))
+        {
+            log_error("ERROR: Value %s occurred more than once\n",
+                      verify_value_string(value).c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool add(const T *values, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            if (!add(values[i])) return false;
+        return true;
+    }
+
+    // Returns true if every expected value has been added exactly once.
+    bool complete() const
+    {
+        if (hasSpecial && specialCount != 1)
+        {
+            log_error("ERROR: Special value %s occurred %zu times\n",
+                      verify_value_string(special).c_str(), specialCount);
+            return false;
+        }
+        size_t missing = seen.find_first_clear();
+        if (missing != seen.size())
+        {
+            log_error("ERROR: Value %s never occurred\n",
+                      verify_value_string((T)(base + (T)missing)).c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    T base;
+    ValueBitmap seen;
+    bool hasSpecial;
+    T special;
+    size_t specialCount;
+};
+
+// Checks the old values returned when each thread performed exactly one
+// fetch_add (or fetch_sub) of operands[i] on an atomic that started at start
+// and ended at finalValue. Ordered by distance from start, the old values
+// must be the running sums of the operands in the same order. Operands must
+// be positive; when their total wraps the type the order is ambiguous and
+// nothing is checked.
+template <typename T>
+bool verify_fetch_add_sequence(const T *oldValues, const T *operands,
+                               size_t count, T start, T finalValue,
+                               bool subtract = false)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    U total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((U)operands[i] > (U)~total) return true;
+        total += (U)operands[i];
+    }
+
+    std::vector<U> distance(count);
+    for (size_t i = 0; i < count; i++)
+        distance[i] = subtract ? (U)((U)start - (U)oldValues[i])
+                               : (U)((U)oldValues[i] - (U)start);
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&distance](size_t a, size_t b) {
+        return distance[a] < distance[b];
+    });
+
+    U sum = 0;
+    for (size_t k = 0; k < count; k++)
+    {
+        size_t i = order[k];
+        if (distance[i] != sum)
+        {
+            log_error("ERROR: Thread %zu returned %s, expected an old value "
+                      "of %s\n",
+                      i, verify_value_string(oldValues[i]).c_str(),
+                      verify_value_string((T)(subtract ? (U)start - sum
+                                                       : (U)start + sum))
+                          .c_str());
+            return false;
+        }
+        sum += (U)operands[i];
+    }
+    U finalDistance = subtract ? (U)((U)start - (U)finalValue)
+                               : (U)((U)finalValue - (U)start);
+    if (finalDistance != sum)
+    {
+        log_error("ERROR: Final value %s does not follow the last old value\n",
+                  verify_value_string(finalValue).c_str());
+        return false;
+    }
+    return true;
+}
+
+#endif // VERIFY_HELPERS_H
@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef WORK_GROUP_SWEEP_H
+#define WORK_GROUP_SWEEP_H
+
+#include "errorHelpers.h"
+#include "testHarness.h"
+
+#include <stddef.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Work-group size sweeps: every local size up to a limit, each dispatched
+// over a few global sizes, and a table of the time each dispatch took.
+
+struct WorkGroupSweepConfig
+{
+    size_t global;
+    size_t local;
+};
+
+// Returns whether NDRanges whose global size is not a multiple of the local
+// size may be enqueued; optional from OpenCL 3.0 and absent before 2.0.
+inline bool work_group_sweep_non_uniform(cl_device_id device)
+{
+    Version version = get_device_cl_version(device);
+    if (version < Version(2, 0)) return false;
+    if (version < Version(3, 0)) return true;
+
+    cl_bool supported = CL_FALSE;
+    cl_int error =
+        clGetDeviceInfo(device, CL_DEVICE_NON_UNIFORM_WORK_GROUP_SUPPORT,
+                        sizeof(supported), &supported, NULL);
+    return error == CL_SUCCESS && supported;
+}
+
+// Every local size in [1, max_local], each with one, three and sixteen
+// work-groups. With non_uniform the last of those work-groups is also run
+// half full.
+inline std::vector<WorkGroupSweepConfig>
+work_group_sweep_configs(size_t max_local, bool non_uniform)
+{
+    static const size_t group_counts[] = { 1, 3, 16 };
+    std::vector<WorkGroupSweepConfig> configs;
+    for (size_t local = 1; local <= max_local; local++)
+    {
+        for (size_t groups : group_counts)
+        {
+            configs.push_back({ groups * local, local });
+            if (non_uniform && local > 1)
+                configs.push_back({ (groups - 1) * local + local / 2, local });
+        }
+    }
+    return configs;
+}
+
+// Enqueues kernel over a 1D NDRange on its own, after the work already in
+// queue has completed, and returns the seconds until it finished.
+inline cl_int time_work_group_dispatch(cl_command_queue queue, cl_kernel kernel,
+                                       const WorkGroupSweepConfig &config,
+                                       double *seconds)
+{
+    cl_int error = clFinish(queue);
+    test_error(error, "clFinish failed");
+
+    auto start = std::chrono::steady_clock::now();
+    error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &config.global,
+                                   &config.local, 0, NULL, NULL);
+    test_error(error, "clEnqueueNDRangeKernel failed");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                             - start)
+                   .count();
+    return CL_SUCCESS;
+}
+
+// Collects the dispatch time of each configuration of a sweep and prints
+// them as a table of latency and work-item throughput.
+class WorkGroupSweepTable {
+public:
+    void add(const std::string &name, const WorkGroupSweepConfig &config,
+             double seconds)
+    {
+        rows.push_back({ name, config, seconds });
+    }
+
+    void print() const
+    {
+        if (rows.empty()) return;
+        log_info("%-40s %8s %6s %7s %12s %12s\n", "kernel", "global", "local",
+                 "groups", "latency us", "Mitems/s");
+        for (const Row &row : rows)
+        {
+            size_t groups = (row.config.global + row.config.local - 1)
+                / row.config.local;
+            log_info("%-40s %8zu %6zu %7zu %12.1f %12.2f\n", row.name.c_str(),
+                     row.config.global, row.config.local, groups,
+                     row.seconds * 1e6,
+                     row.seconds > 0 ? row.config.global / row.seconds * 1e-6
+                                     : 0.0);
+        }
+    }
+
+    void clear() { rows.clear(); }
+
+private:
+    struct Row
+    {
+        std::string name;
+        WorkGroupSweepConfig config;
+        double seconds;
+    };
+    std::vector<Row> rows;
+};
+
+#endif // WORK_GROUP_SWEEP_H
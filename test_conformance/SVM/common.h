@@ -38,6 +38,7 @@ typedef enum {
 
 cl_int AtomicLoadExplicit(volatile cl_int * pValue, cl_memory_order order);
 cl_int AtomicFetchAddExplicit(volatile cl_int *object, cl_int operand, cl_memory_order o);
+void AtomicStoreExplicit(volatile cl_int *object, cl_int desired, cl_memory_order mo);
 
 template <typename T>
 bool AtomicCompareExchangeStrongExplicit(volatile T *a, T *expected, T desired,
@@ -63,6 +63,19 @@ cl_int AtomicExchangeExplicit(volatile cl_int *object, cl_int desired, cl_memory
 #endif
 }
 
+// Always seq_cst: the store is ordered with later loads as well, which the
+// exchange above only guarantees on x86.
+void AtomicStoreExplicit(volatile cl_int *object, cl_int desired, cl_memory_order mo)
+{
+#if (defined(_WIN32) || defined(_WIN64)) && defined(_MSC_VER)
+  InterlockedExchange( (volatile LONG*) object, desired);
+#elif defined(__GNUC__)
+  __atomic_store_n(object, desired, __ATOMIC_SEQ_CST);
+#else
+  log_error("ERROR: AtomicStoreExplicit function not implemented\n");
+#endif
+}
+
 
 const char *linked_list_create_and_verify_kernels[] = {
   "typedef struct Node {\n"
@@ -0,0 +1,383 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "common.h"
+#include "harness/mt19937.h"
+#include "harness/ThreadPool.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Every location is an int written only with the value 1, so each register
+// observes either 0 or 1 and an outcome is the bit vector of all registers.
+struct LitmusOp
+{
+    bool store;
+    cl_uint location; // 0 = x, 1 = y
+    cl_uint reg; // destination register for loads
+};
+
+const cl_uint kMaxLitmusThreads = 4;
+const cl_uint kMaxLitmusOps = 2;
+const cl_uint kLitmusLocations = 2;
+
+struct LitmusPattern
+{
+    const char *name;
+    cl_uint threads;
+    cl_uint registers;
+    cl_uint numOps[kMaxLitmusThreads];
+    LitmusOp ops[kMaxLitmusThreads][kMaxLitmusOps];
+    // Outcome forbidden under sequential consistency.
+    cl_uint forbidden;
+};
+
+const LitmusOp S_x = { true, 0, 0 };
+const LitmusOp S_y = { true, 1, 0 };
+inline LitmusOp L(cl_uint location, cl_uint reg)
+{
+    return { false, location, reg };
+}
+
+// clang-format off
+const LitmusPattern litmus_patterns[] = {
+    // Message passing: seeing the flag but not the data is forbidden.
+    { "MP", 2, 2, { 2, 2 },
+      { { S_x, S_y }, { L(1, 0), L(0, 1) } }, 0x1 },
+    // Store buffering: both threads missing the other's store is forbidden.
+    { "SB", 2, 2, { 2, 2 },
+      { { S_x, L(1, 0) }, { S_y, L(0, 1) } }, 0x0 },
+    // Load buffering: both loads seeing the later store is forbidden.
+    { "LB", 2, 2, { 2, 2 },
+      { { L(0, 0), S_y }, { L(1, 1), S_x } }, 0x3 },
+    // Independent reads of independent writes: the two readers disagreeing
+    // on the order of the writes is forbidden.
+    { "IRIW", 4, 4, { 1, 1, 2, 2 },
+      { { S_x }, { S_y }, { L(0, 0), L(1, 1) }, { L(1, 2), L(0, 3) } },
+      0x5 },
+};
+// clang-format on
+
+const size_t kIntsPerLine = 64 / sizeof(cl_int);
+const size_t kMaxInstancesPerRound = 1 << 16;
+const cl_uint kRounds = 16;
+
+std::string litmus_kernel_name(const LitmusPattern &pattern)
+{
+    return std::string("litmus_") + pattern.name;
+}
+
+// One work-item per (instance, role). Only the roles owned by deviceIndex + 1
+// run, the others are left to the host or to another device.
+std::string generate_litmus_kernel(const LitmusPattern &pattern)
+{
+    std::string threads = std::to_string(pattern.threads);
+    std::string regs = std::to_string(pattern.registers);
+    std::string locations = std::to_string(kLitmusLocations);
+
+    std::string src = "__kernel void " + litmus_kernel_name(pattern)
+        + "(volatile __global atomic_int *pool, __global int *regs,\n"
+          "    __global const uint *locs, __global const uchar *owner,\n"
+          "    volatile __global atomic_int *started, uint deviceIndex)\n"
+          "{\n"
+          "    size_t gid = get_global_id(0);\n"
+          "    if (owner[gid] != deviceIndex + 1) return;\n"
+          "    size_t instance = gid / "
+        + threads + ";\n"
+        + "    atomic_fetch_add_explicit(started, 1, memory_order_relaxed,\n"
+          "                              memory_scope_all_svm_devices);\n"
+          "    switch (gid % "
+        + threads + ")\n    {\n";
+    for (cl_uint t = 0; t < pattern.threads; t++)
+    {
+        src += "        case " + std::to_string(t) + ":\n";
+        for (cl_uint i = 0; i < pattern.numOps[t]; i++)
+        {
+            const LitmusOp &op = pattern.ops[t][i];
+            std::string location = "&pool[locs[" + locations + " * instance + "
+                + std::to_string(op.location) + "]]";
+            if (op.store)
+                src += "            atomic_store_explicit(" + location
+                    + ", 1,\n";
+            else
+                src += "            regs[" + regs + " * instance + "
+                    + std::to_string(op.reg) + "] = atomic_load_explicit("
+                    + location + ",\n";
+            src += "                memory_order_seq_cst, "
+                   "memory_scope_all_svm_devices);\n";
+        }
+        src += "            break;\n";
+    }
+    src += "    }\n}\n";
+    return src;
+}
+
+struct LitmusRound
+{
+    const LitmusPattern *pattern;
+    size_t instances;
+    cl_int *pool;
+    cl_int *regs;
+    cl_uint *locs;
+    cl_uchar *owner;
+    cl_uint jobs;
+};
+
+// Host thread job_id runs every host-owned role with
+// (instance + role) % jobs == job_id, so the roles of one instance land on
+// different threads whenever there are enough of them.
+cl_int run_host_roles(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    const LitmusRound &round = *(const LitmusRound *)userInfo;
+    const LitmusPattern &pattern = *round.pattern;
+    for (size_t instance = 0; instance < round.instances; instance++)
+    {
+        for (cl_uint t = 0; t < pattern.threads; t++)
+        {
+            if ((instance + t) % round.jobs != job_id
+                || round.owner[instance * pattern.threads + t] != 0)
+                continue;
+            for (cl_uint i = 0; i < pattern.numOps[t]; i++)
+            {
+                const LitmusOp &op = pattern.ops[t][i];
+                volatile cl_int *location =
+                    &round.pool[round.locs[kLitmusLocations * instance
+                                           + op.location]];
+                if (op.store)
+                    AtomicStoreExplicit(location, 1, memory_order_seq_cst);
+                else
+                    round.regs[pattern.registers * instance + op.reg] =
+                        AtomicLoadExplicit(location, memory_order_seq_cst);
+            }
+        }
+    }
+    return CL_SUCCESS;
+}
+
+// x and y of each instance get a line pair of their own, placed at random in
+// the pool. Half of the instances put y on the same line as x to also cover
+// false sharing. Every instance has at least one host and one device role.
+void randomize_placement(const LitmusPattern &pattern, size_t instances,
+                         cl_uint num_devices, cl_uint *locs, cl_uchar *owner,
+                         MTdata d)
+{
+    std::vector<size_t> lines(2 * instances);
+    for (size_t i = 0; i < lines.size(); i++) lines[i] = i;
+    for (size_t i = lines.size() - 1; i > 0; i--)
+        std::swap(lines[i], lines[genrand_int32(d) % (i + 1)]);
+
+    cl_uint roleMasks = (1u << pattern.threads) - 2;
+    for (size_t instance = 0; instance < instances; instance++)
+    {
+        size_t xOffset = genrand_int32(d) % kIntsPerLine;
+        size_t yLine = lines[2 * instance + 1];
+        size_t yOffset = genrand_int32(d) % kIntsPerLine;
+        if (genrand_int32(d) & 1)
+        {
+            yLine = lines[2 * instance];
+            yOffset = (xOffset + 1 + yOffset % (kIntsPerLine - 1))
+                % kIntsPerLine;
+        }
+        locs[kLitmusLocations * instance] =
+            (cl_uint)(lines[2 * instance] * kIntsPerLine + xOffset);
+        locs[kLitmusLocations * instance + 1] =
+            (cl_uint)(yLine * kIntsPerLine + yOffset);
+
+        cl_uint deviceMask = 1 + genrand_int32(d) % roleMasks;
+        for (cl_uint t = 0; t < pattern.threads; t++)
+            owner[instance * pattern.threads + t] = (deviceMask >> t) & 1
+                ? (cl_uchar)(1 + (instance + t) % num_devices)
+                : 0;
+    }
+}
+
+void log_litmus_histogram(const LitmusPattern &pattern,
+                          const std::vector<size_t> &histogram)
+{
+    log_info("%s outcomes:\n", pattern.name);
+    for (cl_uint outcome = 0; outcome < histogram.size(); outcome++)
+    {
+        std::string label;
+        for (cl_uint r = 0; r < pattern.registers; r++)
+            label += " r" + std::to_string(r) + "="
+                + std::to_string((outcome >> r) & 1);
+        log_info("  %s: %zu%s\n", label.c_str(), histogram[outcome],
+                 outcome == pattern.forbidden ? " (forbidden)" : "");
+    }
+}
+
+int run_litmus_pattern(cl_context context, clCommandQueueWrapper *queues,
+                       cl_uint num_devices, cl_kernel kernel,
+                       const LitmusPattern &pattern, size_t instances,
+                       MTdata d)
+{
+    cl_int err = CL_SUCCESS;
+    size_t poolSize = 2 * instances * kIntsPerLine * sizeof(cl_int);
+    size_t workItems = instances * pattern.threads;
+    size_t regsSize = instances * pattern.registers * sizeof(cl_int);
+
+    cl_int *pool = (cl_int *)clSVMAlloc(
+        context,
+        CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER | CL_MEM_SVM_ATOMICS,
+        poolSize, 64);
+    cl_int *started = (cl_int *)clSVMAlloc(
+        context,
+        CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER | CL_MEM_SVM_ATOMICS,
+        sizeof(cl_int), 0);
+    cl_int *regs = (cl_int *)clSVMAlloc(
+        context, CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER, regsSize,
+        0);
+    cl_uint *locs = (cl_uint *)clSVMAlloc(
+        context, CL_MEM_READ_ONLY | CL_MEM_SVM_FINE_GRAIN_BUFFER,
+        instances * kLitmusLocations * sizeof(cl_uint), 0);
+    cl_uchar *owner = (cl_uchar *)clSVMAlloc(
+        context, CL_MEM_READ_ONLY | CL_MEM_SVM_FINE_GRAIN_BUFFER, workItems,
+        0);
+    if (!pool || !started || !regs || !locs || !owner)
+    {
+        log_error("clSVMAlloc failed for the %s litmus buffers\n",
+                  pattern.name);
+        err = -1;
+    }
+
+    err |= clSetKernelArgSVMPointer(kernel, 0, pool);
+    err |= clSetKernelArgSVMPointer(kernel, 1, regs);
+    err |= clSetKernelArgSVMPointer(kernel, 2, locs);
+    err |= clSetKernelArgSVMPointer(kernel, 3, owner);
+    err |= clSetKernelArgSVMPointer(kernel, 4, started);
+
+    LitmusRound round = { &pattern, instances, pool, regs, locs, owner,
+                          std::max(GetThreadCount(), 1u) };
+    std::vector<size_t> histogram(1u << pattern.registers, 0);
+    size_t invalid = 0;
+
+    for (cl_uint r = 0; r < kRounds && err == CL_SUCCESS; r++)
+    {
+        memset(pool, 0, poolSize);
+        memset(regs, 0xff, regsSize);
+        *started = 0;
+        randomize_placement(pattern, instances, num_devices, locs, owner, d);
+
+        std::vector<clEventWrapper> events(num_devices);
+        for (cl_uint dev = 0; dev < num_devices && err == CL_SUCCESS; dev++)
+        {
+            err = clSetKernelArg(kernel, 5, sizeof(cl_uint), &dev);
+            err |= clEnqueueNDRangeKernel(queues[dev], kernel, 1, NULL,
+                                          &workItems, NULL, 0, NULL,
+                                          &events[dev]);
+        }
+        if (err != CL_SUCCESS) break;
+        for (cl_uint dev = 0; dev < num_devices; dev++) clFlush(queues[dev]);
+
+        // Wait for some device activity so the host roles race with it,
+        // without spinning forever if the kernels already completed.
+        cl_int status = CL_QUEUED;
+        while (AtomicLoadExplicit(started, memory_order_relaxed) == 0
+               && status != CL_COMPLETE && status >= 0)
+            clGetEventInfo(events[0], CL_EVENT_COMMAND_EXECUTION_STATUS,
+                           sizeof(status), &status, NULL);
+
+        err = ThreadPool_Do(run_host_roles, round.jobs, &round);
+        for (cl_uint dev = 0; dev < num_devices; dev++)
+            err |= clFinish(queues[dev]);
+        if (err != CL_SUCCESS) break;
+
+        for (size_t instance = 0; instance < instances; instance++)
+        {
+            cl_uint outcome = 0;
+            bool valid = true;
+            for (cl_uint reg = 0; reg < pattern.registers; reg++)
+            {
+                cl_int value = regs[pattern.registers * instance + reg];
+                valid &= value == 0 || value == 1;
+                outcome |= (cl_uint)(value & 1) << reg;
+            }
+            if (valid)
+                histogram[outcome]++;
+            else if (invalid++ == 0)
+                log_error("%s instance %zu read a value other than 0 or 1\n",
+                          pattern.name, instance);
+        }
+    }
+
+    clSVMFree(context, pool);
+    clSVMFree(context, started);
+    clSVMFree(context, regs);
+    clSVMFree(context, locs);
+    clSVMFree(context, owner);
+    test_error(err, "Failed to run the litmus kernels");
+
+    log_litmus_histogram(pattern, histogram);
+    if (invalid != 0 || histogram[pattern.forbidden] != 0)
+    {
+        log_error("%s: %zu forbidden and %zu invalid outcomes out of %zu\n",
+                  pattern.name, histogram[pattern.forbidden], invalid,
+                  instances * kRounds);
+        return -1;
+    }
+    return 0;
+}
+
+} // namespace
+
+// Litmus tests for fine-grain SVM: the message passing, store buffering, load
+// buffering and IRIW patterns run between host threads and device work-items
+// with every access seq_cst at memory_scope_all_svm_devices. Each round places
+// the locations and the host/device split of the roles at random, and the
+// observed outcomes are histogrammed. Any outcome forbidden under sequential
+// consistency fails the test.
+REGISTER_TEST(svm_fine_grain_litmus)
+{
+    clContextWrapper contextWrapper;
+    clProgramWrapper program;
+    clCommandQueueWrapper queues[MAXQ];
+    cl_uint num_devices = 0;
+    cl_int err = CL_SUCCESS;
+
+    std::string source;
+    for (const LitmusPattern &pattern : litmus_patterns)
+        source += generate_litmus_kernel(pattern);
+    const char *sources[] = { source.c_str() };
+
+    err = create_cl_objects(
+        device, &sources[0], &contextWrapper, &program, &queues[0],
+        &num_devices, CL_DEVICE_SVM_FINE_GRAIN_BUFFER | CL_DEVICE_SVM_ATOMICS);
+    context = contextWrapper;
+    if (err == 1)
+        return 0; // no devices capable of requested SVM level, so don't execute
+                  // but count test as passing.
+    if (err < 0) return -1; // fail test.
+
+    size_t instances =
+        std::min((size_t)std::max(num_elements, 1), kMaxInstancesPerRound);
+    MTdataHolder d(gRandomSeed);
+
+    int result = 0;
+    for (const LitmusPattern &pattern : litmus_patterns)
+    {
+        clKernelWrapper kernel = clCreateKernel(
+            program, litmus_kernel_name(pattern).c_str(), &err);
+        test_error(err, "clCreateKernel failed");
+
+        if (run_litmus_pattern(context, queues, num_devices, kernel,
+                               pattern, instances, d)
+            != 0)
+            result = -1;
+    }
+    return result;
+}
@@ -15,6 +15,7 @@
 //
 #include "harness/conversions.h"
 #include "harness/typeWrappers.h"
+#include "harness/verifyHelpers.h"
 
 #include <cinttypes>
 #include <vector>
@@ -609,6 +610,27 @@ cl_long test_atomic_sub_result_long(size_t size, cl_long *startRefValues,
     return total;
 }
 
+bool test_atomic_sub_verify_int(size_t size, cl_int *refValues,
+                                cl_int finalValue)
+{
+    /* Every thread subtracted once and kept the old value, so ordered from
+     * the starting value down the old values step by the operands */
+    std::vector<cl_int> operands(size);
+    for (size_t i = 0; i < size; i++) operands[i] = (cl_int)i + 3;
+    return verify_fetch_add_sequence<cl_int>(refValues, operands.data(), size,
+                                             INT_TEST_VALUE, finalValue, true);
+}
+
+bool test_atomic_sub_verify_long(size_t size, cl_long *refValues,
+                                 cl_long finalValue)
+{
+    std::vector<cl_long> operands(size);
+    for (size_t i = 0; i < size; i++) operands[i] = (cl_long)i + 3;
+    return verify_fetch_add_sequence<cl_long>(refValues, operands.data(), size,
+                                              LONG_TEST_VALUE, finalValue,
+                                              true);
+}
+
 REGISTER_TEST(atomic_sub)
 {
     TestFns set = { INT_TEST_VALUE,
@@ -616,10 +638,10 @@ REGISTER_TEST(atomic_sub)
                     NULL,
                     test_atomic_sub_result_int,
                     NULL,
-                    NULL,
+                    test_atomic_sub_verify_int,
                     test_atomic_sub_result_long,
                     NULL,
-                    NULL };
+                    test_atomic_sub_verify_long };
 
     if (test_atomic_function_set(
             device, context, queue, num_elements, atom_sub_core, set, false,
@@ -647,193 +669,44 @@ const char atomic_xchg_float_core[] =
 bool test_atomic_xchg_verify_int(size_t size, cl_int *refValues,
                                  cl_int finalValue)
 {
-    /* For xchg, each value from 0 to size - 1 should have an entry in the ref
-     * array, and ONLY one entry */
-    std::vector<char> valids(sizeof(char) * size);
-    size_t i;
-    char originalValidCount = 0;
-
-    memset(valids.data(), 0, sizeof(char) * size);
-
-    for (i = 0; i < size; i++)
-    {
-        if (refValues[i] == INT_TEST_VALUE)
-        {
-            // Special initial value
-            originalValidCount++;
-            continue;
-        }
-        if (refValues[i] < 0 || (size_t)refValues[i] >= size)
-        {
-            log_error(
-                "ERROR: Reference value %zu outside of valid range! (%d)\n", i,
-                refValues[i]);
-            return false;
-        }
-        valids[refValues[i]]++;
-    }
-
-    /* Note: ONE entry will have zero count. It'll be the last one that
-     executed, because that value should be the final value outputted */
-    if (valids[finalValue] > 0)
-    {
-        log_error("ERROR: Final value %d was also in ref list!\n", finalValue);
-        return false;
-    }
-    else
-        valids[finalValue] = 1; // So the following loop will be okay
-
-    /* Now check that every entry has one and only one count */
-    if (originalValidCount != 1)
-    {
-        log_error("ERROR: Starting reference value %d did not occur "
-                  "once-and-only-once (occurred %d)\n",
-                  65191, originalValidCount);
-        return false;
-    }
-    for (i = 0; i < size; i++)
-    {
-        if (valids[i] != 1)
-        {
-            log_error("ERROR: Reference value %zu did not occur "
-                      "once-and-only-once (occurred %d)\n",
-                      i, valids[i]);
-            for (size_t j = 0; j < size; j++)
-                log_info("%d: %d\n", (int)j, (int)valids[j]);
-            return false;
-        }
-    }
-
-    return true;
+    /* For xchg, the ref values and the final value together hold each value
+     * from 0 to size - 1 once, plus the starting value once */
+    PermutationVerifier<cl_int> verifier(0, size, INT_TEST_VALUE);
+    return verifier.add(refValues, size) && verifier.add(finalValue)
+        && verifier.complete();
 }
 
 bool test_atomic_xchg_verify_long(size_t size, cl_long *refValues,
                                   cl_long finalValue)
 {
-    /* For xchg, each value from 0 to size - 1 should have an entry in the ref
-     * array, and ONLY one entry */
-    std::vector<char> valids(sizeof(char) * size);
-    size_t i;
-    char originalValidCount = 0;
-
-    memset(valids.data(), 0, sizeof(char) * size);
-
-    for (i = 0; i < size; i++)
-    {
-        if (refValues[i] == LONG_TEST_VALUE)
-        {
-            // Special initial value
-            originalValidCount++;
-            continue;
-        }
-        if (refValues[i] < 0 || (size_t)refValues[i] >= size)
-        {
-            log_error(
-                "ERROR: Reference value %zu outside of valid range! (%" PRId64
-                ")\n",
-                i, refValues[i]);
-            return false;
-        }
-        valids[refValues[i]]++;
-    }
-
-    /* Note: ONE entry will have zero count. It'll be the last one that
-     executed, because that value should be the final value outputted */
-    if (valids[finalValue] > 0)
-    {
-        log_error("ERROR: Final value %" PRId64 " was also in ref list!\n",
-                  finalValue);
-        return false;
-    }
-    else
-        valids[finalValue] = 1; // So the following loop will be okay
+    PermutationVerifier<cl_long> verifier(0, size, LONG_TEST_VALUE);
+    return verifier.add(refValues, size) && verifier.add(finalValue)
+        && verifier.complete();
+}
 
-    /* Now check that every entry has one and only one count */
-    if (originalValidCount != 1)
+static bool xchg_add_float(PermutationVerifier<cl_int> &verifier,
+                           cl_float value)
+{
+    cl_int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // The starting value is stored as the bits of INT_TEST_VALUE
+    if (bits == INT_TEST_VALUE) return verifier.add(INT_TEST_VALUE);
+    if (!(value >= 0 && value < (cl_float)CL_INT_MAX)
+        || (cl_float)(cl_int)value != value)
     {
-        log_error("ERROR: Starting reference value %d did not occur "
-                  "once-and-only-once (occurred %d)\n",
-                  65191, originalValidCount);
+        log_error("ERROR: Reference value %a is not a thread id\n", value);
         return false;
     }
-    for (i = 0; i < size; i++)
-    {
-        if (valids[i] != 1)
-        {
-            log_error("ERROR: Reference value %zu did not occur "
-                      "once-and-only-once (occurred %d)\n",
-                      i, valids[i]);
-            for (size_t j = 0; j < size; j++)
-                log_info("%d: %d\n", (int)j, (int)valids[j]);
-            return false;
-        }
-    }
-
-    return true;
+    return verifier.add((cl_int)value);
 }
 
 bool test_atomic_xchg_verify_float(size_t size, cl_float *refValues,
                                    cl_float finalValue)
 {
-    /* For xchg, each value from 0 to size - 1 should have an entry in the ref
-     * array, and ONLY one entry */
-    std::vector<char> valids(sizeof(char) * size);
-    size_t i;
-    char originalValidCount = 0;
-
-    memset(valids.data(), 0, sizeof(char) * size);
-
-    for (i = 0; i < size; i++)
-    {
-        cl_int *intRefValue = (cl_int *)(&refValues[i]);
-        if (*intRefValue == INT_TEST_VALUE)
-        {
-            // Special initial value
-            originalValidCount++;
-            continue;
-        }
-        if (refValues[i] < 0 || (size_t)refValues[i] >= size)
-        {
-            log_error(
-                "ERROR: Reference value %zu outside of valid range! (%a)\n", i,
-                refValues[i]);
-            return false;
-        }
-        valids[(int)refValues[i]]++;
-    }
-
-    /* Note: ONE entry will have zero count. It'll be the last one that
-     executed, because that value should be the final value outputted */
-    if (valids[(int)finalValue] > 0)
-    {
-        log_error("ERROR: Final value %a was also in ref list!\n", finalValue);
-        return false;
-    }
-    else
-        valids[(int)finalValue] = 1; // So the following loop will be okay
-
-    /* Now check that every entry has one and only one count */
-    if (originalValidCount != 1)
-    {
-        log_error("ERROR: Starting reference value %d did not occur "
-                  "once-and-only-once (occurred %d)\n",
-                  65191, originalValidCount);
-        return false;
-    }
-    for (i = 0; i < size; i++)
-    {
-        if (valids[i] != 1)
-        {
-            log_error("ERROR: Reference value %zu did not occur "
-                      "once-and-only-once (occurred %d)\n",
-                      i, valids[i]);
-            for (size_t j = 0; j < size; j++)
-                log_info("%d: %d\n", (int)j, (int)valids[j]);
-            return false;
-        }
-    }
-
-    return true;
+    PermutationVerifier<cl_int> verifier(0, size, INT_TEST_VALUE);
+    for (size_t i = 0; i < size; i++)
+        if (!xchg_add_float(verifier, refValues[i])) return false;
+    return xchg_add_float(verifier, finalValue) && verifier.complete();
 }
 
 REGISTER_TEST(atomic_xchg)
@@ -1031,6 +904,21 @@ cl_long test_atomic_inc_result_long(size_t size, cl_long *startRefValues,
     return LONG_TEST_VALUE + size;
 }
 
+bool test_atomic_inc_verify_int(size_t size, cl_int *refValues,
+                                cl_int finalValue)
+{
+    /* Each thread got its own old value, counting up from the start value */
+    PermutationVerifier<cl_int> verifier(INT_TEST_VALUE, size);
+    return verifier.add(refValues, size) && verifier.complete();
+}
+
+bool test_atomic_inc_verify_long(size_t size, cl_long *refValues,
+                                 cl_long finalValue)
+{
+    PermutationVerifier<cl_long> verifier(LONG_TEST_VALUE, size);
+    return verifier.add(refValues, size) && verifier.complete();
+}
+
 REGISTER_TEST(atomic_inc)
 {
     TestFns set = { INT_TEST_VALUE,
@@ -1038,10 +926,10 @@ REGISTER_TEST(atomic_inc)
                     NULL,
                     test_atomic_inc_result_int,
                     NULL,
-                    NULL,
+                    test_atomic_inc_verify_int,
                     test_atomic_inc_result_long,
                     NULL,
-                    NULL };
+                    test_atomic_inc_verify_long };
 
     if (test_atomic_function_set(
             device, context, queue, num_elements, atom_inc_core, set, false,
@@ -1077,6 +965,23 @@ cl_long test_atomic_dec_result_long(size_t size, cl_long *startRefValues,
     return LONG_TEST_VALUE - size;
 }
 
+bool test_atomic_dec_verify_int(size_t size, cl_int *refValues,
+                                cl_int finalValue)
+{
+    /* Each thread got its own old value, counting down from the start value */
+    PermutationVerifier<cl_int> verifier(INT_TEST_VALUE - (cl_int)size + 1,
+                                         size);
+    return verifier.add(refValues, size) && verifier.complete();
+}
+
+bool test_atomic_dec_verify_long(size_t size, cl_long *refValues,
+                                 cl_long finalValue)
+{
+    PermutationVerifier<cl_long> verifier(
+        LONG_TEST_VALUE - (cl_long)size + 1, size);
+    return verifier.add(refValues, size) && verifier.complete();
+}
+
 REGISTER_TEST(atomic_dec)
 {
     TestFns set = { INT_TEST_VALUE,
@@ -1084,10 +989,10 @@ REGISTER_TEST(atomic_dec)
                     NULL,
                     test_atomic_dec_result_int,
                     NULL,
-                    NULL,
+                    test_atomic_dec_verify_int,
                     test_atomic_dec_result_long,
                     NULL,
-                    NULL };
+                    test_atomic_dec_verify_long };
 
     if (test_atomic_function_set(
             device, context, queue, num_elements, atom_dec_core, set, false,
@@ -18,6 +18,7 @@
 
 #include "harness/conversions.h"
 #include "harness/typeWrappers.h"
+#include "harness/verifyHelpers.h"
 
 // clang-format off
 const char *atomic_index_source =
@@ -141,24 +142,15 @@ REGISTER_TEST(atomic_add_index)
                     }
                     else
                     {
-                        unsigned int looking_for, index;
-                        for (looking_for = 0; looking_for < numGlobalThreads;
-                             looking_for++)
+                        // Every thread id must occur exactly once
+                        PermutationVerifier<cl_int> verifier(0,
+                                                             numGlobalThreads);
+                        if (!verifier.add(values, numGlobalThreads)
+                            || !verifier.complete())
                         {
-                            int instances_found = 0;
-                            for (index = 0; index < numGlobalThreads; index++)
-                            {
-                                if (values[index] == (int)looking_for)
-                                    instances_found++;
-                            }
-                            if (instances_found != 1)
-                            {
-                                log_error(
-                                    "add_index_test FAILED: wrong number of "
-                                    "instances (%d!=1) for counter %d.\n",
-                                    instances_found, looking_for);
-                                fail = 1;
-                            }
+                            log_error("add_index_test FAILED: thread ids are "
+                                      "not a permutation of the indices.\n");
+                            fail = 1;
                         }
                     }
                 }
@@ -436,26 +428,39 @@ int add_index_bin_test(size_t *global_threads, cl_command_queue queue,
             }
         }
     }
-    // Now verify that the correct ones are in each bin
-    int index;
-    for (index = 0; index < number_of_items; index++)
+    // Now verify that the correct ones are in each bin, and that every item
+    // was placed exactly once
+    ValueBitmap placed(number_of_items);
+    for (current_bin = 0; current_bin < number_of_bins; current_bin++)
     {
-        int expected_bin = l_bin_assignments[index];
-        int found_it = 0;
-        for (search = 0; search < l_bin_counts[expected_bin]; search++)
+        for (search = 0; search < l_bin_counts[current_bin]; search++)
         {
-            if (final_bin_assignments[expected_bin * max_counts_per_bin
-                                      + search]
-                == index)
+            int index = final_bin_assignments[current_bin * max_counts_per_bin
+                                              + search];
+            if (index < 0 || index >= number_of_items) continue;
+            if (l_bin_assignments[index] != current_bin)
             {
-                found_it = 1;
+                log_error("add_index_bin_test FAILED: item %d found in bin %d "
+                          "instead of bin %d.\n",
+                          index, current_bin, l_bin_assignments[index]);
+                errors++;
+            }
+            else if (placed.test_and_set(index))
+            {
+                log_error("add_index_bin_test FAILED: item %d found more than "
+                          "once in bin %d.\n",
+                          index, current_bin);
+                errors++;
             }
         }
-        if (found_it == 0)
+    }
+    for (int index = 0; index < number_of_items; index++)
+    {
+        if (!placed.test(index))
         {
             log_error(
                 "add_index_bin_test FAILED: did not find item %d in bin %d.\n",
-                index, expected_bin);
+                index, l_bin_assignments[index]);
             errors++;
         }
     }
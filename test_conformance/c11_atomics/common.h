@@ -22,6 +22,7 @@
 
 #include "host_atomics.h"
 
+#include <map>
 #include <vector>
 #include <sstream>
 
@@ -69,6 +70,8 @@ extern int gInternalIterations; // internal test iterations for atomic
                                 // operation, sufficient to verify atomicity
 extern int
     gMaxDeviceThreads; // maximum number of threads executed on OCL device
+extern bool gBenchmark; // time device atomic throughput
+extern const char *gBenchmarkCsv; // file receiving benchmark results as CSV
 extern cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 
@@ -149,7 +152,7 @@ public:
           _declaredInProgram(false), _usedInFunction(false),
           _genericAddrSpace(false), _oldValueCheck(true),
           _localRefValues(false), _maxGroupSize(0), _passCount(0),
-          _iterations(gInternalIterations)
+          _iterations(gInternalIterations), _collectingBatch(false)
     {}
     virtual ~CBasicTest()
     {
@@ -184,6 +187,18 @@ public:
     virtual std::string FunctionCode();
     virtual std::string KernelCode(cl_uint maxNumDestItems);
     virtual std::string ProgramCore() = 0;
+    std::string KernelName() { return "test_atomic_kernel" + _batchSuffix; }
+    std::string FunctionName()
+    {
+        return "test_atomic_function" + _batchSuffix;
+    }
+    // With ProfileKernel() the test kernel is enqueued with an event and
+    // KernelProfiled() receives its execution time once the results verify;
+    // the queue must have profiling enabled
+    virtual bool ProfileKernel() { return false; }
+    virtual void KernelProfiled(cl_uint deviceThreadCount,
+                                cl_ulong nanoseconds)
+    {}
     virtual std::string SingleTestName()
     {
         std::string testName = LocalMemory() ? "local" : "global";
@@ -204,6 +219,11 @@ public:
     }
     virtual int ExecuteSingleTest(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue);
+    void AddToProgramBatch(cl_uint numDestItems);
+    std::string BatchedKernelName(cl_uint numDestItems);
+    void BuildProgramBatch(cl_device_id deviceID, cl_context context,
+                           cl_command_queue queue);
+    bool CollectingProgramBatch() { return _collectingBatch; }
     int ExecuteForEachPointerType(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue)
     {
@@ -294,6 +314,7 @@ public:
             _maxDeviceThreads = 0;
         }
         if (_maxDeviceThreads + MaxHostThreads() == 0) return 0;
+        BuildProgramBatch(deviceID, context, queue);
         return ExecuteForEachParameterSet(deviceID, context, queue);
     }
     virtual void HostFunction(cl_uint tid, cl_uint threadCount,
@@ -460,6 +481,13 @@ private:
     cl_uint _currentGroupSize;
     cl_uint _passCount;
     const cl_int _iterations;
+    // Kernels of all parameter sets built together as one program, keyed by
+    // the source each parameter set would otherwise build on its own
+    bool _collectingBatch;
+    std::string _batchSuffix;
+    std::string _batchSource;
+    std::map<std::string, std::string> _batchKernels;
+    clProgramWrapper _batchProgram;
 };
 
 template <typename HostAtomicType, typename HostDataType>
@@ -896,8 +924,8 @@ std::string CBasicTest<HostAtomicType, HostDataType>::FunctionCode()
 {
     if (!UsedInFunction()) return "";
     std::string addressSpace = LocalMemory() ? "__local " : "__global ";
-    std::string code = "void test_atomic_function(uint tid, uint threadCount, "
-                       "uint numDestItems, volatile ";
+    std::string code = "void " + FunctionName()
+        + "(uint tid, uint threadCount, uint numDestItems, volatile ";
     if (!GenericAddrSpace()) code += addressSpace;
     code += std::string(DataType().AtomicTypeName()) + " *destMemory, __global "
         + DataType().RegularTypeName() + " *oldValues";
@@ -919,8 +947,8 @@ CBasicTest<HostAtomicType, HostDataType>::KernelCode(cl_uint maxNumDestItems)
     std::string aTypeName = DataType().AtomicTypeName();
     std::string cTypeName = DataType().RegularTypeName();
     std::string addressSpace = LocalMemory() ? "__local " : "__global ";
-    std::string code = "__kernel void test_atomic_kernel(uint threadCount, "
-                       "uint numDestItems, ";
+    std::string code = "__kernel void " + KernelName()
+        + "(uint threadCount, uint numDestItems, ";
 
     // prepare list of arguments for kernel
     if (LocalMemory())
@@ -1007,8 +1035,8 @@ CBasicTest<HostAtomicType, HostDataType>::KernelCode(cl_uint maxNumDestItems)
                 "\n";
     }
     if (UsedInFunction())
-        code += std::string("  test_atomic_function(tid, threadCount, "
-                            "numDestItems, destMemory, oldValues")
+        code += "  " + FunctionName()
+            + "(tid, threadCount, numDestItems, destMemory, oldValues"
             + (LocalRefValues() ? ", localValues" : "") + ");\n";
     else
         code += ProgramCore();
@@ -1089,6 +1117,68 @@ CBasicTest<HostAtomicType, HostDataType>::KernelCode(cl_uint maxNumDestItems)
     return code;
 }
 
+template <typename HostAtomicType, typename HostDataType>
+void CBasicTest<HostAtomicType, HostDataType>::AddToProgramBatch(
+    cl_uint numDestItems)
+{
+    // program scope declarations and macros would collide with those of other
+    // parameter sets, such programs are built on their own
+    if (!ProgramHeader(numDestItems).empty()) return;
+    std::string key = FunctionCode() + KernelCode(numDestItems);
+    if (_batchKernels.count(key)) return;
+
+    std::stringstream ss;
+    ss << "_" << _batchKernels.size();
+    _batchSuffix = ss.str();
+    _batchSource += FunctionCode() + KernelCode(numDestItems);
+    _batchKernels[key] = KernelName();
+    _batchSuffix = "";
+}
+
+template <typename HostAtomicType, typename HostDataType>
+std::string CBasicTest<HostAtomicType, HostDataType>::BatchedKernelName(
+    cl_uint numDestItems)
+{
+    if (!_batchProgram || !ProgramHeader(numDestItems).empty()) return "";
+    typename std::map<std::string, std::string>::iterator it =
+        _batchKernels.find(FunctionCode() + KernelCode(numDestItems));
+    return it == _batchKernels.end() ? "" : it->second;
+}
+
+template <typename HostAtomicType, typename HostDataType>
+void CBasicTest<HostAtomicType, HostDataType>::BuildProgramBatch(
+    cl_device_id deviceID, cl_context context, cl_command_queue queue)
+{
+    _batchProgram.reset();
+    _batchKernels.clear();
+    _batchSource.clear();
+    if (_maxDeviceThreads == 0) return;
+
+    // walk all parameter sets without running them to collect their kernels
+    _collectingBatch = true;
+    ExecuteForEachParameterSet(deviceID, context, queue);
+    _collectingBatch = false;
+
+    if (_batchKernels.size() > 1)
+    {
+        std::string programSource = PragmaHeader(deviceID) + _batchSource;
+        const char *programLine = programSource.c_str();
+        clKernelWrapper kernel;
+        if (create_single_kernel_helper_with_build_options(
+                context, &_batchProgram, &kernel, 1, &programLine,
+                _batchKernels.begin()->second.c_str(),
+                gOldAPI ? "" : nullptr))
+        {
+            log_info("\t%s: batched program build failed, building each "
+                     "parameter set separately\n",
+                     DataType().AtomicTypeName());
+            _batchProgram.reset();
+        }
+    }
+    if (!_batchProgram) _batchKernels.clear();
+    _batchSource.clear();
+}
+
 template <typename HostAtomicType, typename HostDataType>
 int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
     cl_device_id deviceID, cl_context context, cl_command_queue queue)
@@ -1098,6 +1188,7 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
     clKernelWrapper kernel;
     size_t threadNum[1];
     clMemWrapper streams[2];
+    clEventWrapper kernelEvent;
     std::vector<HostAtomicType> destItems;
     HostAtomicType *svmAtomicBuffer = 0;
     std::vector<HostDataType> refValues, startRefValues;
@@ -1115,17 +1206,17 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
 
     // log_info("\t%s %s%s...\n", local ? "local" : "global",
     // DataType().AtomicTypeName(), memoryOrderScope.c_str());
-    log_info("\t%s...\n", SingleTestName().c_str());
+    if (!_collectingBatch) log_info("\t%s...\n", SingleTestName().c_str());
 
     if (!LocalMemory() && DeclaredInProgram()
         && gNoGlobalVariables) // no support for program scope global variables
     {
-        log_info("\t\tTest disabled\n");
+        if (!_collectingBatch) log_info("\t\tTest disabled\n");
         return 0;
     }
     if (UsedInFunction() && GenericAddrSpace() && gNoGenericAddressSpace)
     {
-        log_info("\t\tTest disabled\n");
+        if (!_collectingBatch) log_info("\t\tTest disabled\n");
         return 0;
     }
     if (!LocalMemory() && DeclaredInProgram())
@@ -1133,7 +1224,7 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         if (((gAtomicMemCap & CL_DEVICE_ATOMIC_SCOPE_DEVICE) == 0)
             || ((gAtomicMemCap & CL_DEVICE_ATOMIC_ORDER_ACQ_REL) == 0))
         {
-            log_info("\t\tTest disabled\n");
+            if (!_collectingBatch) log_info("\t\tTest disabled\n");
             return 0;
         }
     }
@@ -1157,6 +1248,12 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
     // in program)
     cl_uint numDestItems = NumResults(threadCount, deviceID);
 
+    if (_collectingBatch)
+    {
+        if (deviceThreadCount > 0) AddToProgramBatch(numDestItems);
+        return 0;
+    }
+
     if (deviceThreadCount > 0)
     {
         // This loop iteratively reduces the workgroup size by 2 and then
@@ -1169,14 +1266,21 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         while ((CurrentGroupSize() > 1))
         {
             // Re-generate the kernel code with the current group size
-            if (kernel) clReleaseKernel(kernel);
-            if (program) clReleaseProgram(program);
+            kernel.reset();
+            program.reset();
             programSource = PragmaHeader(deviceID) + ProgramHeader(numDestItems)
                 + FunctionCode() + KernelCode(numDestItems);
             programLine = programSource.c_str();
-            if (create_single_kernel_helper_with_build_options(
-                    context, &program, &kernel, 1, &programLine,
-                    "test_atomic_kernel", gOldAPI ? "" : nullptr))
+            std::string batchedKernelName = BatchedKernelName(numDestItems);
+            if (!batchedKernelName.empty())
+            {
+                kernel = clCreateKernel(_batchProgram,
+                                        batchedKernelName.c_str(), &error);
+                test_error(error, "Unable to create batched kernel");
+            }
+            else if (create_single_kernel_helper_with_build_options(
+                         context, &program, &kernel, 1, &programLine,
+                         KernelName().c_str(), gOldAPI ? "" : nullptr))
             {
                 return -1;
             }
@@ -1387,7 +1491,8 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         threadNum[0] = deviceThreadCount;
         groupSize = CurrentGroupSize();
         error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, threadNum,
-                                       &groupSize, 0, NULL, NULL);
+                                       &groupSize, 0, NULL,
+                                       ProfileKernel() ? &kernelEvent : NULL);
         test_error(error, "Unable to execute test kernel");
         /* start device threads */
         error = clFlush(queue);
@@ -1548,6 +1653,17 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
             return -1;
         }
     }
+    if (ProfileKernel() && deviceThreadCount > 0)
+    {
+        cl_ulong start, end;
+        error = clGetEventProfilingInfo(kernelEvent, CL_PROFILING_COMMAND_START,
+                                        sizeof(start), &start, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        error = clGetEventProfilingInfo(kernelEvent, CL_PROFILING_COMMAND_END,
+                                        sizeof(end), &end, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        KernelProfiled(deviceThreadCount, end - start);
+    }
     if (UseSVM())
     {
         // the buffer object must first be released before the SVM buffer is
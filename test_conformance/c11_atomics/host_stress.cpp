@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "host_stress.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+struct StressState
+{
+    cl_uint threadCount;
+    bool pinThreads;
+    THostStressFunction function;
+    void *userInfo;
+    std::atomic<cl_uint> ready;
+    std::atomic<bool> go;
+};
+
+void pin_current_thread(cl_uint cpu)
+{
+    cl_uint cpuCount = std::thread::hardware_concurrency();
+    if (cpuCount == 0) return;
+    cpu %= cpuCount;
+#if defined(_WIN32)
+    if (cpu < sizeof(DWORD_PTR) * 8)
+        SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+void stress_thread(StressState *state, cl_uint tid)
+{
+    if (state->pinThreads) pin_current_thread(tid);
+    state->ready.fetch_add(1);
+    while (!state->go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+    state->function(tid, state->userInfo);
+}
+
+}
+
+double host_stress_run(cl_uint threadCount, bool pinThreads,
+                       THostStressFunction function, void *userInfo)
+{
+    StressState state;
+    state.threadCount = threadCount;
+    state.pinThreads = pinThreads;
+    state.function = function;
+    state.userInfo = userInfo;
+    state.ready = 0;
+    state.go = false;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (cl_uint tid = 0; tid < threadCount; tid++)
+        threads.emplace_back(stress_thread, &state, tid);
+
+    while (state.ready.load() != threadCount) std::this_thread::yield();
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    state.go.store(true, std::memory_order_release);
+    for (std::thread &thread : threads) thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                         - start)
+        .count();
+}
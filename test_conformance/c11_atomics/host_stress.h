@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HOST_STRESS_H_
+#define HOST_STRESS_H_
+
+#include "host_atomics.h"
+
+#include <vector>
+
+// Distance between contended variables; two lines apart so that adjacent line
+// prefetch doesn't couple the per-thread variables.
+#define HOST_STRESS_LINE_SIZE 128
+
+typedef struct
+{
+    cl_uint threadCount;
+    cl_uint iterations; // operations per thread
+    cl_uint sharedPercent; // operations on the shared line, the rest go to a
+                           // line owned by the thread
+    bool pinThreads;
+    bool useCompareExchange; // CAS loop increment instead of fetch_add
+} THostStressConfig;
+
+typedef struct
+{
+    double seconds;
+    cl_ulong operations;
+    cl_ulong retries; // failed compare-exchange attempts
+} THostStressResult;
+
+typedef void (*THostStressFunction)(cl_uint tid, void *userInfo);
+
+// Runs function on threadCount new threads, optionally pinned to CPUs, and
+// releases them together from a start barrier. Returns the seconds from the
+// release until the last thread finished.
+double host_stress_run(cl_uint threadCount, bool pinThreads,
+                       THostStressFunction function, void *userInfo);
+
+// Bytes needed by host_stress_increment for threadCount threads: the shared
+// line followed by one line per thread.
+inline size_t host_stress_memory_size(cl_uint threadCount)
+{
+    return (size_t)(threadCount + 1) * HOST_STRESS_LINE_SIZE;
+}
+
+template <typename HostAtomicType, typename HostDataType>
+class CHostStressIncrement {
+public:
+    static void ThreadFunction(cl_uint tid, void *userInfo)
+    {
+        ((CHostStressIncrement *)userInfo)->Run(tid);
+    }
+    CHostStressIncrement(const THostStressConfig &config, void *memory)
+        : _config(config), _memory((char *)memory),
+          _retries(config.threadCount * HOST_STRESS_RETRY_STRIDE, 0)
+    {}
+    volatile HostAtomicType *Line(cl_uint line)
+    {
+        return (volatile HostAtomicType *)(_memory
+                                           + line * HOST_STRESS_LINE_SIZE);
+    }
+    bool IsShared(cl_uint i) { return i % 100 < _config.sharedPercent; }
+    void Run(cl_uint tid)
+    {
+        volatile HostAtomicType *own = Line(tid + 1);
+        cl_ulong retries = 0;
+        for (cl_uint i = 0; i < _config.iterations; i++)
+        {
+            volatile HostAtomicType *target = IsShared(i) ? Line(0) : own;
+            if (!_config.useCompareExchange)
+            {
+                host_atomic_fetch_add(target, (HostDataType)1,
+                                      MEMORY_ORDER_SEQ_CST);
+                continue;
+            }
+            HostDataType expected = host_atomic_load<HostAtomicType,
+                                                     HostDataType>(
+                target, MEMORY_ORDER_RELAXED);
+            while (!host_atomic_compare_exchange(
+                target, &expected, (HostDataType)(expected + 1),
+                MEMORY_ORDER_SEQ_CST, MEMORY_ORDER_RELAXED))
+                retries++;
+        }
+        _retries[tid * HOST_STRESS_RETRY_STRIDE] = retries;
+    }
+    // Runs the configured increments and checks every line received exactly
+    // the increments aimed at it.
+    bool Execute(THostStressResult &result)
+    {
+        for (cl_uint line = 0; line <= _config.threadCount; line++)
+            host_atomic_init(Line(line), (HostDataType)0);
+
+        result.seconds = host_stress_run(_config.threadCount,
+                                         _config.pinThreads, ThreadFunction,
+                                         this);
+        result.operations = (cl_ulong)_config.threadCount * _config.iterations;
+        result.retries = 0;
+        for (cl_uint tid = 0; tid < _config.threadCount; tid++)
+            result.retries += _retries[tid * HOST_STRESS_RETRY_STRIDE];
+
+        cl_ulong sharedOps = 0;
+        for (cl_uint i = 0; i < _config.iterations; i++)
+            sharedOps += IsShared(i);
+        bool correct = true;
+        for (cl_uint line = 0; line <= _config.threadCount; line++)
+        {
+            cl_ulong expected = line ? _config.iterations - sharedOps
+                                     : sharedOps * _config.threadCount;
+            cl_ulong value = (cl_ulong)host_atomic_load<HostAtomicType,
+                                                        HostDataType>(
+                Line(line), MEMORY_ORDER_SEQ_CST);
+            if (value != (cl_ulong)(HostDataType)expected)
+            {
+                log_error("ERROR: line %u holds %llu increments, expected "
+                          "%llu\n",
+                          line, (unsigned long long)value,
+                          (unsigned long long)expected);
+                correct = false;
+            }
+        }
+        return correct;
+    }
+
+private:
+    // keeps the per-thread retry counters on separate lines
+    static const cl_uint HOST_STRESS_RETRY_STRIDE =
+        HOST_STRESS_LINE_SIZE / sizeof(cl_ulong);
+
+    const THostStressConfig _config;
+    char *_memory;
+    std::vector<cl_ulong> _retries;
+};
+
+#endif // HOST_STRESS_H_
@@ -26,6 +26,8 @@ bool gUseHostPtr = false; // use malloc/free with CL_MEM_USE_HOST_PTR instead of
 bool gDebug = false; // always print OpenCL kernel code
 int gInternalIterations = 10000; // internal test iterations for atomic operation, sufficient to verify atomicity
 int gMaxDeviceThreads = 1024; // maximum number of threads executed on OCL device
+bool gBenchmark = false; // time device atomic throughput
+const char *gBenchmarkCsv = NULL; // file receiving benchmark results as CSV
 cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 
@@ -142,7 +144,9 @@ int main(int argc, const char *argv[])
       log_info("  '-useHostPtr'              use malloc/free with CL_MEM_USE_HOST_PTR instead of clSVMAlloc/clSVMFree\n");
       log_info("  '-debug'                   always print OpenCL kernel code\n");
       log_info("  '-internalIterations <X>'  internal test iterations for atomic operation, sufficient to verify atomicity\n");
-      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device");
+      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device\n");
+      log_info("  '-benchmark'               time device atomic throughput (atomic_throughput)\n");
+      log_info("  '-benchmarkCsv <file>'     time device atomic throughput and write the results to file as CSV");
 
       break;
     }
@@ -178,6 +182,14 @@ int main(int argc, const char *argv[])
     }
     else if(std::string(argv[argc-1]) == "-debug") // print OpenCL kernel code
       gDebug = true;
+    else if(std::string(argv[argc-1]) == "-benchmark") // time device atomic throughput
+      gBenchmark = true;
+    else if(argc > 2 && std::string(argv[argc-2]) == "-benchmarkCsv") // write benchmark results as CSV
+    {
+      gBenchmark = true;
+      gBenchmarkCsv = argv[argc-1];
+      argc--;
+    }
     else if(argc > 2 && std::string(argv[argc-2]) == "-internalIterations") // internal test iterations for atomic operation, sufficient to verify atomicity
     {
       gInternalIterations = atoi(argv[argc-1]);
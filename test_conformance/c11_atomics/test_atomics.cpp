@@ -14,11 +14,14 @@
 // limitations under the License.
 //
 #include "harness/testHarness.h"
+#include "harness/alloc.h"
 #include "harness/kernelHelpers.h"
 #include "harness/typeWrappers.h"
+#include "harness/verifyHelpers.h"
 
 #include "common.h"
 #include "host_atomics.h"
+#include "host_stress.h"
 
 #include <sstream>
 #include <vector>
@@ -513,49 +516,13 @@ public:
         /* These values must be distributed across refValues array and atomic
          * variable finalVaue[0] */
         /* Any repeated value is treated as an error */
-        std::vector<bool> tidFound(threadCount);
-        bool startValueFound = false;
-        cl_uint i;
-
-        for (i = 0; i <= threadCount; i++)
-        {
-            cl_uint value;
-            if (i == threadCount)
-                value = (cl_uint)finalValues[0]; // additional value from atomic
-                                                 // variable (last written)
-            else
-                value = (cl_uint)refValues[i];
-            if (value == (cl_uint)StartValue())
-            {
-                // Special initial value
-                if (startValueFound)
-                {
-                    log_error("ERROR: Starting reference value (%u) occurred "
-                              "more thane once\n",
-                              (cl_uint)StartValue());
-                    correct = false;
-                    return true;
-                }
-                startValueFound = true;
-                continue;
-            }
-            if (value >= threadCount)
-            {
-                log_error(
-                    "ERROR: Reference value %u outside of valid range! (%u)\n",
-                    i, value);
-                correct = false;
-                return true;
-            }
-            if (tidFound[value])
-            {
-                log_error("ERROR: Value (%u) occurred more thane once\n",
-                          value);
-                correct = false;
-                return true;
-            }
-            tidFound[value] = true;
-        }
+        PermutationVerifier<cl_uint> verifier(0, threadCount,
+                                              (cl_uint)StartValue());
+        for (cl_uint i = 0; i < threadCount && correct; i++)
+            correct = verifier.add((cl_uint)refValues[i]);
+        // additional value from atomic variable (last written)
+        correct = correct && verifier.add((cl_uint)finalValues[0])
+            && verifier.complete();
         return true;
     }
 };
@@ -771,11 +738,9 @@ public:
         /* These values must be distributed across refValues array and atomic
          * variable finalVaue[0] */
         /* Any repeated value is treated as an error */
-        std::vector<bool> tidFound(threadCount);
-        bool startValueFound = false;
-        cl_uint i;
-
-        for (i = 0; i <= threadCount; i++)
+        PermutationVerifier<cl_uint> verifier(0, threadCount,
+                                              (cl_uint)StartValue());
+        for (cl_uint i = 0; i <= threadCount && correct; i++)
         {
             cl_uint value;
             if (i == threadCount)
@@ -783,40 +748,12 @@ public:
                                                  // variable (last written)
             else
                 value = (cl_uint)refValues[i];
-            if (value == (cl_uint)StartValue())
-            {
-                // Special initial value
-                if (startValueFound)
-                {
-                    log_error("ERROR: Starting reference value (%u) occurred "
-                              "more thane once\n",
-                              (cl_uint)StartValue());
-                    correct = false;
-                    return true;
-                }
-                startValueFound = true;
-                continue;
-            }
-            if (value >= threadCount)
-            {
-                if (value == threadCount)
-                    log_error("ERROR: Spurious failure detected for "
-                              "atomic_compare_exchange_strong\n");
-                log_error(
-                    "ERROR: Reference value %u outside of valid range! (%u)\n",
-                    i, value);
-                correct = false;
-                return true;
-            }
-            if (tidFound[value])
-            {
-                log_error("ERROR: Value (%u) occurred more thane once\n",
-                          value);
-                correct = false;
-                return true;
-            }
-            tidFound[value] = true;
+            if (value == threadCount && value != (cl_uint)StartValue())
+                log_error("ERROR: Spurious failure detected for "
+                          "atomic_compare_exchange_strong\n");
+            correct = verifier.add(value);
         }
+        correct = correct && verifier.complete();
         return true;
     }
 };
@@ -2375,6 +2312,8 @@ public:
                                   HostDataType>::MemoryOrderScopeStr;
     using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::UseSVM;
     using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::LocalMemory;
+    using CBasicTestMemOrderScope<HostAtomicType,
+                                  HostDataType>::CollectingProgramBatch;
     CBasicTestFlag(TExplicitAtomicType dataType, bool useSVM)
         : CBasicTestMemOrderScope<HostAtomicType, HostDataType>(dataType,
                                                                 useSVM)
@@ -2415,9 +2354,10 @@ public:
             if (!LocalMemory()
                 && !(gAtomicFenceCap & CL_DEVICE_ATOMIC_SCOPE_DEVICE))
             {
-                log_info("Skipping atomic_flag test due to use of "
-                         "atomic_scope_device "
-                         "which is optionally not supported on this device\n");
+                if (!CollectingProgramBatch())
+                    log_info("Skipping atomic_flag test due to use of "
+                             "atomic_scope_device which is optionally not "
+                             "supported on this device\n");
                 return 0; // skip test - not applicable
             }
         }
@@ -2537,10 +2477,8 @@ public:
         /* We are expecting unique values from 0 to threadCount-1 (each critical
          * section must be visited) */
         /* These values must be distributed across refValues array */
-        std::vector<bool> tidFound(threadCount);
-        cl_uint i;
-
-        for (i = 0; i < threadCount; i++)
+        PermutationVerifier<cl_uint> verifier(0, threadCount);
+        for (cl_uint i = 0; i < threadCount && correct; i++)
         {
             cl_uint value = (cl_uint)refValues[i];
             if (value == CRITICAL_SECTION_NOT_VISITED)
@@ -2550,23 +2488,9 @@ public:
                 correct = false;
                 return true;
             }
-            if (value >= threadCount)
-            {
-                log_error(
-                    "ERROR: Reference value %u outside of valid range! (%u)\n",
-                    i, value);
-                correct = false;
-                return true;
-            }
-            if (tidFound[value])
-            {
-                log_error("ERROR: Value (%u) occurred more thane once\n",
-                          value);
-                correct = false;
-                return true;
-            }
-            tidFound[value] = true;
+            correct = verifier.add(value);
         }
+        correct = correct && verifier.complete();
         return true;
     }
 };
@@ -3199,3 +3123,469 @@ REGISTER_TEST(svm_atomic_fence)
     return test_atomic_fence_generic(device, context, queue, num_elements,
                                      true);
 }
+
+template <typename HostAtomicType, typename HostDataType>
+static int test_host_atomic_contention_type(const char *typeName,
+                                            void *memory, cl_uint threadCount)
+{
+    int error = 0;
+    const cl_uint sharedPercents[] = { 100, 50, 0 };
+    for (int useCompareExchange = 0; useCompareExchange < 2;
+         useCompareExchange++)
+    {
+        for (cl_uint sharedPercent : sharedPercents)
+        {
+            THostStressConfig config;
+            config.threadCount = threadCount;
+            config.iterations = (cl_uint)gInternalIterations * 10;
+            config.sharedPercent = sharedPercent;
+            config.pinThreads = true;
+            config.useCompareExchange = useCompareExchange != 0;
+
+            CHostStressIncrement<HostAtomicType, HostDataType> test(config,
+                                                                    memory);
+            THostStressResult result;
+            bool correct = test.Execute(result);
+            log_info("\t%s %s, %u%% shared: %.1f Mops/s, %.3f retries/op\n",
+                     typeName,
+                     useCompareExchange ? "compare_exchange loop"
+                                        : "fetch_add",
+                     sharedPercent, result.operations / result.seconds / 1e6,
+                     (double)result.retries / result.operations);
+            if (!correct)
+            {
+                log_error("ERROR: Lost updates under host contention!\n");
+                error = -1;
+                if (!gContinueOnError) return error;
+            }
+        }
+    }
+    return error;
+}
+
+static int test_host_atomic_contention_generic(cl_device_id deviceID,
+                                               cl_context context, bool useSVM)
+{
+    int error = 0;
+    cl_uint threadCount = MAX_HOST_THREADS;
+    if (threadCount < 2) threadCount = 2;
+    size_t size = host_stress_memory_size(threadCount);
+    void *memory;
+
+    if (useSVM && !gUseHostPtr)
+    {
+        cl_device_svm_capabilities caps;
+        error = clGetDeviceInfo(deviceID, CL_DEVICE_SVM_CAPABILITIES,
+                                sizeof(caps), &caps, 0);
+        test_error(error, "clGetDeviceInfo failed");
+        if ((caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER) == 0
+            || (caps & CL_DEVICE_SVM_ATOMICS) == 0)
+        {
+            log_info("\tFine grain SVM buffers with atomics not supported\n");
+            return TEST_SKIPPED_ITSELF;
+        }
+        memory = clSVMAlloc(context,
+                            CL_MEM_SVM_FINE_GRAIN_BUFFER | CL_MEM_SVM_ATOMICS,
+                            size, HOST_STRESS_LINE_SIZE);
+    }
+    else
+        memory = align_malloc(size, HOST_STRESS_LINE_SIZE);
+    if (!memory)
+    {
+        log_error("ERROR: Allocating contention memory failed!\n");
+        return -1;
+    }
+
+    log_info("\t%u pinned host threads\n", threadCount);
+    error = test_host_atomic_contention_type<HOST_ATOMIC_UINT, HOST_UINT>(
+        "atomic_uint", memory, threadCount);
+    if (!error || gContinueOnError)
+        error |=
+            test_host_atomic_contention_type<HOST_ATOMIC_ULONG, HOST_ULONG>(
+                "atomic_ulong", memory, threadCount);
+
+    if (useSVM && !gUseHostPtr)
+        clSVMFree(context, memory);
+    else
+        align_free(memory);
+    return error;
+}
+
+REGISTER_TEST(host_atomic_contention)
+{
+    if (!gHost)
+    {
+        log_info("\tHost contention is only measured in host verification "
+                 "mode (-host)\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+    return test_host_atomic_contention_generic(device, context, false);
+}
+
+REGISTER_TEST(svm_host_atomic_contention)
+{
+    return test_host_atomic_contention_generic(device, context, true);
+}
+
+enum TAtomicThroughputOp
+{
+    THROUGHPUT_FETCH_ADD,
+    THROUGHPUT_FETCH_SUB,
+    THROUGHPUT_FETCH_OR,
+    THROUGHPUT_FETCH_XOR,
+    THROUGHPUT_FETCH_AND,
+    THROUGHPUT_FETCH_MIN,
+    THROUGHPUT_FETCH_MAX,
+    THROUGHPUT_EXCHANGE,
+    THROUGHPUT_COMPARE_EXCHANGE,
+    THROUGHPUT_STORE,
+    THROUGHPUT_LOAD,
+    THROUGHPUT_OP_COUNT
+};
+
+// Which work-items share an atomic: all of them, those of one work-group, or
+// none
+enum TAtomicContention
+{
+    CONTENTION_ONE_ADDRESS,
+    CONTENTION_WORK_GROUP,
+    CONTENTION_WORK_ITEM,
+    CONTENTION_COUNT
+};
+
+static const char *atomic_throughput_op_name(TAtomicThroughputOp op)
+{
+    switch (op)
+    {
+        case THROUGHPUT_FETCH_ADD: return "atomic_fetch_add";
+        case THROUGHPUT_FETCH_SUB: return "atomic_fetch_sub";
+        case THROUGHPUT_FETCH_OR: return "atomic_fetch_or";
+        case THROUGHPUT_FETCH_XOR: return "atomic_fetch_xor";
+        case THROUGHPUT_FETCH_AND: return "atomic_fetch_and";
+        case THROUGHPUT_FETCH_MIN: return "atomic_fetch_min";
+        case THROUGHPUT_FETCH_MAX: return "atomic_fetch_max";
+        case THROUGHPUT_EXCHANGE: return "atomic_exchange";
+        case THROUGHPUT_COMPARE_EXCHANGE:
+            return "atomic_compare_exchange_strong";
+        case THROUGHPUT_STORE: return "atomic_store";
+        case THROUGHPUT_LOAD: return "atomic_load";
+        default: return "";
+    }
+}
+
+static const char *atomic_contention_name(TAtomicContention contention)
+{
+    switch (contention)
+    {
+        case CONTENTION_ONE_ADDRESS: return "one address";
+        case CONTENTION_WORK_GROUP: return "address per work-group";
+        case CONTENTION_WORK_ITEM: return "address per work-item";
+        default: return "";
+    }
+}
+
+// Each work-item performs Iterations() operations of one kind on the atomic
+// selected by the contention mode. The final values are verified like any
+// other test, and the kernel time from profiling events is reported as
+// device-wide operations per second.
+template <typename HostAtomicType, typename HostDataType>
+class CBasicTestThroughput
+    : public CBasicTestMemOrderScope<HostAtomicType, HostDataType> {
+public:
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::MemoryOrder;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::MemoryScope;
+    using CBasicTestMemOrderScope<HostAtomicType,
+                                  HostDataType>::MemoryOrderScopeStr;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::MemoryScopeStr;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::StartValue;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::DataType;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::LocalMemory;
+    using CBasicTestMemOrderScope<HostAtomicType,
+                                  HostDataType>::DeclaredInProgram;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::UsedInFunction;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::OldValueCheck;
+    using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::Iterations;
+    using CBasicTestMemOrderScope<HostAtomicType,
+                                  HostDataType>::CurrentGroupSize;
+    using CBasicTestMemOrderScope<HostAtomicType,
+                                  HostDataType>::CollectingProgramBatch;
+    CBasicTestThroughput(TExplicitAtomicType dataType, TAtomicThroughputOp op,
+                         FILE *csv)
+        : CBasicTestMemOrderScope<HostAtomicType, HostDataType>(dataType),
+          _op(op), _csv(csv), _contention(CONTENTION_ONE_ADDRESS)
+    {
+        OldValueCheck(false);
+    }
+    virtual cl_uint NumResults(cl_uint threadCount, cl_device_id deviceID)
+    {
+        switch (_contention)
+        {
+            case CONTENTION_WORK_GROUP:
+                return (threadCount + CurrentGroupSize() - 1)
+                    / CurrentGroupSize();
+            case CONTENTION_WORK_ITEM: return threadCount;
+            default: return 1;
+        }
+    }
+    virtual std::string ProgramCore()
+    {
+        static const char *slots[] = { "0", "get_group_id(0)", "tid" };
+        std::string memoryOrderScope = MemoryOrderScopeStr();
+        std::string postfix(memoryOrderScope.empty() ? "" : "_explicit");
+        std::string cTypeName = DataType().RegularTypeName();
+        std::string target = std::string("&destMemory[") + slots[_contention]
+            + "]";
+        std::stringstream start;
+        start << "(" << cTypeName << ")" << StartValue();
+
+        std::string body;
+        switch (_op)
+        {
+            case THROUGHPUT_FETCH_ADD:
+            case THROUGHPUT_FETCH_SUB:
+            case THROUGHPUT_FETCH_XOR:
+                body = "    last = "
+                    + std::string(atomic_throughput_op_name(_op)) + postfix
+                    + "(" + target + ", (" + DataType().AddSubOperandTypeName()
+                    + ")1"
+                    + memoryOrderScope + ");\n";
+                break;
+            case THROUGHPUT_FETCH_OR:
+                body = "    last = atomic_fetch_or" + postfix + "(" + target
+                    + ", (" + cTypeName + ")1 << (i % 8)" + memoryOrderScope
+                    + ");\n";
+                break;
+            case THROUGHPUT_FETCH_AND:
+                body = "    last = atomic_fetch_and" + postfix + "(" + target
+                    + ", ~((" + cTypeName + ")1 << (i % 8))" + memoryOrderScope
+                    + ");\n";
+                break;
+            case THROUGHPUT_FETCH_MIN:
+                body = "    last = atomic_fetch_min" + postfix + "(" + target
+                    + ", (" + cTypeName + ")(i % 100)" + memoryOrderScope
+                    + ");\n";
+                break;
+            case THROUGHPUT_FETCH_MAX:
+                body = "    last = atomic_fetch_max" + postfix + "(" + target
+                    + ", " + start.str() + " + 1 + (" + cTypeName
+                    + ")(i % 100)" + memoryOrderScope + ");\n";
+                break;
+            case THROUGHPUT_EXCHANGE:
+                body = "    last = atomic_exchange" + postfix + "(" + target
+                    + ", " + start.str() + " + 1" + memoryOrderScope + ");\n";
+                break;
+            case THROUGHPUT_COMPARE_EXCHANGE: {
+                // increment in a compare-exchange loop; a failed exchange
+                // only needs to reload the value
+                std::string failure = postfix.empty()
+                    ? ""
+                    : ", " + std::string(get_memory_order_type_name(
+                                 MemoryOrder()))
+                        + ", memory_order_relaxed" + MemoryScopeStr();
+                body = "    last = atomic_load" + postfix + "(" + target
+                    + (postfix.empty() ? "" : ", memory_order_relaxed")
+                    + MemoryScopeStr()
+                    + ");\n"
+                      "    while (!atomic_compare_exchange_strong"
+                    + postfix + "(" + target + ", &last, last + 1" + failure
+                    + "))\n"
+                      "      ;\n";
+                break;
+            }
+            case THROUGHPUT_STORE:
+                body = "    atomic_store" + postfix + "(" + target + ", "
+                    + start.str() + " + 1" + memoryOrderScope
+                    + ");\n"
+                      "    last = i;\n";
+                break;
+            case THROUGHPUT_LOAD:
+                body = "    last ^= atomic_load" + postfix + "(" + target
+                    + memoryOrderScope + ");\n";
+                break;
+            default: break;
+        }
+        std::stringstream iterations;
+        iterations << Iterations();
+        return "  " + cTypeName + " last = 0;\n" + "  for (uint i = 0; i < "
+            + iterations.str() + "; i++)\n" + "  {\n" + body + "  }\n"
+            + "  oldValues[tid] = last;\n";
+    }
+    virtual bool ExpectedValue(HostDataType &expected, cl_uint threadCount,
+                               HostDataType *startRefValues,
+                               cl_uint whichDestValue)
+    {
+        cl_uint slotThreads = 1;
+        if (_contention == CONTENTION_ONE_ADDRESS)
+            slotThreads = threadCount;
+        else if (_contention == CONTENTION_WORK_GROUP)
+            slotThreads = std::min(CurrentGroupSize(),
+                                   threadCount
+                                       - whichDestValue * CurrentGroupSize());
+        cl_ulong operations = (cl_ulong)slotThreads * Iterations();
+        cl_uint bitIterations = std::min<cl_uint>(Iterations(), 8);
+        HostDataType bits = (HostDataType)((1 << bitIterations) - 1);
+
+        expected = StartValue();
+        switch (_op)
+        {
+            case THROUGHPUT_FETCH_ADD:
+            case THROUGHPUT_COMPARE_EXCHANGE:
+                expected = (HostDataType)((cl_ulong)expected + operations);
+                break;
+            case THROUGHPUT_FETCH_SUB:
+                expected = (HostDataType)((cl_ulong)expected - operations);
+                break;
+            case THROUGHPUT_FETCH_OR: expected |= bits; break;
+            case THROUGHPUT_FETCH_XOR:
+                if (operations & 1) expected ^= (HostDataType)1;
+                break;
+            case THROUGHPUT_FETCH_AND: expected &= (HostDataType)~bits; break;
+            case THROUGHPUT_FETCH_MIN:
+                expected = std::min(expected, (HostDataType)0);
+                break;
+            case THROUGHPUT_FETCH_MAX:
+                expected += (HostDataType)std::min<cl_uint>(Iterations(), 100);
+                break;
+            case THROUGHPUT_EXCHANGE:
+            case THROUGHPUT_STORE: expected += 1; break;
+            default: break;
+        }
+        return true;
+    }
+    virtual std::string SingleTestName()
+    {
+        return std::string(atomic_throughput_op_name(_op)) + " "
+            + CBasicTestMemOrderScope<HostAtomicType,
+                                      HostDataType>::SingleTestName()
+            + ", " + atomic_contention_name(_contention);
+    }
+    virtual int ExecuteSingleTest(cl_device_id deviceID, cl_context context,
+                                  cl_command_queue queue)
+    {
+        // only global atomics passed as kernel arguments are timed
+        if (LocalMemory() || DeclaredInProgram() || UsedInFunction())
+            return 0;
+        // orders that are not valid for loads or stores
+        if (_op == THROUGHPUT_LOAD
+            && (MemoryOrder() == MEMORY_ORDER_RELEASE
+                || MemoryOrder() == MEMORY_ORDER_ACQ_REL))
+            return 0;
+        if (_op == THROUGHPUT_STORE
+            && (MemoryOrder() == MEMORY_ORDER_ACQUIRE
+                || MemoryOrder() == MEMORY_ORDER_ACQ_REL))
+            return 0;
+        return CBasicTestMemOrderScope<
+            HostAtomicType, HostDataType>::ExecuteSingleTest(deviceID, context,
+                                                             queue);
+    }
+    virtual int ExecuteForEachParameterSet(cl_device_id deviceID,
+                                           cl_context context,
+                                           cl_command_queue queue)
+    {
+        int error = 0;
+        for (int c = 0; c < CONTENTION_COUNT; c++)
+        {
+            _contention = (TAtomicContention)c;
+            EXECUTE_TEST(
+                error,
+                (CBasicTestMemOrderScope<HostAtomicType, HostDataType>::
+                     ExecuteForEachParameterSet(deviceID, context, queue)));
+        }
+        return error;
+    }
+    virtual cl_uint MaxHostThreads() { return 0; }
+    virtual bool ProfileKernel() { return true; }
+    virtual void KernelProfiled(cl_uint deviceThreadCount, cl_ulong nanoseconds)
+    {
+        cl_ulong operations = (cl_ulong)deviceThreadCount * Iterations();
+        double seconds = nanoseconds * 1e-9;
+        double opsPerSecond = seconds > 0 ? operations / seconds : 0.0;
+        log_info("\t\t%.1f Mops/s\n", opsPerSecond * 1e-6);
+        if (!_csv) return;
+        fprintf(_csv, "%s,%s,%s,%s,%s,%u,%u,%llu,%.9f,%.0f\n",
+                DataType().AtomicTypeName(), atomic_throughput_op_name(_op),
+                MemoryOrder() == MEMORY_ORDER_EMPTY
+                    ? "default"
+                    : get_memory_order_type_name(MemoryOrder()),
+                MemoryScope() == MEMORY_SCOPE_EMPTY
+                    ? "default"
+                    : get_memory_scope_type_name(MemoryScope()),
+                atomic_contention_name(_contention), deviceThreadCount,
+                CurrentGroupSize(), (unsigned long long)operations, seconds,
+                opsPerSecond);
+        fflush(_csv);
+    }
+
+private:
+    const TAtomicThroughputOp _op;
+    FILE *_csv;
+    TAtomicContention _contention;
+};
+
+template <typename HostAtomicType, typename HostDataType>
+static int test_atomic_throughput_type(cl_device_id deviceID,
+                                       cl_context context,
+                                       cl_command_queue queue,
+                                       int num_elements,
+                                       TExplicitAtomicType dataType, FILE *csv)
+{
+    int error = 0;
+    for (int op = 0; op < THROUGHPUT_OP_COUNT; op++)
+    {
+        CBasicTestThroughput<HostAtomicType, HostDataType> test(
+            dataType, (TAtomicThroughputOp)op, csv);
+        EXECUTE_TEST(error,
+                     test.Execute(deviceID, context, queue, num_elements));
+    }
+    return error;
+}
+
+REGISTER_TEST(atomic_throughput)
+{
+    if (!gBenchmark || gHost || gOldAPI)
+    {
+        log_info("\tAtomic throughput is only measured in benchmark mode "
+                 "(-benchmark or -benchmarkCsv <file>) on the device\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    // The kernels are timed with profiling events
+    int error;
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper profilingQueue =
+        clCreateCommandQueueWithProperties(context, device, props, &error);
+    test_error(error, "clCreateCommandQueueWithProperties failed");
+
+    FILE *csv = NULL;
+    if (gBenchmarkCsv)
+    {
+        csv = fopen(gBenchmarkCsv, "w");
+        if (!csv)
+        {
+            log_error("ERROR: Unable to open %s for writing\n", gBenchmarkCsv);
+            return -1;
+        }
+        fprintf(csv, "type,operation,memory order,memory scope,contention,"
+                     "threads,group size,operations,seconds,ops per second\n");
+    }
+
+    error = 0;
+    error |= test_atomic_throughput_type<HOST_ATOMIC_INT, HOST_INT>(
+        device, context, profilingQueue, num_elements, TYPE_ATOMIC_INT, csv);
+    if (!error || gContinueOnError)
+        error |= test_atomic_throughput_type<HOST_ATOMIC_UINT, HOST_UINT>(
+            device, context, profilingQueue, num_elements, TYPE_ATOMIC_UINT,
+            csv);
+    if (!error || gContinueOnError)
+        error |= test_atomic_throughput_type<HOST_ATOMIC_LONG, HOST_LONG>(
+            device, context, profilingQueue, num_elements, TYPE_ATOMIC_LONG,
+            csv);
+    if (!error || gContinueOnError)
+        error |= test_atomic_throughput_type<HOST_ATOMIC_ULONG, HOST_ULONG>(
+            device, context, profilingQueue, num_elements, TYPE_ATOMIC_ULONG,
+            csv);
+
+    if (csv) fclose(csv);
+    return error;
+}
@@ -80,6 +80,8 @@ void *gAllowZ = NULL;
 void *gOut[kCallStyleCount] = { NULL };
 cl_mem gInBuffer;
 cl_mem gOutBuffers[kCallStyleCount];
+int gUseHostPtr = 0;
+HostArrayAllocator gHostArrays;
 size_t gComputeDevices = 0;
 uint32_t gDeviceFrequency = 0;
 int gWimpyMode = 0;
@@ -698,6 +700,12 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             init_info.round = round = kRoundTowardZero;
     }
 
+    // Half references are rounded from a float computed to nearest even
+    if (outType == khalf)
+        init_info.fpState = { kRoundToNearestEven, kfloat, false };
+    else
+        init_info.fpState = { round, outType, false };
+
     // Figure out how many elements are in a work block
     // we handle 64-bit types a bit differently.
     uint64_t lastCase = (8 * gTypeSizes[inType] > 32)
@@ -781,14 +789,23 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             }
         }
 
+        // In zero-copy mode gIn is the backing store of gInBuffer, so it is
+        // mapped before InitData fills it and unmapped to hand it over.
+        void *mappedIn;
+        if ((error = gHostArrays.BeginWrite(
+                 gQueue, gInBuffer, count * gTypeSizes[inType], &mappedIn)))
+        {
+            gFailCount++;
+            return error;
+        }
+
         ThreadPool_Do(conv_test::InitData, chunks, &init_info);
 
         // Copy the results to the device
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_TRUE, 0,
-                                          count * gTypeSizes[inType], gIn, 0,
-                                          NULL, NULL)))
+        if ((error = gHostArrays.EndWrite(gQueue, gInBuffer, CL_TRUE,
+                                          count * gTypeSizes[inType], gIn,
+                                          mappedIn)))
         {
-            vlog_error("ERROR: clEnqueueWriteBuffer failed. (%d)\n", error);
             gFailCount++;
             return error;
         }
@@ -1292,40 +1309,38 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
         qcom_sat = info->sat;
 #endif
 
-        RoundingMode oldRound;
-        if (outType == khalf)
         {
-            oldRound = set_round(kRoundToNearestEven, kfloat);
-            switch (round)
+            // The rounding mode only applies to the conversion itself
+            FPUStateGuard fpState(info->fpState);
+            if (outType == khalf)
             {
-                default:
-                case kDefaultRoundingMode:
-                    DataInitInfo::halfRoundingMode =
-                        ConversionsTest::defaultHalfRoundingMode;
-                    break;
-                case kRoundToNearestEven:
-                    DataInitInfo::halfRoundingMode = CL_HALF_RTE;
-                    break;
-                case kRoundUp:
-                    DataInitInfo::halfRoundingMode = CL_HALF_RTP;
-                    break;
-                case kRoundDown:
-                    DataInitInfo::halfRoundingMode = CL_HALF_RTN;
-                    break;
-                case kRoundTowardZero:
-                    DataInitInfo::halfRoundingMode = CL_HALF_RTZ;
-                    break;
+                switch (round)
+                {
+                    default:
+                    case kDefaultRoundingMode:
+                        DataInitInfo::halfRoundingMode =
+                            ConversionsTest::defaultHalfRoundingMode;
+                        break;
+                    case kRoundToNearestEven:
+                        DataInitInfo::halfRoundingMode = CL_HALF_RTE;
+                        break;
+                    case kRoundUp:
+                        DataInitInfo::halfRoundingMode = CL_HALF_RTP;
+                        break;
+                    case kRoundDown:
+                        DataInitInfo::halfRoundingMode = CL_HALF_RTN;
+                        break;
+                    case kRoundTowardZero:
+                        DataInitInfo::halfRoundingMode = CL_HALF_RTZ;
+                        break;
+                }
             }
-        }
-        else
-            oldRound = set_round(round, outType);
-
-        if (info->sat)
-            info->conv_array_sat(d, s, count);
-        else
-            info->conv_array(d, s, count);
 
-        set_round(oldRound, outType);
+            if (info->sat)
+                info->conv_array_sat(d, s, count);
+            else
+                info->conv_array(d, s, count);
+        }
 
         // Decide if we allow a zero result in addition to the correctly rounded
         // one
@@ -21,6 +21,7 @@
 #endif
 
 #include "harness/errorHelpers.h"
+#include "harness/hostArrays.h"
 #include "harness/rounding_mode.h"
 
 #include <stdio.h>
@@ -76,6 +77,8 @@ extern cl_command_queue gQueue;
 extern cl_context gContext;
 extern cl_mem gInBuffer;
 extern cl_mem gOutBuffers[];
+extern int gUseHostPtr;
+extern HostArrayAllocator gHostArrays;
 extern int gHasDouble;
 extern int gTestDouble;
 extern int gHasHalfs;
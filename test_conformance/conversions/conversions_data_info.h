@@ -63,6 +63,8 @@ struct DataInitInfo
     SaturationMode sat;
     RoundingMode round;
     cl_uint threads;
+    // The environment PrepareReference converts under on each worker
+    FPUState fpState;
 
     static cl_half_rounding_mode halfRoundingMode;
     static std::vector<uint32_t> specialValuesUInt;
@@ -157,6 +157,18 @@ int main(int argc, const char **argv)
     {
         clReleaseMemObject(gOutBuffers[i]);
     }
+
+    if (gUseHostPtr)
+    {
+        vlog("Zero-copy host buffers saved %llu bytes of input copies.\n",
+             (unsigned long long)gHostArrays.BytesSaved());
+        if (gContext)
+        {
+            gHostArrays.Free(gIn);
+            for (int i = 0; i < kCallStyleCount; i++)
+                gHostArrays.Free(gOut[i]);
+        }
+    }
     clReleaseCommandQueue(gQueue);
     clReleaseContext(gContext);
 
@@ -227,6 +239,7 @@ static int ParseArgs(int argc, const char **argv)
                         gForceHalfFTZ ^= 1;
                         break;
                     case 't': gTimeResults ^= 1; break;
+                    case 'u': gUseHostPtr ^= 1; break;
                     case 'a': gReportAverageTimes ^= 1; break;
                     case '1':
                         if (arg[1] == '6')
@@ -318,7 +331,7 @@ static int ParseArgs(int argc, const char **argv)
 static void PrintUsage(void)
 {
     int i;
-    vlog("%s [-wz#]: <optional: test names>\n", appName);
+    vlog("%s [-uwz#]: <optional: test names>\n", appName);
     vlog("\ttest names:\n");
     vlog("\t\tdestFormat<_sat><_round>_sourceFormat\n");
     vlog("\t\t\tPossible format types are:\n\t\t\t\t");
@@ -343,6 +356,9 @@ static void PrintUsage(void)
     vlog(" \t\t-[2^n]\tSet wimpy reduction factor, recommended range of n is "
          "1-12, default factor(%u)\n",
          gWimpyReductionFactor);
+    vlog("\t\t-u\tToggle zero-copy mode. Device buffers wrap the host "
+         "arrays with CL_MEM_USE_HOST_PTR (fine-grain SVM when supported) "
+         "instead of copying inputs every block. (Off by default.)\n");
     vlog("\t\t-z\tToggle flush to zero mode  (Default: per device)\n");
     vlog("\t\t-#\tTest just vector size given by #, where # is an element of "
          "the set {1,2,3,4,8,16}\n");
@@ -481,21 +497,31 @@ test_status InitCL(cl_device_id device)
         return TEST_FAIL;
     }
 
+    gHostArrays.Init(gContext, device, gUseHostPtr);
+
     // Allocate buffers
     // FIXME: use clProtectedArray for guarded allocations?
-    gIn = malloc(BUFFER_SIZE + 2 * kPageSize);
+    gIn = gHostArrays.Alloc(BUFFER_SIZE + 2 * kPageSize);
     gAllowZ = malloc(BUFFER_SIZE + 2 * kPageSize);
     gRef = malloc(BUFFER_SIZE + 2 * kPageSize);
+    if (NULL == gIn || NULL == gAllowZ || NULL == gRef)
+    {
+        vlog_error("Failed to allocate the input and reference arrays\n");
+        return TEST_FAIL;
+    }
     for (i = 0; i < kCallStyleCount; i++)
     {
-        gOut[i] = malloc(BUFFER_SIZE + 2 * kPageSize);
-        if (NULL == gOut[i]) return TEST_FAIL;
+        gOut[i] = gHostArrays.Alloc(BUFFER_SIZE + 2 * kPageSize);
+        if (NULL == gOut[i])
+        {
+            vlog_error("Failed to allocate output array %d\n", i);
+            return TEST_FAIL;
+        }
     }
 
     // setup input buffers
-    gInBuffer =
-        clCreateBuffer(gContext, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR,
-                       BUFFER_SIZE, NULL, &error);
+    gInBuffer = gHostArrays.CreateBuffer(
+        CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, BUFFER_SIZE, gIn, &error);
     if (gInBuffer == NULL || error)
     {
         vlog_error("clCreateBuffer failed for input (%d)\n", error);
@@ -505,9 +531,9 @@ test_status InitCL(cl_device_id device)
     // setup output buffers
     for (i = 0; i < kCallStyleCount; i++)
     {
-        gOutBuffers[i] =
-            clCreateBuffer(gContext, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
-                           BUFFER_SIZE, NULL, &error);
+        gOutBuffers[i] = gHostArrays.CreateBuffer(
+            CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, BUFFER_SIZE, gOut[i],
+            &error);
         if (gOutBuffers[i] == NULL || error)
         {
             vlog_error("clCreateArray failed for output (%d)\n", error);
@@ -542,6 +568,8 @@ test_status InitCL(cl_device_id device)
     vlog("\tHas Double? %s\n", no_yes[0 != gHasDouble]);
     if (gHasDouble) vlog("\tTest Double? %s\n", no_yes[0 != gTestDouble]);
     vlog("\tHas Long? %s\n", no_yes[0 != gHasLong]);
+    vlog("\tZero-copy host buffers? %s%s\n", no_yes[0 != gUseHostPtr],
+         gHostArrays.UsesSVM() ? " (fine-grain SVM)" : "");
     vlog("\tTesting vector sizes: ");
     for (i = gMinVectorSize; i < gMaxVectorSize; i++)
         vlog("\t%d", vectorSizes[i]);
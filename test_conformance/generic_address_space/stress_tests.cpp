@@ -16,6 +16,7 @@
 #include "harness/testHarness.h"
 #include "harness/typeWrappers.h"
 #include "harness/mt19937.h"
+#include "harness/ThreadPool.h"
 #include "base.h"
 
 #include <string>
@@ -181,3 +182,267 @@ REGISTER_TEST(max_number_of_params)
 
     return test.Execute(device, context, queue, num_elements);
 }
+
+// Generic pointer stress: a family of generated kernels, each a random
+// sequence of steps on one global, one local and one private uint per
+// work-item, reached through generic pointers. Steps check the address space
+// reported by to_global/to_local/to_private and the value pointed to, add to
+// the value through a generic pointer, or pick between two address spaces at
+// run time. The kernels are built in parallel, enqueued together and checked
+// in one pass.
+namespace {
+
+enum GenericSpace
+{
+    GENERIC_GLOBAL,
+    GENERIC_LOCAL,
+    GENERIC_PRIVATE,
+    GENERIC_SPACE_COUNT
+};
+
+const std::string GENERIC_STRESS_PREAMBLE =
+    NL "#define SPACE_GLOBAL 0"
+    NL "#define SPACE_LOCAL 1"
+    NL "#define SPACE_PRIVATE 2"
+    NL
+    NL "uint *passThrough(uint *ptr) { return ptr; }"
+    NL
+    NL "bool checkPointer(uint *ptr, uint space, uint expected) {"
+    NL "    if ((to_global(ptr) != NULL) != (space == SPACE_GLOBAL))"
+    NL "        return false;"
+    NL "    if ((to_local(ptr) != NULL) != (space == SPACE_LOCAL))"
+    NL "        return false;"
+    NL "    if ((to_private(ptr) != NULL) != (space == SPACE_PRIVATE))"
+    NL "        return false;"
+    NL "    return *ptr == expected;"
+    NL "}"
+    NL
+    NL "void addThrough(uint *ptr, uint value) { *ptr += value; }"
+    NL;
+
+struct GenericStressKernel
+{
+    std::string source;
+    cl_uint globalDelta; // added to the global uint of every work-item
+};
+
+// The pointer to the uint of space, wrapped in depth calls of passThrough
+std::string generic_pointer(GenericSpace space, cl_uint depth)
+{
+    static const char *addresses[] = { "&gbuf[tid]", "&lbuf[lid]", "&pvar" };
+    std::string pointer = addresses[space];
+    for (cl_uint i = 0; i < depth; i++)
+        pointer = "passThrough(" + pointer + ")";
+    return pointer;
+}
+
+// The value of the uint of space after delta has been added to it
+std::string generic_expected(GenericSpace space, cl_uint delta)
+{
+    std::ostringstream expected;
+    expected << "(3 * tid + " << space << " + " << delta << "u)";
+    return expected.str();
+}
+
+GenericStressKernel generate_generic_stress_kernel(MTdata d, cl_uint steps)
+{
+    static const char *spaceNames[] = { "SPACE_GLOBAL", "SPACE_LOCAL",
+                                        "SPACE_PRIVATE" };
+    cl_uint deltas[GENERIC_SPACE_COUNT] = { 0, 0, 0 };
+    std::ostringstream body;
+    for (cl_uint i = 0; i < steps; i++)
+    {
+        GenericSpace space = (GenericSpace)(genrand_int32(d) % 3);
+        cl_uint depth = genrand_int32(d) % 4;
+        switch (genrand_int32(d) % 3)
+        {
+            case 0:
+                body << "    failures += !checkPointer("
+                     << generic_pointer(space, depth) << ", "
+                     << spaceNames[space] << ", "
+                     << generic_expected(space, deltas[space]) << ");" NL;
+                break;
+            case 1: {
+                cl_uint value = genrand_int32(d) % 1000;
+                body << "    addThrough(" << generic_pointer(space, depth)
+                     << ", " << value << "u);" NL;
+                deltas[space] += value;
+                break;
+            }
+            case 2: {
+                GenericSpace other =
+                    (GenericSpace)((space + 1 + genrand_int32(d) % 2) % 3);
+                // Named address spaces don't convert to each other, so both
+                // operands are cast to generic pointers first
+                body << "    p = (tid & 1) ? (uint *)"
+                     << generic_pointer(space, depth) << " : (uint *)"
+                     << generic_pointer(other, 0) << ";" NL
+                     << "    failures += !checkPointer(p, (tid & 1) ? "
+                     << spaceNames[space] << " : " << spaceNames[other]
+                     << ", (tid & 1) ? "
+                     << generic_expected(space, deltas[space]) << " : "
+                     << generic_expected(other, deltas[other]) << ");" NL;
+                break;
+            }
+        }
+    }
+
+    GenericStressKernel kernel;
+    kernel.source = GENERIC_STRESS_PREAMBLE
+        + NL "__kernel void testKernel(__global uint *results, "
+             "__global uint *gbuf, __local uint *lbuf) {"
+          NL "    uint tid = get_global_id(0);"
+          NL "    uint lid = get_local_id(0);"
+          NL "    uint pvar = 3 * tid + 2;"
+          NL "    uint *p;"
+          NL "    uint failures = 0;"
+          NL
+          NL "    gbuf[tid] = 3 * tid;"
+          NL "    lbuf[lid] = 3 * tid + 1;"
+          NL
+        + body.str()
+        + NL "    results[tid] = (failures == 0);"
+          NL "}"
+          NL;
+    kernel.globalDelta = deltas[GENERIC_GLOBAL];
+    return kernel;
+}
+
+struct GenericStressBuild
+{
+    cl_context context;
+    std::vector<GenericStressKernel> *kernels;
+    std::vector<clProgramWrapper> *programs;
+    std::vector<clKernelWrapper> *clKernels;
+};
+
+cl_int build_generic_stress_kernel(cl_uint job_id, cl_uint thread_id,
+                                   void *userInfo)
+{
+    GenericStressBuild *build = (GenericStressBuild *)userInfo;
+    const char *srcPtr = (*build->kernels)[job_id].source.c_str();
+    if (create_single_kernel_helper(build->context,
+                                    &(*build->programs)[job_id],
+                                    &(*build->clKernels)[job_id], 1, &srcPtr,
+                                    "testKernel"))
+    {
+        log_error("Building generated kernel #%u failed\n", job_id);
+        return -1;
+    }
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(generic_pointer_stress)
+{
+    const cl_uint kernelCount = 32;
+    const cl_uint minSteps = 16;
+    const cl_uint maxSteps = 64;
+    cl_int error;
+
+    MTdataHolder d(gRandomSeed);
+    std::vector<GenericStressKernel> kernels;
+    for (cl_uint i = 0; i < kernelCount; i++)
+        kernels.push_back(generate_generic_stress_kernel(
+            d, minSteps + genrand_int32(d) % (maxSteps - minSteps + 1)));
+
+    std::vector<clProgramWrapper> programs(kernelCount);
+    std::vector<clKernelWrapper> clKernels(kernelCount);
+    GenericStressBuild build = { context, &kernels, &programs, &clKernels };
+    error = ThreadPool_Do(build_generic_stress_kernel, kernelCount, &build);
+    test_error(error, "Building the generated kernels failed");
+
+    // Kernels of the family are independent, so let them overlap when the
+    // device can run commands out of order
+    cl_command_queue_properties queueProperties = 0;
+    error = clGetDeviceInfo(device, CL_DEVICE_QUEUE_ON_HOST_PROPERTIES,
+                            sizeof(queueProperties), &queueProperties, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    clCommandQueueWrapper ooqQueue;
+    cl_command_queue dispatchQueue = queue;
+    if (queueProperties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)
+    {
+        cl_queue_properties props[] = {
+            CL_QUEUE_PROPERTIES, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, 0
+        };
+        ooqQueue =
+            clCreateCommandQueueWithProperties(context, device, props, &error);
+        test_error(error, "clCreateCommandQueueWithProperties failed");
+        dispatchQueue = ooqQueue;
+    }
+
+    size_t globalWorkGroupSize = num_elements;
+    size_t bufferSize = num_elements * sizeof(cl_uint);
+    std::vector<clMemWrapper> resultBuffers(kernelCount);
+    std::vector<clMemWrapper> globalBuffers(kernelCount);
+    std::vector<cl_uint> results((size_t)kernelCount * num_elements);
+    std::vector<cl_uint> globals((size_t)kernelCount * num_elements);
+    for (cl_uint i = 0; i < kernelCount; i++)
+    {
+        resultBuffers[i] = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                          bufferSize, NULL, &error);
+        test_error(error, "clCreateBuffer failed");
+        globalBuffers[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                          bufferSize, NULL, &error);
+        test_error(error, "clCreateBuffer failed");
+
+        size_t localWorkGroupSize = 0;
+        error = get_max_common_work_group_size(
+            context, clKernels[i], globalWorkGroupSize, &localWorkGroupSize);
+        test_error(error, "Unable to get common work group size");
+
+        error = clSetKernelArg(clKernels[i], 0, sizeof(cl_mem),
+                               &resultBuffers[i]);
+        error |= clSetKernelArg(clKernels[i], 1, sizeof(cl_mem),
+                                &globalBuffers[i]);
+        error |= clSetKernelArg(clKernels[i], 2,
+                                localWorkGroupSize * sizeof(cl_uint), NULL);
+        test_error(error, "clSetKernelArg failed");
+
+        clEventWrapper event;
+        error = clEnqueueNDRangeKernel(dispatchQueue, clKernels[i], 1, NULL,
+                                       &globalWorkGroupSize,
+                                       &localWorkGroupSize, 0, NULL, &event);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clEnqueueReadBuffer(dispatchQueue, resultBuffers[i], CL_FALSE,
+                                    0, bufferSize,
+                                    &results[(size_t)i * num_elements], 1,
+                                    &event, NULL);
+        error |= clEnqueueReadBuffer(dispatchQueue, globalBuffers[i], CL_FALSE,
+                                     0, bufferSize,
+                                     &globals[(size_t)i * num_elements], 1,
+                                     &event, NULL);
+        test_error(error, "clEnqueueReadBuffer failed");
+    }
+    error = clFinish(dispatchQueue);
+    test_error(error, "clFinish failed");
+
+    int failedKernels = 0;
+    for (cl_uint i = 0; i < kernelCount; i++)
+    {
+        const cl_uint *kernelResults = &results[(size_t)i * num_elements];
+        const cl_uint *kernelGlobals = &globals[(size_t)i * num_elements];
+        size_t failures = 0;
+        size_t firstFailure = 0;
+        for (size_t tid = 0; tid < (size_t)num_elements; tid++)
+        {
+            cl_uint expected = (cl_uint)(3 * tid) + kernels[i].globalDelta;
+            if (kernelResults[tid] != 1 || kernelGlobals[tid] != expected)
+            {
+                if (failures++ == 0) firstFailure = tid;
+            }
+        }
+        if (failures)
+        {
+            log_error("Generated kernel #%u failed for %zu out of %d "
+                      "work-items, first at index %zu\n",
+                      i, failures, num_elements, firstFailure);
+            failedKernels++;
+        }
+    }
+    log_info("%d out of %u generated kernels failed\n", failedKernels,
+             kernelCount);
+
+    return failedKernels ? -1 : CL_SUCCESS;
+}
@@ -174,12 +174,19 @@ REGISTER_TEST(roundTrip)
     {
         count = (uint32_t)std::min((uint64_t)blockCount, lastCase - i);
 
+        void *mapped;
+        if( (error = BeginHostWrite(gInBuffer_half, count * sizeof( cl_half ), &mapped)) )
+        {
+            gFailCount++;
+            goto exit;
+        }
+
         //Init the input stream
         uint16_t *p = (uint16_t *)gIn_half;
         for( j = 0; j < count; j++ )
             p[j] = j + i;
 
-        if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer_half, CL_TRUE, 0, count * sizeof( cl_half ), gIn_half, 0, NULL, NULL)) )
+        if( (error = EndHostWrite(gInBuffer_half, CL_TRUE, count * sizeof( cl_half ), gIn_half, mapped)) )
         {
             vlog_error( "Failure in clWriteArray\n" );
             gFailCount++;
@@ -190,9 +197,14 @@ REGISTER_TEST(roundTrip)
         for( vectorSize = kMinVectorSize; vectorSize < kLastVectorSizeToTest; vectorSize++)
         { // here we loop through vector sizes -- 3 is last.
             uint32_t pattern = 0xdeaddead;
-            memset_pattern4( gOut_half, &pattern, (size_t)getBufferSize(device)/2);
+            if( (error = BeginHostWrite(gOutBuffer_half, count * sizeof(cl_half), &mapped)) )
+            {
+                gFailCount++;
+                goto exit;
+            }
+            memset_pattern4( gOut_half, &pattern, count * sizeof(cl_half));
 
-            if( (error = clEnqueueWriteBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+            if( (error = EndHostWrite(gOutBuffer_half, CL_TRUE, count * sizeof(cl_half), gOut_half, mapped)) )
             {
                 vlog_error( "Failure in clWriteArray\n" );
                 gFailCount++;
@@ -209,7 +221,7 @@ REGISTER_TEST(roundTrip)
                 goto exit;
             }
 
-            if( (error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+            if( (error = ReadHostBuffer(gOutBuffer_half, count * sizeof(cl_half), gOut_half)) )
             {
                 vlog_error( "Failure in clReadArray\n" );
                 gFailCount++;
@@ -246,8 +258,13 @@ REGISTER_TEST(roundTrip)
 
             if( gTestDouble )
             {
-                memset_pattern4( gOut_half, &pattern, (size_t)getBufferSize(device)/2);
-                if( (error = clEnqueueWriteBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+                if( (error = BeginHostWrite(gOutBuffer_half, count * sizeof(cl_half), &mapped)) )
+                {
+                    gFailCount++;
+                    goto exit;
+                }
+                memset_pattern4( gOut_half, &pattern, count * sizeof(cl_half));
+                if( (error = EndHostWrite(gOutBuffer_half, CL_TRUE, count * sizeof(cl_half), gOut_half, mapped)) )
                 {
                     vlog_error( "Failure in clWriteArray\n" );
                     gFailCount++;
@@ -262,7 +279,7 @@ REGISTER_TEST(roundTrip)
                     goto exit;
                 }
 
-                if( (error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+                if( (error = ReadHostBuffer(gOutBuffer_half, count * sizeof(cl_half), gOut_half)) )
                 {
                     vlog_error( "Failure in clReadArray\n" );
                     gFailCount++;
@@ -26,6 +26,62 @@
 
 #include <CL/cl_half.h>
 
+// Each vector size and address space combination gets its own queue and
+// output buffer so that all of them can be in flight at once.
+typedef struct LoadHalfLane_
+{
+    cl_command_queue queue;
+    cl_mem outBuffer;
+    float *out;
+    int vectorSize;
+    int addressSpace;
+} LoadHalfLane;
+
+typedef struct CheckLoadHalfInfo_
+{
+    const float *r;
+    const LoadHalfLane *lanes;
+    cl_uint *firstFailure;
+    cl_uint chunksPerLane;
+    cl_uint lim;
+    cl_uint count;
+} CheckLoadHalfInfo;
+
+// Job jid checks one chunk of one lane against the reference and records the
+// index of the first mismatch in firstFailure[jid], or lim if there is none.
+static cl_int CheckLoadHalf(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    CheckLoadHalfInfo *cri = (CheckLoadHalfInfo *)userInfo;
+    cl_uint lim = cri->lim;
+    cl_uint count = cri->count;
+    cl_uint off = (jid % cri->chunksPerLane) * count;
+    const float *r = cri->r;
+    const float *s = cri->lanes[jid / cri->chunksPerLane].out;
+    cl_uint j;
+
+    cri->firstFailure[jid] = lim;
+    if (off >= lim) return 0;
+    if (off + count > lim) count = lim - off;
+
+    if (!memcmp(r + off, s + off, count * sizeof(float))) return 0;
+
+    const uint32_t *u1 = (const uint32_t *)s;
+    const uint32_t *u2 = (const uint32_t *)r;
+    for (j = off; j < off + count; j++)
+    {
+        // both are nan dont compare them
+        if (isnan(s[j]) && isnan(r[j])) continue;
+
+        if (u1[j] != u2[j])
+        {
+            cri->firstFailure[jid] = j;
+            break;
+        }
+    }
+
+    return 0;
+}
+
 int Test_vLoadHalf_private( cl_device_id device, bool aligned )
 {
     cl_int error;
@@ -450,124 +506,233 @@ int Test_vLoadHalf_private( cl_device_id device, bool aligned )
     int addressSpace;
     //    int reported_vector_skip = 0;
 
+    cl_uint threadCount = GetThreadCount();
+    size_t laneSize = (size_t)std::min((uint64_t)blockCount, lastCase);
+    LoadHalfLane lanes[(kVectorSizeCount + kStrangeVectorSizeCount)
+                       * AS_NumAddressSpaces];
+    cl_uint laneCount = 0;
+    cl_uint k;
+    uint32_t pattern = 0x7fffdead;
+    float *patternBuf = (float *)malloc(laneSize * sizeof(float));
+    cl_uint *firstFailure = NULL;
+    CheckLoadHalfInfo chk;
+
+    memset(lanes, 0, sizeof(lanes));
+    if (NULL == patternBuf)
+    {
+        vlog_error("\t\tFAILED -- Unable to allocate the output pattern\n");
+        gFailCount++;
+        error = -1;
+        goto exit;
+    }
+    memset_pattern4(patternBuf, &pattern, laneSize * sizeof(float));
+
+    for (vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest;
+         vectorSize++)
+    {
+        for (addressSpace = 0; addressSpace < AS_NumAddressSpaces;
+             addressSpace++)
+        {
+            LoadHalfLane *lane = &lanes[laneCount++];
+            lane->vectorSize = vectorSize;
+            lane->addressSpace = addressSpace;
+
+            lane->queue = clCreateCommandQueue(gContext, device, 0, &error);
+            if (NULL == lane->queue)
+            {
+                vlog_error("clCreateCommandQueue failed. (%d)\n", error);
+                gFailCount++;
+                goto exit;
+            }
+
+            lane->outBuffer =
+                clCreateBuffer(gContext, CL_MEM_WRITE_ONLY,
+                               laneSize * sizeof(float), NULL, &error);
+            if (NULL == lane->outBuffer)
+            {
+                vlog_error("clCreateArray failed for output (%d)\n", error);
+                gFailCount++;
+                goto exit;
+            }
+
+            lane->out = (float *)malloc(laneSize * sizeof(float));
+            if (NULL == lane->out)
+            {
+                vlog_error("\t\tFAILED -- Unable to allocate lane output\n");
+                gFailCount++;
+                error = -1;
+                goto exit;
+            }
+        }
+    }
+
+    chk.r = (const float *)gOut_single_reference;
+    chk.lanes = lanes;
+    chk.chunksPerLane = threadCount;
+    firstFailure = (cl_uint *)malloc(laneCount * threadCount * sizeof(cl_uint));
+    chk.firstFailure = firstFailure;
+    if (NULL == firstFailure)
+    {
+        vlog_error("\t\tFAILED -- Unable to allocate check results\n");
+        gFailCount++;
+        error = -1;
+        goto exit;
+    }
+
     for( i = 0; i < (uint64_t)lastCase; i += blockCount )
     {
         count = (uint32_t)std::min((uint64_t)blockCount, lastCase - i);
 
+        void *mapped;
+        if( (error = BeginHostWrite(gInBuffer_half, count * sizeof( cl_half ), &mapped)))
+        {
+            gFailCount++;
+            goto exit;
+        }
+
         //Init the input stream
         uint16_t *p = (uint16_t *)gIn_half;
         for( j = 0; j < count; j++ )
             p[j] = j + i;
 
-        if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer_half, CL_TRUE, 0, count * sizeof( cl_half ), gIn_half, 0, NULL, NULL)))
+        if( (error = EndHostWrite(gInBuffer_half, CL_TRUE, count * sizeof( cl_half ), gIn_half, mapped)))
         {
             vlog_error( "Failure in clWriteArray\n" );
             gFailCount++;
             goto exit;
         }
 
-        //create the reference result
+        // The lanes read the input from other queues, so any unmap left
+        // behind by EndHostWrite has to complete first.
+        if( (error = clFinish(gQueue)) )
+        {
+            vlog_error( "Failure in clFinish\n" );
+            gFailCount++;
+            goto exit;
+        }
+
+        // Put every vector size and address space in flight at once
+        for (k = 0; k < laneCount; k++)
+        {
+            LoadHalfLane *lane = &lanes[k];
+            vectorSize = lane->vectorSize;
+            addressSpace = lane->addressSpace;
+
+            if ((error = clEnqueueWriteBuffer(lane->queue, lane->outBuffer,
+                                              CL_FALSE, 0,
+                                              count * sizeof(float), patternBuf,
+                                              0, NULL, NULL)))
+            {
+                vlog_error( "Failure in clWriteArray\n" );
+                gFailCount++;
+                goto exit;
+            }
+
+            // okay, here is where we have to be careful
+            if ((error = RunKernelOnQueue(
+                     lane->queue, device, kernels[vectorSize][addressSpace],
+                     gInBuffer_half, lane->outBuffer,
+                     numVecs(count, vectorSize, aligned),
+                     runsOverBy(count, vectorSize, aligned))))
+            {
+                gFailCount++;
+                goto exit;
+            }
+
+            if ((error = clEnqueueReadBuffer(lane->queue, lane->outBuffer,
+                                             CL_FALSE, 0, count * sizeof(float),
+                                             lane->out, 0, NULL, NULL)))
+            {
+                vlog_error( "Failure in clReadArray\n" );
+                gFailCount++;
+                goto exit;
+            }
+
+            if ((error = clFlush(lane->queue)))
+            {
+                vlog_error( "Failure in clFlush\n" );
+                gFailCount++;
+                goto exit;
+            }
+        }
+
+        //create the reference result while the device works
         const unsigned short *s = (const unsigned short *)gIn_half;
         float *d = (float *)gOut_single_reference;
         for (j = 0; j < count; j++) d[j] = cl_half_to_float(s[j]);
 
-        //Check the vector lengths
-        for( vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest; vectorSize++)
-        { // here we loop through vector sizes, 3 is last
-
-            for ( addressSpace = 0; addressSpace < AS_NumAddressSpaces; addressSpace++) {
-                uint32_t pattern = 0x7fffdead;
-
-                /*
-                 if (addressSpace == 3) {
-                 vlog("Note: skipping address space %s due to small buffer size.\n", addressSpaceNames[addressSpace]);
-                 continue;
-                 }
-                 */
-                memset_pattern4( gOut_single, &pattern, getBufferSize(device));
-                if( (error = clEnqueueWriteBuffer(gQueue, gOutBuffer_single, CL_TRUE, 0, count * sizeof( float ), gOut_single, 0, NULL, NULL)) )
-                {
-                    vlog_error( "Failure in clWriteArray\n" );
-                    gFailCount++;
-                    goto exit;
-                }
-
-                if(g_arrVecSizes[vectorSize] == 3 && !aligned) {
-                    // now we need to add the extra const argument for how
-                    // many elements the last thread should take care of.
-                }
+        for (k = 0; k < laneCount; k++)
+        {
+            if ((error = clFinish(lanes[k].queue)))
+            {
+                vlog_error( "Failure in clFinish\n" );
+                gFailCount++;
+                goto exit;
+            }
+        }
 
-                // okay, here is where we have to be careful
-                if( (error = RunKernel(device, kernels[vectorSize][addressSpace], gInBuffer_half, gOutBuffer_single, numVecs(count, vectorSize, aligned) ,
-                                       runsOverBy(count, vectorSize, aligned) ) ) )
-                {
-                    gFailCount++;
-                    goto exit;
-                }
+        // Check all lanes in parallel, then report the first failure in
+        // the order the sequential sweep would have found it.
+        chk.lim = count;
+        chk.count = (count + threadCount - 1) / threadCount;
+        if ((error = ThreadPool_Do(CheckLoadHalf, laneCount * threadCount,
+                                   &chk)))
+        {
+            gFailCount++;
+            goto exit;
+        }
 
-                if( (error = clEnqueueReadBuffer(gQueue, gOutBuffer_single, CL_TRUE, 0, count * sizeof( float ), gOut_single, 0, NULL, NULL)) )
-                {
-                    vlog_error( "Failure in clReadArray\n" );
-                    gFailCount++;
-                    goto exit;
-                }
+        for (k = 0; k < laneCount * threadCount; k++)
+        {
+            if (firstFailure[k] == count) continue;
+
+            const LoadHalfLane *lane = &lanes[k / threadCount];
+            uint32_t *u1 = (uint32_t *)lane->out;
+            uint32_t *u2 = (uint32_t *)gOut_single_reference;
+            float *f1 = lane->out;
+            float *f2 = (float *)gOut_single_reference;
+            j = firstFailure[k];
+            vlog_error(" %" PRId64
+                       ")  (of %u) Failure at 0x%4.4x:  %a vs *%a  "
+                       "(0x%8.8x vs *0x%8.8x)  vector_size = %d (%s) "
+                       "address space = %s, load is %s\n",
+                       j, count, ((unsigned short *)gIn_half)[j], f1[j], f2[j],
+                       u1[j], u2[j], (g_arrVecSizes[lane->vectorSize]),
+                       vector_size_names[lane->vectorSize],
+                       addressSpaceNames[lane->addressSpace],
+                       (aligned ? "aligned" : "unaligned"));
+            gFailCount++;
+            error = -1;
+            goto exit;
+        }
 
-                if( memcmp( gOut_single, gOut_single_reference, count * sizeof( float )) )
+        if( gReportTimes )
+        {
+            for( vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest; vectorSize++)
+            {
+                //Run again for timing
+                for( j = 0; j < 100; j++ )
                 {
-                    uint32_t *u1 = (uint32_t *)gOut_single;
-                    uint32_t *u2 = (uint32_t *)gOut_single_reference;
-                    float *f1 = (float *)gOut_single;
-                    float *f2 = (float *)gOut_single_reference;
-                    for( j = 0; j < count; j++ )
+                    uint64_t startTime = ReadTime();
+                    error =
+                    RunKernel(device, kernels[vectorSize][0], gInBuffer_half, gOutBuffer_single, numVecs(count, vectorSize, aligned) ,
+                              runsOverBy(count, vectorSize, aligned));
+                    if(error)
                     {
-                        if(isnan(f1[j]) && isnan(f2[j])) // both are nan dont compare them
-                            continue;
-                        if( u1[j] != u2[j])
-                        {
-                            vlog_error(
-                                " %" PRId64
-                                ")  (of %u) Failure at 0x%4.4x:  %a vs *%a  "
-                                "(0x%8.8x vs *0x%8.8x)  vector_size = %d (%s) "
-                                "address space = %s, load is %s\n",
-                                j, count, ((unsigned short *)gIn_half)[j],
-                                f1[j], f2[j], u1[j], u2[j],
-                                (g_arrVecSizes[vectorSize]),
-                                vector_size_names[vectorSize],
-                                addressSpaceNames[addressSpace],
-                                (aligned ? "aligned" : "unaligned"));
-                            gFailCount++;
-                            error = -1;
-                            goto exit;
-                        }
+                        gFailCount++;
+                        goto exit;
                     }
-                }
 
-                if( gReportTimes && addressSpace == 0)
-                {
-                    //Run again for timing
-                    for( j = 0; j < 100; j++ )
+                    if( (error = clFinish(gQueue)) )
                     {
-                        uint64_t startTime = ReadTime();
-                        error =
-                        RunKernel(device, kernels[vectorSize][addressSpace], gInBuffer_half, gOutBuffer_single, numVecs(count, vectorSize, aligned) ,
-                                  runsOverBy(count, vectorSize, aligned));
-                        if(error)
-                        {
-                            gFailCount++;
-                            goto exit;
-                        }
-
-                        if( (error = clFinish(gQueue)) )
-                        {
-                            vlog_error( "Failure in clFinish\n" );
-                            gFailCount++;
-                            goto exit;
-                        }
-                        uint64_t currentTime = ReadTime() - startTime;
-                        time[ vectorSize ] += currentTime;
-                        if( currentTime < min_time[ vectorSize ] )
-                            min_time[ vectorSize ] = currentTime ;
+                        vlog_error( "Failure in clFinish\n" );
+                        gFailCount++;
+                        goto exit;
                     }
+                    uint64_t currentTime = ReadTime() - startTime;
+                    time[ vectorSize ] += currentTime;
+                    if( currentTime < min_time[ vectorSize ] )
+                        min_time[ vectorSize ] = currentTime ;
                 }
             }
         }
@@ -593,6 +758,15 @@ int Test_vLoadHalf_private( cl_device_id device, bool aligned )
 
 exit:
     //clean up
+    for (k = 0; k < laneCount; k++)
+    {
+        if (lanes[k].queue) clReleaseCommandQueue(lanes[k].queue);
+        if (lanes[k].outBuffer) clReleaseMemObject(lanes[k].outBuffer);
+        free(lanes[k].out);
+    }
+    free(patternBuf);
+    free(firstFailure);
+
     for( vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest; vectorSize++)
     {
         for ( addressSpace = 0; addressSpace < AS_NumAddressSpaces; addressSpace++) {
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "harness/compat.h"
+#include "harness/halfHelpers.h"
 #include "harness/kernelHelpers.h"
 #include "harness/testHarness.h"
 
@@ -30,7 +31,7 @@ typedef struct ComputeReferenceInfoF_
 {
     float *x;
     cl_ushort *r;
-    f2h f;
+    cl_half_rounding_mode mode;
     cl_ulong i;
     cl_uint lim;
     cl_uint count;
@@ -40,7 +41,7 @@ typedef struct ComputeReferenceInfoD_
 {
     double *x;
     cl_ushort *r;
-    d2h f;
+    cl_half_rounding_mode mode;
     cl_ulong i;
     cl_uint lim;
     cl_uint count;
@@ -51,7 +52,7 @@ typedef struct CheckResultInfoF_
     const float *x;
     const cl_ushort *r;
     const cl_ushort *s;
-    f2h f;
+    cl_half_rounding_mode mode;
     const char *aspace;
     cl_uint lim;
     cl_uint count;
@@ -63,7 +64,7 @@ typedef struct CheckResultInfoD_
     const double *x;
     const cl_ushort *r;
     const cl_ushort *s;
-    d2h f;
+    cl_half_rounding_mode mode;
     const char *aspace;
     cl_uint lim;
     cl_uint count;
@@ -78,17 +79,14 @@ static cl_int ReferenceF(cl_uint jid, cl_uint tid, void *userInfo)
     cl_uint off = jid * count;
     float *x = cri->x + off;
     cl_ushort *r = cri->r + off;
-    f2h f = cri->f;
     cl_ulong i = cri->i + off;
     cl_uint j;
 
     if (off + count > lim) count = lim - off;
 
-    for (j = 0; j < count; ++j)
-    {
-        x[j] = as_float((cl_uint)(i + j));
-        r[j] = f(x[j]);
-    }
+    for (j = 0; j < count; ++j) x[j] = as_float((cl_uint)(i + j));
+
+    float_to_half_array(r, x, count, cri->mode);
 
     return 0;
 }
@@ -102,10 +100,9 @@ static cl_int CheckF(cl_uint jid, cl_uint tid, void *userInfo)
     const float *x = cri->x + off;
     const cl_ushort *r = cri->r + off;
     const cl_ushort *s = cri->s + off;
-    f2h f = cri->f;
     cl_uint j;
-    cl_ushort correct2 = f(0.0f);
-    cl_ushort correct3 = f(-0.0f);
+    cl_ushort correct2 = cl_half_from_float(0.0f, cri->mode);
+    cl_ushort correct3 = cl_half_from_float(-0.0f, cri->mode);
     cl_int ret = 0;
 
     if (off + count > lim) count = lim - off;
@@ -147,17 +144,15 @@ static cl_int ReferenceD(cl_uint jid, cl_uint tid, void *userInfo)
     cl_uint off = jid * count;
     double *x = cri->x + off;
     cl_ushort *r = cri->r + off;
-    d2h f = cri->f;
     cl_uint j;
     cl_ulong i = cri->i + off;
 
     if (off + count > lim) count = lim - off;
 
     for (j = 0; j < count; ++j)
-    {
         x[j] = as_double(DoubleFromUInt((cl_uint)(i + j)));
-        r[j] = f(x[j]);
-    }
+
+    double_to_half_array(r, x, count, cri->mode);
 
     return 0;
 }
@@ -171,10 +166,9 @@ static cl_int CheckD(cl_uint jid, cl_uint tid, void *userInfo)
     const double *x = cri->x + off;
     const cl_ushort *r = cri->r + off;
     const cl_ushort *s = cri->s + off;
-    d2h f = cri->f;
     cl_uint j;
-    cl_ushort correct2 = f(0.0);
-    cl_ushort correct3 = f(-0.0);
+    cl_ushort correct2 = cl_half_from_double(0.0, cri->mode);
+    cl_ushort correct3 = cl_half_from_double(-0.0, cri->mode);
     cl_int ret = 0;
 
     if (off + count > lim) count = lim - off;
@@ -207,82 +201,38 @@ static cl_int CheckD(cl_uint jid, cl_uint tid, void *userInfo)
     return ret;
 }
 
-static cl_half float2half_rte(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTE);
-}
-
-static cl_half float2half_rtz(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTZ);
-}
-
-static cl_half float2half_rtp(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTP);
-}
-
-static cl_half float2half_rtn(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTN);
-}
-
-static cl_half double2half_rte(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTE);
-}
-
-static cl_half double2half_rtz(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTZ);
-}
-
-static cl_half double2half_rtp(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTP);
-}
-
-static cl_half double2half_rtn(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTN);
-}
-
 REGISTER_TEST(vstore_half)
 {
     switch (get_default_rounding_mode(device))
     {
         case CL_FP_ROUND_TO_ZERO:
-            return Test_vStoreHalf_private(device, float2half_rtz,
-                                           double2half_rte, "");
+            return Test_vStoreHalf_private(device, CL_HALF_RTZ, CL_HALF_RTE,
+                                           "");
         case 0: return -1;
         default:
-            return Test_vStoreHalf_private(device, float2half_rte,
-                                           double2half_rte, "");
+            return Test_vStoreHalf_private(device, CL_HALF_RTE, CL_HALF_RTE,
+                                           "");
     }
 }
 
 REGISTER_TEST(vstore_half_rte)
 {
-    return Test_vStoreHalf_private(device, float2half_rte, double2half_rte,
-                                   "_rte");
+    return Test_vStoreHalf_private(device, CL_HALF_RTE, CL_HALF_RTE, "_rte");
 }
 
 REGISTER_TEST(vstore_half_rtz)
 {
-    return Test_vStoreHalf_private(device, float2half_rtz, double2half_rtz,
-                                   "_rtz");
+    return Test_vStoreHalf_private(device, CL_HALF_RTZ, CL_HALF_RTZ, "_rtz");
 }
 
 REGISTER_TEST(vstore_half_rtp)
 {
-    return Test_vStoreHalf_private(device, float2half_rtp, double2half_rtp,
-                                   "_rtp");
+    return Test_vStoreHalf_private(device, CL_HALF_RTP, CL_HALF_RTP, "_rtp");
 }
 
 REGISTER_TEST(vstore_half_rtn)
 {
-    return Test_vStoreHalf_private(device, float2half_rtn, double2half_rtn,
-                                   "_rtn");
+    return Test_vStoreHalf_private(device, CL_HALF_RTN, CL_HALF_RTN, "_rtn");
 }
 
 REGISTER_TEST(vstorea_half)
@@ -290,43 +240,41 @@ REGISTER_TEST(vstorea_half)
     switch (get_default_rounding_mode(device))
     {
         case CL_FP_ROUND_TO_ZERO:
-            return Test_vStoreaHalf_private(device, float2half_rtz,
-                                            double2half_rte, "");
+            return Test_vStoreaHalf_private(device, CL_HALF_RTZ, CL_HALF_RTE,
+                                            "");
         case 0: return -1;
         default:
-            return Test_vStoreaHalf_private(device, float2half_rte,
-                                            double2half_rte, "");
+            return Test_vStoreaHalf_private(device, CL_HALF_RTE, CL_HALF_RTE,
+                                            "");
     }
 }
 
 REGISTER_TEST(vstorea_half_rte)
 {
-    return Test_vStoreaHalf_private(device, float2half_rte, double2half_rte,
-                                    "_rte");
+    return Test_vStoreaHalf_private(device, CL_HALF_RTE, CL_HALF_RTE, "_rte");
 }
 
 REGISTER_TEST(vstorea_half_rtz)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtz, double2half_rtz,
-                                    "_rtz");
+    return Test_vStoreaHalf_private(device, CL_HALF_RTZ, CL_HALF_RTZ, "_rtz");
 }
 
 REGISTER_TEST(vstorea_half_rtp)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtp, double2half_rtp,
-                                    "_rtp");
+    return Test_vStoreaHalf_private(device, CL_HALF_RTP, CL_HALF_RTP, "_rtp");
 }
 
 REGISTER_TEST(vstorea_half_rtn)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtn, double2half_rtn,
-                                    "_rtn");
+    return Test_vStoreaHalf_private(device, CL_HALF_RTN, CL_HALF_RTN, "_rtn");
 }
 
 #pragma mark -
 
-int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
-                            d2h doubleReferenceFunc, const char *roundName)
+int Test_vStoreHalf_private(cl_device_id device,
+                            cl_half_rounding_mode roundingMode,
+                            cl_half_rounding_mode doubleRoundingMode,
+                            const char *roundName)
 {
     int vectorSize, error;
     cl_program programs[kVectorSizeCount + kStrangeVectorSizeCount][3];
@@ -863,7 +811,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     ComputeReferenceInfoF fref;
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
-    fref.f = referenceFunc;
+    fref.mode = roundingMode;
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -871,14 +819,14 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     fchk.x = (const float *)gIn_single;
     fchk.r = (const cl_half *)gOut_half_reference;
     fchk.s = (const cl_half *)gOut_half;
-    fchk.f = referenceFunc;
+    fchk.mode = roundingMode;
     fchk.lim = blockCount;
     fchk.count = (blockCount + threadCount - 1) / threadCount;
 
     ComputeReferenceInfoD dref;
     dref.x = (double *)gIn_double;
     dref.r = (cl_half *)gOut_half_reference_double;
-    dref.f = doubleReferenceFunc;
+    dref.mode = doubleRoundingMode;
     dref.lim = blockCount;
     dref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -886,7 +834,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.x = (const double *)gIn_double;
     dchk.r = (const cl_half *)gOut_half_reference_double;
     dchk.s = (const cl_half *)gOut_half;
-    dchk.f = doubleReferenceFunc;
+    dchk.mode = doubleRoundingMode;
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -896,12 +844,20 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
         fref.i = i;
         dref.i = i;
 
+        void *mappedF;
+        error = BeginHostWrite(gInBuffer_single, count * sizeof(float),
+                               &mappedF);
+        if (error)
+        {
+            gFailCount++;
+            goto exit;
+        }
+
         // Compute the input and reference
         ThreadPool_Do(ReferenceF, threadCount, &fref);
 
-        error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_FALSE, 0,
-                                     count * sizeof(float), gIn_single, 0, NULL,
-                                     NULL);
+        error = EndHostWrite(gInBuffer_single, CL_FALSE, count * sizeof(float),
+                             gIn_single, mappedF);
         if (error)
         {
             vlog_error("Failure in clWriteBuffer\n");
@@ -911,11 +867,19 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
 
         if (gTestDouble)
         {
+            void *mappedD;
+            error = BeginHostWrite(gInBuffer_double, count * sizeof(double),
+                                   &mappedD);
+            if (error)
+            {
+                gFailCount++;
+                goto exit;
+            }
+
             ThreadPool_Do(ReferenceD, threadCount, &dref);
 
-            error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_FALSE, 0,
-                                         count * sizeof(double), gIn_double, 0,
-                                         NULL, NULL);
+            error = EndHostWrite(gInBuffer_double, CL_FALSE,
+                                 count * sizeof(double), gIn_double, mappedD);
             if (error)
             {
                 vlog_error("Failure in clWriteBuffer\n");
@@ -945,11 +909,17 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
                 else
                 {
                     cl_uint pattern = 0xdeaddead;
-                    memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                    error = clEnqueueWriteBuffer(
-                        gQueue, gOutBuffer_half, CL_FALSE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
+                    void *mapped;
+                    error = BeginHostWrite(gOutBuffer_half,
+                                           count * sizeof(cl_half), &mapped);
+                    if (!error)
+                    {
+                        memset_pattern4(gOut_half, &pattern,
+                                        count * sizeof(cl_half));
+                        error = EndHostWrite(gOutBuffer_half, CL_FALSE,
+                                             count * sizeof(cl_half),
+                                             gOut_half, mapped);
+                    }
                 }
                 if (error)
                 {
@@ -968,9 +938,8 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
                     goto exit;
                 }
 
-                error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0,
-                                            count * sizeof(cl_half), gOut_half,
-                                            0, NULL, NULL);
+                error = ReadHostBuffer(gOutBuffer_half, count * sizeof(cl_half),
+                                       gOut_half);
                 if (error)
                 {
                     vlog_error("Failure in clReadArray\n");
@@ -996,11 +965,18 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
                     else
                     {
                         cl_uint pattern = 0xdeaddead;
-                        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                        error = clEnqueueWriteBuffer(
-                            gQueue, gOutBuffer_half, CL_FALSE, 0,
-                            count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
+                        void *mapped;
+                        error = BeginHostWrite(gOutBuffer_half,
+                                               count * sizeof(cl_half),
+                                               &mapped);
+                        if (!error)
+                        {
+                            memset_pattern4(gOut_half, &pattern,
+                                            count * sizeof(cl_half));
+                            error = EndHostWrite(gOutBuffer_half, CL_FALSE,
+                                                 count * sizeof(cl_half),
+                                                 gOut_half, mapped);
+                        }
                     }
                     if (error)
                     {
@@ -1020,9 +996,8 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
                         goto exit;
                     }
 
-                    error = clEnqueueReadBuffer(
-                        gQueue, gOutBuffer_half, CL_TRUE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
+                    error = ReadHostBuffer(gOutBuffer_half,
+                                           count * sizeof(cl_half), gOut_half);
                     if (error)
                     {
                         vlog_error("Failure in clReadArray\n");
@@ -1051,14 +1026,21 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     loopCount = count == blockCount ? 1 : 100;
     if (gReportTimes)
     {
+        void *mappedF;
+        if ((error = BeginHostWrite(gInBuffer_single, count * sizeof(float),
+                                    &mappedF)))
+        {
+            gFailCount++;
+            goto exit;
+        }
+
         // Init the input stream
         cl_float *p = (cl_float *)gIn_single;
         for (j = 0; j < count; j++)
             p[j] = (float)((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_TRUE, 0,
-                                          count * sizeof(float), gIn_single, 0,
-                                          NULL, NULL)))
+        if ((error = EndHostWrite(gInBuffer_single, CL_TRUE,
+                                  count * sizeof(float), gIn_single, mappedF)))
         {
             vlog_error("Failure in clWriteArray\n");
             gFailCount++;
@@ -1067,14 +1049,22 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
 
         if (gTestDouble)
         {
+            void *mappedD;
+            if ((error = BeginHostWrite(gInBuffer_double,
+                                        count * sizeof(double), &mappedD)))
+            {
+                gFailCount++;
+                goto exit;
+            }
+
             // Init the input stream
             cl_double *q = (cl_double *)gIn_double;
             for (j = 0; j < count; j++)
                 q[j] = ((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-            if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_TRUE,
-                                              0, count * sizeof(double),
-                                              gIn_double, 0, NULL, NULL)))
+            if ((error = EndHostWrite(gInBuffer_double, CL_TRUE,
+                                      count * sizeof(double), gIn_double,
+                                      mappedD)))
             {
                 vlog_error("Failure in clWriteArray\n");
                 gFailCount++;
@@ -1209,8 +1199,10 @@ exit:
     return error;
 }
 
-int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
-                             d2h doubleReferenceFunc, const char *roundName)
+int Test_vStoreaHalf_private(cl_device_id device,
+                             cl_half_rounding_mode roundingMode,
+                             cl_half_rounding_mode doubleRoundingMode,
+                             const char *roundName)
 {
     int vectorSize, error;
     cl_program programs[kVectorSizeCount + kStrangeVectorSizeCount][3];
@@ -1709,7 +1701,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     ComputeReferenceInfoF fref;
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
-    fref.f = referenceFunc;
+    fref.mode = roundingMode;
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1717,14 +1709,14 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     fchk.x = (const float *)gIn_single;
     fchk.r = (const cl_half *)gOut_half_reference;
     fchk.s = (const cl_half *)gOut_half;
-    fchk.f = referenceFunc;
+    fchk.mode = roundingMode;
     fchk.lim = blockCount;
     fchk.count = (blockCount + threadCount - 1) / threadCount;
 
     ComputeReferenceInfoD dref;
     dref.x = (double *)gIn_double;
     dref.r = (cl_half *)gOut_half_reference_double;
-    dref.f = doubleReferenceFunc;
+    dref.mode = doubleRoundingMode;
     dref.lim = blockCount;
     dref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1732,7 +1724,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.x = (const double *)gIn_double;
     dchk.r = (const cl_half *)gOut_half_reference_double;
     dchk.s = (const cl_half *)gOut_half;
-    dchk.f = doubleReferenceFunc;
+    dchk.mode = doubleRoundingMode;
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1742,12 +1734,20 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
         fref.i = i;
         dref.i = i;
 
+        void *mappedF;
+        error = BeginHostWrite(gInBuffer_single, count * sizeof(float),
+                               &mappedF);
+        if (error)
+        {
+            gFailCount++;
+            goto exit;
+        }
+
         // Create the input and reference
         ThreadPool_Do(ReferenceF, threadCount, &fref);
 
-        error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_FALSE, 0,
-                                     count * sizeof(float), gIn_single, 0, NULL,
-                                     NULL);
+        error = EndHostWrite(gInBuffer_single, CL_FALSE, count * sizeof(float),
+                             gIn_single, mappedF);
         if (error)
         {
             vlog_error("Failure in clWriteArray\n");
@@ -1757,11 +1757,19 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
 
         if (gTestDouble)
         {
+            void *mappedD;
+            error = BeginHostWrite(gInBuffer_double, count * sizeof(double),
+                                   &mappedD);
+            if (error)
+            {
+                gFailCount++;
+                goto exit;
+            }
+
             ThreadPool_Do(ReferenceD, threadCount, &dref);
 
-            error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_FALSE, 0,
-                                         count * sizeof(double), gIn_double, 0,
-                                         NULL, NULL);
+            error = EndHostWrite(gInBuffer_double, CL_FALSE,
+                                 count * sizeof(double), gIn_double, mappedD);
             if (error)
             {
                 vlog_error("Failure in clWriteArray\n");
@@ -1791,11 +1799,17 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
                 else
                 {
                     cl_uint pattern = 0xdeaddead;
-                    memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                    error = clEnqueueWriteBuffer(
-                        gQueue, gOutBuffer_half, CL_FALSE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
+                    void *mapped;
+                    error = BeginHostWrite(gOutBuffer_half,
+                                           count * sizeof(cl_half), &mapped);
+                    if (!error)
+                    {
+                        memset_pattern4(gOut_half, &pattern,
+                                        count * sizeof(cl_half));
+                        error = EndHostWrite(gOutBuffer_half, CL_FALSE,
+                                             count * sizeof(cl_half),
+                                             gOut_half, mapped);
+                    }
                 }
                 if (error)
                 {
@@ -1814,9 +1828,8 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
                     goto exit;
                 }
 
-                error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0,
-                                            count * sizeof(cl_half), gOut_half,
-                                            0, NULL, NULL);
+                error = ReadHostBuffer(gOutBuffer_half, count * sizeof(cl_half),
+                                       gOut_half);
                 if (error)
                 {
                     vlog_error("Failure in clReadArray\n");
@@ -1842,11 +1855,18 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
                     else
                     {
                         cl_uint pattern = 0xdeaddead;
-                        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                        error = clEnqueueWriteBuffer(
-                            gQueue, gOutBuffer_half, CL_FALSE, 0,
-                            count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
+                        void *mapped;
+                        error = BeginHostWrite(gOutBuffer_half,
+                                               count * sizeof(cl_half),
+                                               &mapped);
+                        if (!error)
+                        {
+                            memset_pattern4(gOut_half, &pattern,
+                                            count * sizeof(cl_half));
+                            error = EndHostWrite(gOutBuffer_half, CL_FALSE,
+                                                 count * sizeof(cl_half),
+                                                 gOut_half, mapped);
+                        }
                     }
                     if (error)
                     {
@@ -1866,9 +1886,8 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
                         goto exit;
                     }
 
-                    error = clEnqueueReadBuffer(
-                        gQueue, gOutBuffer_half, CL_TRUE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
+                    error = ReadHostBuffer(gOutBuffer_half,
+                                           count * sizeof(cl_half), gOut_half);
                     if (error)
                     {
                         vlog_error("Failure in clReadArray\n");
@@ -1896,14 +1915,21 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     loopCount = count == blockCount ? 1 : 100;
     if (gReportTimes)
     {
+        void *mappedF;
+        if ((error = BeginHostWrite(gInBuffer_single, count * sizeof(float),
+                                    &mappedF)))
+        {
+            gFailCount++;
+            goto exit;
+        }
+
         // Init the input stream
         cl_float *p = (cl_float *)gIn_single;
         for (j = 0; j < count; j++)
             p[j] = (float)((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_TRUE, 0,
-                                          count * sizeof(float), gIn_single, 0,
-                                          NULL, NULL)))
+        if ((error = EndHostWrite(gInBuffer_single, CL_TRUE,
+                                  count * sizeof(float), gIn_single, mappedF)))
         {
             vlog_error("Failure in clWriteArray\n");
             gFailCount++;
@@ -1912,14 +1938,22 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
 
         if (gTestDouble)
         {
+            void *mappedD;
+            if ((error = BeginHostWrite(gInBuffer_double,
+                                        count * sizeof(double), &mappedD)))
+            {
+                gFailCount++;
+                goto exit;
+            }
+
             // Init the input stream
             cl_double *q = (cl_double *)gIn_double;
             for (j = 0; j < count; j++)
                 q[j] = ((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-            if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_TRUE,
-                                              0, count * sizeof(double),
-                                              gIn_double, 0, NULL, NULL)))
+            if ((error = EndHostWrite(gInBuffer_double, CL_TRUE,
+                                      count * sizeof(double), gIn_double,
+                                      mappedD)))
             {
                 vlog_error("Failure in clWriteArray\n");
                 gFailCount++;
@@ -23,6 +23,8 @@
 #include "test_config.h"
 #include "string.h"
 #include "harness/kernelHelpers.h"
+#include "harness/hostArrays.h"
+#include "harness/halfHelpers.h"
 
 #include "harness/testHarness.h"
 
@@ -62,6 +64,8 @@ bool gWimpyMode = false;
 int gWimpyReductionFactor = 512;
 int gTestDouble = 0;
 bool gHostReset = false;
+bool gUseHostPtr = false;
+static HostArrayAllocator gHostArrays;
 
 #if defined( __APPLE__ )
 int gReportTimes = 1;
@@ -119,15 +123,17 @@ test_status InitCL( cl_device_id device )
 #if defined( __APPLE__ )
     // FIXME: use clProtectedArray
 #endif
+    gHostArrays.Init(gContext, device, gUseHostPtr);
+
     //Allocate buffers
-    gIn_half   = malloc( getBufferSize(device)/2  );
-    gOut_half = malloc( BUFFER_SIZE/2  );
+    gIn_half   = gHostArrays.Alloc( getBufferSize(device)/2  );
+    gOut_half = gHostArrays.Alloc( BUFFER_SIZE/2  );
     gOut_half_reference = malloc( BUFFER_SIZE/2  );
     gOut_half_reference_double = malloc( BUFFER_SIZE/2  );
-    gIn_single   = malloc( BUFFER_SIZE );
-    gOut_single = malloc( getBufferSize(device)  );
+    gIn_single   = gHostArrays.Alloc( BUFFER_SIZE );
+    gOut_single = gHostArrays.Alloc( getBufferSize(device)  );
     gOut_single_reference = malloc( getBufferSize(device)  );
-    gIn_double   = malloc( 2*BUFFER_SIZE  );
+    gIn_double   = gHostArrays.Alloc( 2*BUFFER_SIZE  );
     // gOut_double = malloc( (2*getBufferSize(device))  );
     // gOut_double_reference = malloc( (2*getBufferSize(device))  );
 
@@ -140,37 +146,40 @@ test_status InitCL( cl_device_id device )
      NULL == gOut_single_reference ||
          NULL == gIn_double // || NULL == gOut_double || NULL == gOut_double_reference
          )
+    {
+        vlog_error( "Failed to allocate the host arrays\n" );
         return TEST_FAIL;
+    }
 
-    gInBuffer_half = clCreateBuffer(gContext, CL_MEM_READ_ONLY, getBufferSize(device) / 2, NULL, &error);
+    gInBuffer_half = gHostArrays.CreateBuffer(CL_MEM_READ_ONLY, getBufferSize(device) / 2, gIn_half, &error);
     if( gInBuffer_half == NULL )
     {
         vlog_error( "clCreateArray failed for input (%d)\n", error );
         return TEST_FAIL;
     }
 
-    gInBuffer_single = clCreateBuffer(gContext, CL_MEM_READ_ONLY, BUFFER_SIZE, NULL, &error );
+    gInBuffer_single = gHostArrays.CreateBuffer(CL_MEM_READ_ONLY, BUFFER_SIZE, gIn_single, &error );
     if( gInBuffer_single == NULL )
     {
         vlog_error( "clCreateArray failed for input (%d)\n", error );
         return TEST_FAIL;
     }
 
-    gInBuffer_double = clCreateBuffer(gContext, CL_MEM_READ_ONLY, BUFFER_SIZE*2, NULL, &error );
+    gInBuffer_double = gHostArrays.CreateBuffer(CL_MEM_READ_ONLY, BUFFER_SIZE*2, gIn_double, &error );
     if( gInBuffer_double == NULL )
     {
         vlog_error( "clCreateArray failed for input (%d)\n", error );
         return TEST_FAIL;
     }
 
-    gOutBuffer_half = clCreateBuffer(gContext, CL_MEM_WRITE_ONLY, BUFFER_SIZE/2, NULL, &error );
+    gOutBuffer_half = gHostArrays.CreateBuffer(CL_MEM_WRITE_ONLY, BUFFER_SIZE/2, gOut_half, &error );
     if( gOutBuffer_half == NULL )
     {
         vlog_error( "clCreateArray failed for output (%d)\n", error );
         return TEST_FAIL;
     }
 
-    gOutBuffer_single = clCreateBuffer(gContext, CL_MEM_WRITE_ONLY, getBufferSize(device), NULL, &error );
+    gOutBuffer_single = gHostArrays.CreateBuffer(CL_MEM_WRITE_ONLY, getBufferSize(device), gOut_single, &error );
     if( gOutBuffer_single == NULL )
     {
         vlog_error( "clCreateArray failed for output (%d)\n", error );
@@ -202,6 +211,10 @@ test_status InitCL( cl_device_id device )
     vlog( "\tDevice Frequency: %d MHz\n", gDeviceFrequency );
     vlog( "\tHas double? %s\n", hasDouble ? "YES" : "NO" );
     vlog( "\tTest double? %s\n", gTestDouble ? "YES" : "NO" );
+    vlog("\tHost float to half conversions: %s\n",
+         get_float_to_half_engine_name());
+    vlog("\tZero-copy host buffers? %s%s\n", gUseHostPtr ? "YES" : "NO",
+         gHostArrays.UsesSVM() ? " (fine-grain SVM)" : "");
 
     return TEST_PASS;
 }
@@ -250,17 +263,41 @@ void ReleaseCL(void)
     clReleaseMemObject(gOutBuffer_single);
     clReleaseMemObject(gInBuffer_double);
     // clReleaseMemObject(gOutBuffer_double);
+
+    if (gUseHostPtr)
+        vlog("Zero-copy host buffers saved %llu bytes of buffer copies.\n",
+             (unsigned long long)gHostArrays.BytesSaved());
+
+    // SVM backed arrays must go before the context does
+    gHostArrays.Free(gIn_half);
+    gHostArrays.Free(gOut_half);
+    gHostArrays.Free(gIn_single);
+    gHostArrays.Free(gOut_single);
+    gHostArrays.Free(gIn_double);
+
     clReleaseCommandQueue(gQueue);
     clReleaseContext(gContext);
 
-    free(gIn_half);
-    free(gOut_half);
     free(gOut_half_reference);
     free(gOut_half_reference_double);
-    free(gIn_single);
-    free(gOut_single);
     free(gOut_single_reference);
-    free(gIn_double);
+}
+
+int BeginHostWrite(cl_mem buffer, size_t size, void **mapped)
+{
+    return gHostArrays.BeginWrite(gQueue, buffer, size, mapped);
+}
+
+int EndHostWrite(cl_mem buffer, cl_bool blocking, size_t size,
+                 const void *hostPtr, void *mapped)
+{
+    return gHostArrays.EndWrite(gQueue, buffer, blocking, size, hostPtr,
+                                mapped);
+}
+
+int ReadHostBuffer(cl_mem buffer, size_t size, void *hostPtr)
+{
+    return gHostArrays.Read(gQueue, buffer, size, hostPtr);
 }
 
 cl_uint numVecs(cl_uint count, int vectorSizeIdx, bool aligned) {
@@ -284,6 +321,14 @@ void printSource(const char * src[], int len) {
 }
 
 int RunKernel( cl_device_id device, cl_kernel kernel, void *inBuf, void *outBuf, uint32_t blockCount , int extraArg)
+{
+    return RunKernelOnQueue(gQueue, device, kernel, inBuf, outBuf, blockCount,
+                            extraArg);
+}
+
+int RunKernelOnQueue(cl_command_queue queue, cl_device_id device,
+                     cl_kernel kernel, void *inBuf, void *outBuf,
+                     uint32_t blockCount, int extraArg)
 {
     size_t localCount = blockCount;
     size_t wg_size;
@@ -313,7 +358,7 @@ int RunKernel( cl_device_id device, cl_kernel kernel, void *inBuf, void *outBuf,
     while( localCount % wg_size )
         wg_size--;
 
-    if( (error = clEnqueueNDRangeKernel( gQueue, kernel, 1, NULL, &localCount, &wg_size, 0, NULL, NULL )) )
+    if( (error = clEnqueueNDRangeKernel( queue, kernel, 1, NULL, &localCount, &wg_size, 0, NULL, NULL )) )
     {
         vlog_error( "FAILED -- could not execute kernel\n" );
         return -5;
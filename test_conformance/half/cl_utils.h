@@ -71,6 +71,10 @@ extern int gTestDouble;
 extern int gReportTimes;
 extern bool gHostReset;
 
+// gUseHostPtr wraps the host arrays above in CL_MEM_USE_HOST_PTR buffers so
+// that the host write and read helpers only need to map and unmap them.
+extern bool gUseHostPtr;
+
 // gWimpyMode indicates if we run the test in wimpy mode where we limit the
 // size of 32 bit ranges to a much smaller set.  This is meant to be used
 // as a smoke test
@@ -93,6 +97,18 @@ extern const char *align_types[kVectorSizeCount+kStrangeVectorSizeCount];
 test_status InitCL( cl_device_id device );
 void ReleaseCL( void );
 int RunKernel( cl_device_id device, cl_kernel kernel, void *inBuf, void *outBuf, uint32_t blockCount , int extraArg);
+// Like RunKernel, but enqueues on queue instead of gQueue. The kernel
+// arguments are set here, so callers that share a kernel between threads must
+// serialize calls for it.
+int RunKernelOnQueue(cl_command_queue queue, cl_device_id device,
+                     cl_kernel kernel, void *inBuf, void *outBuf,
+                     uint32_t blockCount, int extraArg);
+// Fill hostPtr between BeginHostWrite and EndHostWrite. See
+// HostArrayAllocator.
+int BeginHostWrite(cl_mem buffer, size_t size, void **mapped);
+int EndHostWrite(cl_mem buffer, cl_bool blocking, size_t size,
+                 const void *hostPtr, void *mapped);
+int ReadHostBuffer(cl_mem buffer, size_t size, void *hostPtr);
 cl_program MakeProgram( cl_device_id device, const char *source[], int count );
 
 static inline float as_float(cl_uint u) { union { cl_uint u; float f; }v; v.u = u; return v.f; }
@@ -181,6 +181,8 @@ static int ParseArgs( int argc, const char **argv )
 
                     case 'r': gHostReset = true; break;
 
+                    case 'u': gUseHostPtr = !gUseHostPtr; break;
+
                     case 'w':  // Wimpy mode
                         gWimpyMode = true;
                         break;
@@ -222,11 +224,13 @@ static int ParseArgs( int argc, const char **argv )
 
 static void PrintUsage( void )
 {
-    vlog("%s [-dthw]: <optional: test names>\n", appName);
+    vlog("%s [-dthruw]: <optional: test names>\n", appName);
     vlog("\t\t-d\tToggle double precision testing (default: on if double "
          "supported)\n");
     vlog("\t\t-t\tToggle reporting performance data.\n");
     vlog("\t\t-r\tReset buffers on host instead of on device.\n");
+    vlog("\t\t-u\tToggle zero-copy mode. Device buffers wrap the host "
+         "arrays with CL_MEM_USE_HOST_PTR (fine-grain SVM when supported).\n");
     vlog("\t\t-w\tRun in wimpy mode\n");
     vlog("\t\t-[2^n]\tSet wimpy reduction factor, recommended range of n is "
          "1-12, default factor(%u)\n",
@@ -17,6 +17,7 @@
 #define TESTS_H
 
 #include <CL/cl.h>
+#include <CL/cl_half.h>
 
 typedef enum
 {
@@ -44,10 +45,8 @@ int test_vstore_half_rtn( cl_device_id deviceID, cl_context context, cl_command_
 int test_vstorea_half_rtn( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
 int test_roundTrip( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
 
-typedef cl_ushort (*f2h)( float );
-typedef cl_ushort (*d2h)( double );
-int Test_vStoreHalf_private( cl_device_id device, f2h referenceFunc, d2h referenceDoubleFunc, const char *roundName );
-int Test_vStoreaHalf_private( cl_device_id device, f2h referenceFunc, d2h referenceDoubleFunc, const char *roundName );
+int Test_vStoreHalf_private( cl_device_id device, cl_half_rounding_mode roundingMode, cl_half_rounding_mode doubleRoundingMode, const char *roundName );
+int Test_vStoreaHalf_private( cl_device_id device, cl_half_rounding_mode roundingMode, cl_half_rounding_mode doubleRoundingMode, const char *roundName );
 
 #endif /* TESTS_H */
 
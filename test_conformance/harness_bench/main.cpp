@@ -0,0 +1,600 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the throughput of host side reference code on synthetic data.
+// No OpenCL device is used, so host optimizations of the math, conversions
+// and images references can be measured and tracked in isolation.
+
+#include "harness/compat.h"
+#include "harness/conversions.h"
+#include "harness/errorHelpers.h"
+#include "harness/imageHelpers.h"
+#include "harness/mt19937.h"
+#include "harness/rounding_mode.h"
+#include "harness/scanReduceReference.h"
+#include "harness/testHarness.h"
+#include "harness/ThreadPool.h"
+#include "harness/typeWrappers.h"
+
+#include "../conversions/conversions_data_info.h"
+#include "../math_brute_force/reference_math.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Globals normally provided by the test executables whose reference code is
+// linked in here.
+int gIsInRTZMode = 0;
+int gCheckTininessBeforeRounding = 1;
+int gDeviceILogb0 = 1;
+int gDeviceILogbNaN = 1;
+
+size_t gTypeSizes[kTypeCount] = {
+    sizeof(cl_uchar),  sizeof(cl_char),  sizeof(cl_ushort), sizeof(cl_short),
+    sizeof(cl_uint),   sizeof(cl_int),   sizeof(cl_half),   sizeof(cl_float),
+    sizeof(cl_double), sizeof(cl_ulong), sizeof(cl_long),
+};
+void *gIn = NULL;
+
+cl_half_rounding_mode DataInitInfo::halfRoundingMode = CL_HALF_RTE;
+std::vector<uint32_t> DataInitInfo::specialValuesUInt;
+std::vector<float> DataInitInfo::specialValuesFloat;
+std::vector<double> DataInitInfo::specialValuesDouble;
+std::vector<cl_half> DataInitInfo::specialValuesHalf;
+
+#if (defined(__arm__) || defined(__aarch64__)) && defined(__GNUC__)
+bool qcom_sat = false;
+roundingMode qcom_rm = qcomRTE;
+#endif
+
+static size_t gElementCount = 1 << 22;
+static int gIterations = 3;
+static const char *gBenchFilter = NULL;
+
+typedef struct BenchInfo_
+{
+    size_t count; // elements processed by each job
+    size_t lim; // total number of elements
+    void *in;
+    void *out;
+    void *context;
+} BenchInfo;
+
+typedef struct HostBench_
+{
+    const char *name;
+    size_t inSize; // bytes of input per element
+    size_t outSize; // bytes of output per element
+    // Fills in[0..n) with synthetic inputs and returns a context pointer for
+    // the jobs, or NULL if it needs none.
+    void *(*setup)(void *in, size_t n, MTdata d);
+    void (*cleanup)(void *context);
+    TPFuncPtr job;
+} HostBench;
+
+static size_t JobRange(cl_uint jid, const BenchInfo *info, size_t *off)
+{
+    *off = jid * info->count;
+    if (*off >= info->lim) return 0;
+    return std::min(info->count, info->lim - *off);
+}
+
+//
+// Math references
+//
+static void *SetupFloats(void *in, size_t n, MTdata d)
+{
+    cl_uint *p = (cl_uint *)in;
+    for (size_t i = 0; i < n; i++) p[i] = genrand_int32(d);
+    return NULL;
+}
+
+static void *SetupFloatRange(void *in, size_t n, MTdata d)
+{
+    float *p = (float *)in;
+    for (size_t i = 0; i < n; i++) p[i] = get_random_float(-100.f, 100.f, d);
+    return NULL;
+}
+
+template <double (*Func)(double)>
+static cl_int MathUnaryJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    size_t off, count = JobRange(jid, info, &off);
+    const float *s = (const float *)info->in + off;
+    float *r = (float *)info->out + off;
+    for (size_t j = 0; j < count; j++) r[j] = (float)Func(s[j]);
+    return CL_SUCCESS;
+}
+
+template <long double (*Func)(long double)>
+static cl_int MathUnaryLJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    size_t off, count = JobRange(jid, info, &off);
+    const double *s = (const double *)info->in + off;
+    double *r = (double *)info->out + off;
+    for (size_t j = 0; j < count; j++) r[j] = (double)Func(s[j]);
+    return CL_SUCCESS;
+}
+
+static void *SetupDoubles(void *in, size_t n, MTdata d)
+{
+    double *p = (double *)in;
+    for (size_t i = 0; i < n; i++) p[i] = genrand_res53(d) * 200.0 - 100.0;
+    return NULL;
+}
+
+static cl_int MathPowJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    size_t off, count = JobRange(jid, info, &off);
+    const float *s = (const float *)info->in + off;
+    float *r = (float *)info->out + off;
+    // Pair each input with its neighbour to get a second operand
+    for (size_t j = 0; j + 1 < count; j++)
+        r[j] = (float)reference_pow(s[j], s[j + 1]);
+    if (count) r[count - 1] = (float)reference_pow(s[count - 1], 0.5);
+    return CL_SUCCESS;
+}
+
+//
+// Conversions references
+//
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+static void *SetupConversion(Type inType, Type outType, RoundingMode round,
+                             void *in, size_t n, MTdata d)
+{
+    cl_uint *p = (cl_uint *)in;
+    for (size_t i = 0; i < n * sizeof(InType) / sizeof(cl_uint); i++)
+        p[i] = genrand_int32(d);
+
+    DataInitInfo agg = { 0, 0, outType, inType, kUnsaturated, round, 0 };
+    return new DataInfoSpec<InType, OutType, InFP, OutFP>(agg);
+}
+
+static void CleanupConversion(void *context)
+{
+    delete (DataInitBase *)context;
+}
+
+static void *SetupFloatToInt(void *in, size_t n, MTdata d)
+{
+    return SetupConversion<cl_float, cl_int, true, false>(
+        kfloat, kint, kRoundToNearestEven, in, n, d);
+}
+
+static void *SetupDoubleToFloat(void *in, size_t n, MTdata d)
+{
+    return SetupConversion<cl_double, cl_float, true, true>(
+        kdouble, kfloat, kRoundTowardZero, in, n, d);
+}
+
+static void *SetupFloatToHalf(void *in, size_t n, MTdata d)
+{
+    return SetupConversion<cl_float, cl_half, true, true>(
+        kfloat, khalf, kRoundToNearestEven, in, n, d);
+}
+
+static void *SetupLongToFloat(void *in, size_t n, MTdata d)
+{
+    return SetupConversion<cl_long, cl_float, false, true>(
+        klong, kfloat, kRoundToNearestEven, in, n, d);
+}
+
+template <size_t InSize, size_t OutSize, bool Sat>
+static cl_int ConversionJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    DataInitBase *spec = (DataInitBase *)info->context;
+    size_t off, count = JobRange(jid, info, &off);
+    char *s = (char *)info->in + off * InSize;
+    char *r = (char *)info->out + off * OutSize;
+
+    // Same environment as the conversions reference threads
+    FPUStateGuard fpState;
+    fpState.SetRound(spec->round, spec->outType);
+    if (Sat)
+        spec->conv_array_sat(r, s, count);
+    else
+        spec->conv_array(r, s, count);
+    return CL_SUCCESS;
+}
+
+//
+// Images references
+//
+typedef struct ImageBenchContext_
+{
+    cl_image_format format;
+    image_descriptor imageInfo;
+    image_sampler_data sampler;
+    BufferOwningPtr<char> owner;
+    char *data;
+} ImageBenchContext;
+
+static const size_t kBenchImageSize = 256;
+
+static ImageBenchContext *NewBenchImage(MTdata d)
+{
+    ImageBenchContext *ctx = new ImageBenchContext;
+    ctx->format.image_channel_order = CL_RGBA;
+    ctx->format.image_channel_data_type = CL_UNORM_INT8;
+    memset(&ctx->imageInfo, 0, sizeof(ctx->imageInfo));
+    ctx->imageInfo.type = CL_MEM_OBJECT_IMAGE2D;
+    ctx->imageInfo.format = &ctx->format;
+    ctx->imageInfo.width = kBenchImageSize;
+    ctx->imageInfo.height = kBenchImageSize;
+    ctx->imageInfo.depth = 1;
+    ctx->imageInfo.arraySize = 0;
+    ctx->imageInfo.rowPitch = kBenchImageSize * get_pixel_size(&ctx->format);
+    ctx->imageInfo.slicePitch = ctx->imageInfo.rowPitch * kBenchImageSize;
+    ctx->sampler.addressing_mode = CL_ADDRESS_CLAMP_TO_EDGE;
+    ctx->sampler.filter_mode = CL_FILTER_LINEAR;
+    ctx->sampler.normalized_coords = true;
+    ctx->data = generate_random_image_data(&ctx->imageInfo, ctx->owner, d);
+    return ctx;
+}
+
+static void *SetupSampleImage(void *in, size_t n, MTdata d)
+{
+    ImageBenchContext *ctx = NewBenchImage(d);
+
+    // Coordinates reach a little outside the image to exercise addressing
+    float *p = (float *)in;
+    for (size_t i = 0; i < 2 * n; i++) p[i] = get_random_float(-0.1f, 1.1f, d);
+    return ctx;
+}
+
+static void CleanupImage(void *context) { delete (ImageBenchContext *)context; }
+
+static cl_int SampleImageJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    ImageBenchContext *ctx = (ImageBenchContext *)info->context;
+    size_t off, count = JobRange(jid, info, &off);
+    const float *coords = (const float *)info->in + 2 * off;
+    float *r = (float *)info->out + 4 * off;
+    int containsDenorms = 0;
+
+    for (size_t j = 0; j < count; j++)
+        sample_image_pixel_float(ctx->data, &ctx->imageInfo, coords[2 * j],
+                                 coords[2 * j + 1], 0.0f, &ctx->sampler,
+                                 r + 4 * j, 0, &containsDenorms);
+    return CL_SUCCESS;
+}
+
+static void *SetupReadImage(void *in, size_t n, MTdata d)
+{
+    return NewBenchImage(d);
+}
+
+static void *SetupReadImageSRGB(void *in, size_t n, MTdata d)
+{
+    ImageBenchContext *ctx = NewBenchImage(d);
+    ctx->format.image_channel_order = CL_sRGBA;
+    return ctx;
+}
+
+// Element i reads pixel i of the image, wrapping around, a row at a time
+static cl_int ReadImageRowJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    ImageBenchContext *ctx = (ImageBenchContext *)info->context;
+    size_t off, count = JobRange(jid, info, &off);
+    float *r = (float *)info->out + 4 * off;
+
+    while (count)
+    {
+        size_t pixel = off % (kBenchImageSize * kBenchImageSize);
+        size_t x = pixel % kBenchImageSize, y = pixel / kBenchImageSize;
+        size_t n = std::min(count, kBenchImageSize - x);
+        read_image_row_float(ctx->data, &ctx->imageInfo, (int)x, (int)y, 0, n,
+                             r, 0);
+        r += 4 * n;
+        off += n;
+        count -= n;
+    }
+    return CL_SUCCESS;
+}
+
+static cl_int SampleImageBatchJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    ImageBenchContext *ctx = (ImageBenchContext *)info->context;
+    size_t off, count = JobRange(jid, info, &off);
+    const float *coords = (const float *)info->in + 2 * off;
+    float *r = (float *)info->out + 4 * off;
+    std::vector<float> x(count), y(count);
+    std::vector<int> containsDenorms(count);
+
+    for (size_t j = 0; j < count; j++)
+    {
+        x[j] = coords[2 * j];
+        y[j] = coords[2 * j + 1];
+    }
+    sample_image_pixels_float_offset(ctx->data, &ctx->imageInfo, x.data(),
+                                     y.data(), NULL, count, 0.0f, 0.0f, 0.0f,
+                                     &ctx->sampler, r, NULL,
+                                     containsDenorms.data(), 0);
+    return CL_SUCCESS;
+}
+
+static void *SetupPackImage(void *in, size_t n, MTdata d)
+{
+    ImageBenchContext *ctx = new ImageBenchContext;
+    ctx->format.image_channel_order = CL_RGBA;
+    ctx->format.image_channel_data_type = CL_UNORM_INT8;
+    memset(&ctx->imageInfo, 0, sizeof(ctx->imageInfo));
+    memset(&ctx->sampler, 0, sizeof(ctx->sampler));
+    ctx->data = NULL;
+
+    float *p = (float *)in;
+    for (size_t i = 0; i < 4 * n; i++) p[i] = get_random_float(-0.1f, 1.1f, d);
+    return ctx;
+}
+
+static void *SetupPackImageSRGB(void *in, size_t n, MTdata d)
+{
+    ImageBenchContext *ctx = (ImageBenchContext *)SetupPackImage(in, n, d);
+    ctx->format.image_channel_order = CL_sRGBA;
+    return ctx;
+}
+
+static cl_int PackImageJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    ImageBenchContext *ctx = (ImageBenchContext *)info->context;
+    size_t off, count = JobRange(jid, info, &off);
+    float *s = (float *)info->in + 4 * off;
+    cl_uchar *r = (cl_uchar *)info->out + 4 * off;
+
+    for (size_t j = 0; j < count; j++)
+        pack_image_pixel(s + 4 * j, &ctx->format, r + 4 * j);
+    return CL_SUCCESS;
+}
+
+struct CompareBenchContext
+{
+    cl_image_format format;
+    std::vector<char> copy;
+};
+
+static void *SetupCompareScanlines(void *in, size_t n, MTdata d)
+{
+    CompareBenchContext *ctx = new CompareBenchContext;
+    ctx->format.image_channel_order = CL_RGBA;
+    ctx->format.image_channel_data_type = CL_SNORM_INT16;
+
+    size_t size = n * get_pixel_size(&ctx->format);
+    cl_uint *p = (cl_uint *)in;
+    for (size_t i = 0; i < size / sizeof(cl_uint); i++) p[i] = genrand_int32(d);
+    ctx->copy.assign((char *)in, (char *)in + size);
+    return ctx;
+}
+
+static void CleanupCompareScanlines(void *context)
+{
+    delete (CompareBenchContext *)context;
+}
+
+// The two buffers are identical, so every job scans its whole range
+static cl_int CompareScanlinesJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    CompareBenchContext *ctx = (CompareBenchContext *)info->context;
+    size_t off, count = JobRange(jid, info, &off);
+    size_t pixelSize = get_pixel_size(&ctx->format);
+    const char *a = (const char *)info->in + off * pixelSize;
+    const char *b = ctx->copy.data() + off * pixelSize;
+
+    return compare_pixels(&ctx->format, a, b, count) == count ? CL_SUCCESS
+                                                              : -1;
+}
+
+//
+// Scan and reduce references
+//
+static const size_t kBenchGroupSize = 256;
+
+template <typename T> struct BenchAdd
+{
+    static T combine(T a, T b) { return a + b; }
+};
+
+static void *SetupULongs(void *in, size_t n, MTdata d)
+{
+    cl_ulong *p = (cl_ulong *)in;
+    for (size_t i = 0; i < n; i++) p[i] = genrand_int64(d);
+    return NULL;
+}
+
+// Every item receives the sum of its work-group
+static cl_int ReduceGroupsJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    size_t off, count = JobRange(jid, info, &off);
+    const cl_ulong *in = (const cl_ulong *)info->in + off;
+    cl_ulong *out = (cl_ulong *)info->out + off;
+
+    reference_clustered_reduce<BenchAdd<cl_ulong>>(in, out, count,
+                                                   kBenchGroupSize);
+    return CL_SUCCESS;
+}
+
+static cl_int ScanGroupsJob(cl_uint jid, cl_uint tid, void *userInfo)
+{
+    BenchInfo *info = (BenchInfo *)userInfo;
+    size_t off, count = JobRange(jid, info, &off);
+    const float *in = (const float *)info->in + off;
+    float *out = (float *)info->out + off;
+
+    for (size_t i = 0; i < count; i += kBenchGroupSize)
+        reference_scan_inclusive<BenchAdd<float>>(
+            in + i, out + i, std::min(kBenchGroupSize, count - i), 0.f);
+    return CL_SUCCESS;
+}
+
+static const HostBench sBenches[] = {
+    { "math_exp", sizeof(float), sizeof(float), SetupFloatRange, NULL,
+      MathUnaryJob<reference_exp> },
+    { "math_sin", sizeof(float), sizeof(float), SetupFloats, NULL,
+      MathUnaryJob<reference_sin> },
+    { "math_pow", sizeof(float), sizeof(float), SetupFloatRange, NULL,
+      MathPowJob },
+    { "math_sinl", sizeof(double), sizeof(double), SetupDoubles, NULL,
+      MathUnaryLJob<reference_sinl> },
+    { "conv_float_int_rte", sizeof(cl_float), sizeof(cl_int), SetupFloatToInt,
+      CleanupConversion,
+      ConversionJob<sizeof(cl_float), sizeof(cl_int), false> },
+    { "conv_float_int_sat", sizeof(cl_float), sizeof(cl_int), SetupFloatToInt,
+      CleanupConversion, ConversionJob<sizeof(cl_float), sizeof(cl_int), true> },
+    { "conv_double_float_rtz", sizeof(cl_double), sizeof(cl_float),
+      SetupDoubleToFloat, CleanupConversion,
+      ConversionJob<sizeof(cl_double), sizeof(cl_float), false> },
+    { "conv_float_half", sizeof(cl_float), sizeof(cl_half), SetupFloatToHalf,
+      CleanupConversion,
+      ConversionJob<sizeof(cl_float), sizeof(cl_half), false> },
+    { "conv_long_float", sizeof(cl_long), sizeof(cl_float), SetupLongToFloat,
+      CleanupConversion,
+      ConversionJob<sizeof(cl_long), sizeof(cl_float), false> },
+    { "sample_image_pixel_float", 2 * sizeof(float), 4 * sizeof(float),
+      SetupSampleImage, CleanupImage, SampleImageJob },
+    { "sample_image_pixels_float", 2 * sizeof(float), 4 * sizeof(float),
+      SetupSampleImage, CleanupImage, SampleImageBatchJob },
+    { "read_image_row_float", 0, 4 * sizeof(float), SetupReadImage,
+      CleanupImage, ReadImageRowJob },
+    { "read_image_row_float_srgb", 0, 4 * sizeof(float), SetupReadImageSRGB,
+      CleanupImage, ReadImageRowJob },
+    { "pack_image_pixel", 4 * sizeof(float), 4 * sizeof(cl_uchar),
+      SetupPackImage, CleanupImage, PackImageJob },
+    { "pack_image_pixel_srgb", 4 * sizeof(float), 4 * sizeof(cl_uchar),
+      SetupPackImageSRGB, CleanupImage, PackImageJob },
+    { "compare_scanlines", 4 * sizeof(cl_short), 0, SetupCompareScanlines,
+      CleanupCompareScanlines, CompareScanlinesJob },
+    { "reduce_groups_ulong", sizeof(cl_ulong), sizeof(cl_ulong), SetupULongs,
+      NULL, ReduceGroupsJob },
+    { "scan_groups_float", sizeof(float), sizeof(float), SetupFloatRange, NULL,
+      ScanGroupsJob },
+};
+
+static int RunBench(const HostBench &bench, MTdata d)
+{
+    std::vector<char> in(gElementCount * bench.inSize);
+    std::vector<char> out(gElementCount * bench.outSize);
+    void *context =
+        bench.setup ? bench.setup(in.data(), gElementCount, d) : NULL;
+    cl_uint maxThreads = GetThreadCount();
+    double baseRate = 0.0;
+
+    for (cl_uint threads = 1;; threads = std::min(2 * threads, maxThreads))
+    {
+        // One job per thread, so at most this many workers are busy
+        BenchInfo info;
+        info.lim = gElementCount;
+        info.count = (gElementCount + threads - 1) / threads;
+        info.in = in.data();
+        info.out = out.data();
+        info.context = context;
+
+        double best = 0.0;
+        for (int i = 0; i < gIterations; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cl_int error = ThreadPool_Do(bench.job, threads, &info);
+            std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            if (error)
+            {
+                log_error("ERROR: %s failed with %d\n", bench.name, error);
+                if (bench.cleanup) bench.cleanup(context);
+                return -1;
+            }
+            if (best == 0.0 || elapsed.count() < best) best = elapsed.count();
+        }
+
+        double rate = gElementCount / best;
+        if (threads == 1) baseRate = rate;
+        log_info("%-26s %7u %14.2f %14.2f %9.2fx\n", bench.name, threads,
+                 rate * 1e-6, rate * 1e-6 / threads, rate / baseRate);
+
+        if (threads == maxThreads) break;
+    }
+
+    if (bench.cleanup) bench.cleanup(context);
+    return 0;
+}
+
+static void PrintUsage(const char *name)
+{
+    log_info("%s [-n count] [-i iterations] [-l] [bench name]\n", name);
+    log_info("\t-n count\tElements processed per run (default %zu)\n",
+             gElementCount);
+    log_info("\t-i iterations\tRuns per thread count, the best is reported "
+             "(default %d)\n",
+             gIterations);
+    log_info("\t-l\tList the benchmarks and exit\n");
+    log_info("\tbench name\tOnly run benchmarks whose name contains this\n");
+    log_info("\nThe worker count can be limited with CL_TEST_NUM_THREADS.\n");
+}
+
+int main(int argc, const char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            gElementCount = (size_t)strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            gIterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-l"))
+        {
+            for (const HostBench &bench : sBenches) log_info("%s\n", bench.name);
+            return 0;
+        }
+        else if (argv[i][0] != '-')
+            gBenchFilter = argv[i];
+        else
+        {
+            PrintUsage(argv[0]);
+            return argv[i][1] == 'h' ? 0 : -1;
+        }
+    }
+
+    if (0 == gElementCount || gIterations < 1)
+    {
+        PrintUsage(argv[0]);
+        return -1;
+    }
+
+    log_info("Host reference throughput, %zu elements, best of %d runs\n",
+             gElementCount, gIterations);
+    log_info("%-26s %7s %14s %14s %10s\n", "benchmark", "threads", "Melem/s",
+             "Melem/s/core", "scaling");
+
+    MTdataHolder d(gRandomSeed);
+    int ret = 0;
+    for (const HostBench &bench : sBenches)
+    {
+        if (gBenchFilter && !strstr(bench.name, gBenchFilter)) continue;
+        ret |= RunBench(bench, d);
+    }
+
+    return ret;
+}
@@ -116,6 +116,8 @@ int main(int argc, const char *argv[])
 
         else if( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if( strcmp( argv[i], "parallel_matrix" ) == 0 )
+            gParallelImageMatrix = true;
 
         else if( strcmp( argv[i], "--help" ) == 0 || strcmp( argv[i], "-h" ) == 0 )
         {
@@ -161,6 +163,7 @@ static void printUsage( const char *execName )
     log_info( "\tmax_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128\n" );
     log_info( "\trandomize - Use random seed\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info( "\tparallel_matrix - Runs independent format and sampler combinations concurrently, one queue per worker thread (see CL_TEST_NUM_THREADS)\n" );
     log_info( "\n" );
     log_info( "Test names:\n" );
     for (size_t i = 0; i < test_registry::getInstance().num_tests(); i++)
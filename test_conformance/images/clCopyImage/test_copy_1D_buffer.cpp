@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 extern int test_copy_image_generic(cl_context context, cl_command_queue queue,
                                    image_descriptor *srcImageInfo,
@@ -87,7 +88,7 @@ int test_copy_image_set_1D_buffer(
     cl_ulong maxAllocSize, memSize;
     image_descriptor srcImageInfo = { 0 };
     image_descriptor dstImageInfo = { 0 };
-    RandomSeed seed(gRandomSeed);
+    RandomSeed seed(image_test_job_seed());
     size_t pixelSize;
 
     if (gTestMipmaps)
@@ -239,7 +240,7 @@ int test_copy_image_set_1D_1D_buffer(
     cl_ulong maxAllocSize, memSize;
     image_descriptor srcImageInfo = { 0 };
     image_descriptor dstImageInfo = { 0 };
-    RandomSeed seed(gRandomSeed);
+    RandomSeed seed(image_test_job_seed());
     size_t pixelSize;
 
     if (gTestMipmaps)
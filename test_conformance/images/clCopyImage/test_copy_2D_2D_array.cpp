@@ -213,7 +213,7 @@ int test_copy_image_set_2D_2D_array(
     const bool reverse = (src_type == CL_MEM_OBJECT_IMAGE2D_ARRAY);
     image_descriptor imageInfo2D = { 0 };
     image_descriptor imageInfo2Darray = { 0 };
-    RandomSeed  seed( gRandomSeed );
+    RandomSeed  seed( image_test_job_seed() );
 
     imageInfo2D.format = imageInfo2Darray.format = format;
     imageInfo2D.type = CL_MEM_OBJECT_IMAGE2D;
@@ -217,7 +217,7 @@ int test_copy_image_set_2D_3D(cl_device_id device, cl_context context,
     const bool reverse = (dst_type == CL_MEM_OBJECT_IMAGE2D);
     image_descriptor imageInfo2D = { 0 };
     image_descriptor imageInfo3D = { 0 };
-    RandomSeed  seed( gRandomSeed );
+    RandomSeed  seed( image_test_job_seed() );
 
     imageInfo2D.format = imageInfo3D.format = format;
     imageInfo2D.type = CL_MEM_OBJECT_IMAGE2D;
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 // Defined in test_copy_generic.cpp
 extern int test_copy_image_generic( cl_context context, cl_command_queue queue, image_descriptor *srcImageInfo, image_descriptor *dstImageInfo,
@@ -78,7 +79,7 @@ int test_copy_image_set_2D_array(cl_device_id device, cl_context context,
     cl_ulong maxAllocSize, memSize;
     image_descriptor srcImageInfo = { 0 };
     image_descriptor dstImageInfo = { 0 };
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     size_t pixelSize;
 
     srcImageInfo.format = format;
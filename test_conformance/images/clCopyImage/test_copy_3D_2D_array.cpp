@@ -233,7 +233,7 @@ int test_copy_image_set_3D_2D_array(
     const bool reverse = (src_type == CL_MEM_OBJECT_IMAGE2D_ARRAY);
     image_descriptor imageInfo3D = { 0 };
     image_descriptor imageInfo2Darray = { 0 };
-    RandomSeed  seed( gRandomSeed );
+    RandomSeed  seed( image_test_job_seed() );
     size_t rowPadding = gEnablePitch ? 256 : 0;
     size_t slicePadding = gEnablePitch ? 3 : 0;
 
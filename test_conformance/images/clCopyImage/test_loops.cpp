@@ -279,32 +279,28 @@ int test_image_type(cl_device_id device, cl_context context,
         filter_formats(formatList, filterFlags, nullptr);
 
         // Run the format list
+        std::vector<ImageTestJob> jobs;
         for (unsigned int i = 0; i < formatList.size(); i++)
         {
-            int test_return = 0;
             if (filterFlags[i])
             {
                 continue;
             }
 
-            print_header(&formatList[i], false);
+            cl_image_format format = formatList[i];
 
-            gTestCount++;
-
-            test_return = test_fn(device, context, queue, test_config.src_flags,
-                                  test_config.src_type, test_config.dst_flags,
-                                  test_config.dst_type, &formatList[i]);
-
-            if (test_return)
-            {
-                gFailCount++;
-                log_error("FAILED: ");
-                print_header(&formatList[i], true);
-                log_info("\n");
-            }
-
-            ret += test_return;
+            ImageTestJob job;
+            job.run = [=](cl_command_queue queue) mutable {
+                return test_fn(device, context, queue, test_config.src_flags,
+                               test_config.src_type, test_config.dst_flags,
+                               test_config.dst_type, &format);
+            };
+            job.describe = [=](bool error) mutable {
+                print_header(&format, error);
+            };
+            jobs.push_back(job);
         }
+        ret += run_image_test_jobs(device, context, queue, jobs);
     }
 
     return ret;
@@ -77,6 +77,8 @@ int main(int argc, const char *argv[])
 
         else if ( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if ( strcmp( argv[i], "parallel_matrix" ) == 0 )
+            gParallelImageMatrix = true;
 
         else if( strcmp( argv[i], "int" ) == 0 )
             gTypesToTest |= kTestInt;
@@ -136,6 +138,7 @@ static void printUsage( const char *execName )
     log_info( "\tsmall_images - Runs every format through a loop of widths 1-13 and heights 1-9, instead of random sizes\n" );
     log_info( "\tmax_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info( "\tparallel_matrix - Runs independent format and sampler combinations concurrently, one queue per worker thread (see CL_TEST_NUM_THREADS)\n" );
     log_info( "\n" );
     log_info( "Test names:\n" );
     for (size_t i = 0; i < test_registry::getInstance().num_tests(); i++)
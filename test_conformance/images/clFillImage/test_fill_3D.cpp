@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 // Defined in test_fill_2D_3D.cpp
 extern int test_fill_image_generic( cl_context context, cl_command_queue queue, image_descriptor *imageInfo,
@@ -69,7 +70,7 @@ int test_fill_image_set_3D(cl_device_id device, cl_context context,
     size_t maxWidth, maxHeight, maxDepth;
     cl_ulong maxAllocSize, memSize;
     image_descriptor imageInfo = { 0 };
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     const size_t rowPadding_default = 80;
     size_t rowPadding = gEnablePitch ? rowPadding_default : 0;
     size_t slicePadding = gEnablePitch ? 3 : 0;
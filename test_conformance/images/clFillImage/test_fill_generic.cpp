@@ -28,25 +28,10 @@ static void fill_region_with_value( image_descriptor *imageInfo, void *imageValu
     char *destPtr   = (char *)imageValues + origin[ 2 ] * imageInfo->slicePitch
         + origin[ 1 ] * imageInfo->rowPitch + pixelSize * origin[ 0 ];
 
-    char *fillColor = (char *)malloc(pixelSize);
-    memcpy(fillColor, value, pixelSize);
-
     // Use pixel at origin to fill region.
-    for( size_t z = 0; z < ( region[ 2 ] > 0 ? region[ 2 ] : 1 ); z++ ) {
-        char *rowDestPtr = destPtr;
-        for( size_t y = 0; y < region[ 1 ]; y++ ) {
-            char *pixelDestPtr = rowDestPtr;
-
-            for( size_t x = 0; x < region[ 0 ]; x++ ) {
-                memcpy( pixelDestPtr, fillColor, pixelSize );
-                pixelDestPtr += pixelSize;
-            }
-            rowDestPtr += imageInfo->rowPitch;
-        }
-        destPtr += imageInfo->slicePitch;
-    }
-
-    free(fillColor);
+    fill_pitched_region( destPtr, imageInfo->rowPitch, imageInfo->slicePitch,
+                         value, pixelSize, region[ 0 ], region[ 1 ],
+                         region[ 2 ] > 0 ? region[ 2 ] : 1 );
 }
 
 int test_fill_image_generic( cl_context context, cl_command_queue queue, image_descriptor *imageInfo,
@@ -112,6 +112,7 @@ int test_image_type( cl_device_id device, cl_context context, cl_command_queue q
             else
             {
                 // Run the format list
+                std::vector<ImageTestJob> jobs;
                 for (unsigned int i = 0; i < formatList.size(); i++)
                 {
                     if (filterFlags[i])
@@ -119,23 +120,20 @@ int test_image_type( cl_device_id device, cl_context context, cl_command_queue q
                         continue;
                     }
 
-                    print_header(&formatList[i], false);
-
-                    gTestCount++;
-
-                    int test_return =
-                        test_fn(device, context, queue, &formatList[i], flags,
-                                test.explicitType);
-                    if (test_return)
-                    {
-                        gFailCount++;
-                        log_error("FAILED: ");
-                        print_header(&formatList[i], true);
-                        log_info("\n");
-                    }
-
-                    ret += test_return;
+                    cl_image_format format = formatList[i];
+                    ExplicitType outputType = test.explicitType;
+
+                    ImageTestJob job;
+                    job.run = [=](cl_command_queue queue) mutable {
+                        return test_fn(device, context, queue, &format, flags,
+                                       outputType);
+                    };
+                    job.describe = [=](bool error) mutable {
+                        print_header(&format, error);
+                    };
+                    jobs.push_back(job);
                 }
+                ret += run_image_test_jobs(device, context, queue, jobs);
             }
         }
     }
@@ -83,6 +83,8 @@ int main(int argc, const char *argv[])
             gTestMaxImages = true;
         else if( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if( strcmp( argv[i], "parallel_matrix" ) == 0 )
+            gParallelImageMatrix = true;
         else if( strcmp( argv[i], "test_mipmaps") == 0 ) {
             gTestMipmaps = true;
             // Don't test pitches with mipmaps right now.
@@ -127,6 +129,7 @@ static void printUsage( const char *execName )
     log_info( "\tsmall_images - Runs every format through a loop of widths 1-13 and heights 1-9, instead of random sizes\n" );
     log_info( "\tmax_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info( "\tparallel_matrix - Runs independent format and sampler combinations concurrently, one queue per worker thread (see CL_TEST_NUM_THREADS)\n" );
     log_info( "\ttest_mipmaps - Test mipmapped images\n" );
     log_info( "\trandomize - Uses random seed\n" );
     log_info( "\n" );
@@ -66,9 +66,9 @@ int test_image_type( cl_device_id device, cl_context context, cl_command_queue q
     filter_formats(formatList, filterFlags, nullptr);
 
     // Run the format list
+    std::vector<ImageTestJob> jobs;
     for (unsigned int i = 0; i < formatList.size(); i++)
     {
-        int test_return = 0;
         if (filterFlags[i])
         {
             log_info("NOT RUNNING: ");
@@ -76,48 +76,39 @@ int test_image_type( cl_device_id device, cl_context context, cl_command_queue q
             continue;
         }
 
-        print_header(&formatList[i], false);
-
-        gTestCount++;
-
-        switch (imageType)
-        {
-            case CL_MEM_OBJECT_IMAGE1D:
-                test_return = test_read_image_set_1D(device, context, queue,
-                                                     &formatList[i], flags);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                test_return = test_read_image_set_2D(device, context, queue,
-                                                     &formatList[i], flags);
-                break;
-            case CL_MEM_OBJECT_IMAGE3D:
-                test_return = test_read_image_set_3D(device, context, queue,
-                                                     &formatList[i], flags);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                test_return = test_read_image_set_1D_array(
-                    device, context, queue, &formatList[i], flags);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                test_return = test_read_image_set_2D_array(
-                    device, context, queue, &formatList[i], flags);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-                test_return = test_read_image_set_1D_buffer(
-                    device, context, queue, &formatList[i], flags);
-                break;
-        }
-
-        if (test_return)
-        {
-            gFailCount++;
-            log_error("FAILED: ");
-            print_header(&formatList[i], true);
-            log_info("\n");
-        }
-
-        ret += test_return;
+        cl_image_format format = formatList[i];
+
+        ImageTestJob job;
+        job.run = [=](cl_command_queue queue) mutable {
+            switch (imageType)
+            {
+                case CL_MEM_OBJECT_IMAGE1D:
+                    return test_read_image_set_1D(device, context, queue,
+                                                  &format, flags);
+                case CL_MEM_OBJECT_IMAGE2D:
+                    return test_read_image_set_2D(device, context, queue,
+                                                  &format, flags);
+                case CL_MEM_OBJECT_IMAGE3D:
+                    return test_read_image_set_3D(device, context, queue,
+                                                  &format, flags);
+                case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+                    return test_read_image_set_1D_array(device, context, queue,
+                                                        &format, flags);
+                case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+                    return test_read_image_set_2D_array(device, context, queue,
+                                                        &format, flags);
+                case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+                    return test_read_image_set_1D_buffer(
+                        device, context, queue, &format, flags);
+            }
+            return 0;
+        };
+        job.describe = [=](bool error) mutable {
+            print_header(&format, error);
+        };
+        jobs.push_back(job);
     }
+    ret += run_image_test_jobs(device, context, queue, jobs);
 
     return ret;
 }
@@ -14,11 +14,16 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 int test_read_image_1D_array(cl_context context, cl_command_queue queue,
                              image_descriptor *imageInfo, MTdata d,
                              cl_mem_flags flags)
 {
+    // Images too large to hold on the host are streamed through in tiles
+    if (use_tiled_image_verification(imageInfo))
+        return test_image_tiled(context, queue, imageInfo, flags, d);
+
     int error;
 
     clMemWrapper image;
@@ -67,27 +72,20 @@ int test_read_image_1D_array(cl_context context, cl_command_queue queue,
 
     size_t origin[ 3 ] = { 0, 0, 0 };
     size_t region[ 3 ] = { 0, 0, 1 };
-    size_t fullImageSize;
-    if( gTestMipmaps )
-    {
-        fullImageSize = (size_t)compute_mipmapped_image_size( *imageInfo );
-    }
-    else
-    {
-        fullImageSize = imageInfo->arraySize * imageInfo->slicePitch;
-    }
-
-    size_t imgValMipLevelOffset = 0;
-    BufferOwningPtr<char> resultValues(malloc(fullImageSize));
+    image_mip_pyramid pyramid;
+    compute_mip_pyramid(imageInfo, &pyramid);
+    BufferOwningPtr<char> resultValues(malloc(pyramid.totalSize));
 
     for( size_t lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
     {
+        const image_descriptor &levelInfo = pyramid.levels[lod].info;
+        size_t imgValMipLevelOffset = pyramid.levels[lod].offset;
         size_t width_lod, row_pitch_lod, slice_pitch_lod;
         if( gTestMipmaps )
             origin[2] = lod;
 
-        width_lod = (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
-        row_pitch_lod = gTestMipmaps ? (width_lod * get_pixel_size( imageInfo->format )): imageInfo->rowPitch;
+        width_lod = levelInfo.width;
+        row_pitch_lod = levelInfo.rowPitch;
         slice_pitch_lod = row_pitch_lod;
 
         region[0] = width_lod;
@@ -163,7 +161,6 @@ int test_read_image_1D_array(cl_context context, cl_command_queue queue,
             sourcePtr += row_pitch_lod;
             destPtr += scanlineSize;
         }
-        imgValMipLevelOffset += width_lod * imageInfo->arraySize * get_pixel_size( imageInfo->format );
     }
     return 0;
 }
@@ -175,7 +172,7 @@ int test_read_image_set_1D_array(cl_device_id device, cl_context context,
     size_t maxWidth, maxArraySize;
     cl_ulong maxAllocSize, memSize;
     image_descriptor imageInfo = { 0 };
-    RandomSeed  seed( gRandomSeed );
+    RandomSeed  seed( image_test_job_seed() );
     size_t pixelSize;
 
     imageInfo.type = CL_MEM_OBJECT_IMAGE1D_ARRAY;
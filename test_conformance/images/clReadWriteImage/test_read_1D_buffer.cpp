@@ -14,12 +14,17 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 #include <CL/cl.h>
 
 int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
                               image_descriptor *imageInfo, MTdata d,
                               cl_mem_flags flags)
 {
+    // Images too large to hold on the host are streamed through in tiles
+    if (use_tiled_image_verification(imageInfo))
+        return test_image_tiled(context, queue, imageInfo, flags, d);
+
     int error;
 
     clMemWrapper image;
@@ -155,7 +160,7 @@ int test_read_image_set_1D_buffer(cl_device_id device, cl_context context,
     size_t maxWidth;
     cl_ulong maxAllocSize, memSize;
     image_descriptor imageInfo = { 0 };
-    RandomSeed seed(gRandomSeed);
+    RandomSeed seed(image_test_job_seed());
     size_t pixelSize;
 
     if (gTestMipmaps)
@@ -14,11 +14,16 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 int test_read_image_3D(cl_context context, cl_command_queue queue,
                        image_descriptor *imageInfo, MTdata d,
                        cl_mem_flags flags)
 {
+    // Images too large to hold on the host are streamed through in tiles
+    if (use_tiled_image_verification(imageInfo))
+        return test_image_tiled(context, queue, imageInfo, flags, d);
+
     int error;
 
     clMemWrapper image;
@@ -68,29 +73,22 @@ int test_read_image_3D(cl_context context, cl_command_queue queue,
 
     size_t origin[ 4 ] = { 0, 0, 0, 0 };
     size_t region[ 3 ] = { 0, 0, 0 };
-    size_t fullImageSize;
-    if( gTestMipmaps )
-    {
-        fullImageSize = (size_t)compute_mipmapped_image_size( *imageInfo );
-    }
-    else
-    {
-        fullImageSize = imageInfo->depth * imageInfo->slicePitch;
-    }
-
-    BufferOwningPtr<char> resultValues(malloc(fullImageSize));
-    size_t imgValMipLevelOffset = 0;
+    image_mip_pyramid pyramid;
+    compute_mip_pyramid(imageInfo, &pyramid);
+    BufferOwningPtr<char> resultValues(malloc(pyramid.totalSize));
 
     for(size_t lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
     {
         origin[3] = lod;
+        const image_descriptor &levelInfo = pyramid.levels[lod].info;
+        size_t imgValMipLevelOffset = pyramid.levels[lod].offset;
         size_t width_lod, height_lod, depth_lod, row_pitch_lod, slice_pitch_lod;
 
-        width_lod = (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
-        height_lod = (imageInfo->height >> lod) ? (imageInfo->height >> lod) : 1;
-        depth_lod = (imageInfo->depth >> lod) ? (imageInfo->depth >> lod) : 1;
-        row_pitch_lod = gTestMipmaps ? (width_lod * get_pixel_size( imageInfo->format )): imageInfo->rowPitch;
-        slice_pitch_lod = gTestMipmaps ? (row_pitch_lod * height_lod): imageInfo->slicePitch;
+        width_lod = levelInfo.width;
+        height_lod = levelInfo.height;
+        depth_lod = levelInfo.depth;
+        row_pitch_lod = levelInfo.rowPitch;
+        slice_pitch_lod = levelInfo.slicePitch;
         region[0] = width_lod;
         region[1] = height_lod;
         region[2] = depth_lod;
@@ -146,7 +144,6 @@ int test_read_image_3D(cl_context context, cl_command_queue queue,
             sourcePtr += slice_pitch_lod - ( row_pitch_lod * height_lod );
             destPtr += pageSize - scanlineSize * height_lod;
         }
-        imgValMipLevelOffset += width_lod * height_lod * depth_lod * get_pixel_size( imageInfo->format );
   }
     return 0;
 }
@@ -158,7 +155,7 @@ int test_read_image_set_3D(cl_device_id device, cl_context context,
     size_t maxWidth, maxHeight, maxDepth;
     cl_ulong maxAllocSize, memSize;
     image_descriptor imageInfo = { 0 };
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     size_t pixelSize;
 
     imageInfo.type = CL_MEM_OBJECT_IMAGE3D;
@@ -14,6 +14,14 @@
 // limitations under the License.
 //
 #include "common.h"
+#include "harness/rounding_mode.h"
+#include "harness/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+bool gParallelImageMatrix = false;
 
 cl_channel_type floatFormats[] = {
     CL_UNORM_SHORT_565,
@@ -453,6 +461,9 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
     size_t origin[4] = { 0, 0, 0, 0 };
     size_t region[3] = { imageInfo->width, height, depth };
 
+    image_mip_pyramid pyramid;
+    if (create_mipmaps) compute_mip_pyramid(imageInfo, &pyramid);
+
     for (size_t lod = 0; (create_mipmaps && (lod < imageInfo->num_mip_levels))
          || (!create_mipmaps && (lod < 1));
          lod++)
@@ -479,26 +490,17 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
                     break;
             }
 
-            // Adjust image dimensions as per miplevel
-            switch (imageInfo->type)
-            {
-                case CL_MEM_OBJECT_IMAGE3D:
-                    depth = (imageInfo->depth >> lod)
-                        ? (imageInfo->depth >> lod)
-                        : 1;
-                case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                case CL_MEM_OBJECT_IMAGE2D:
-                    height = (imageInfo->height >> lod)
-                        ? (imageInfo->height >> lod)
-                        : 1;
-                case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-                case CL_MEM_OBJECT_IMAGE1D:
-                    width = (imageInfo->width >> lod)
-                        ? (imageInfo->width >> lod)
-                        : 1;
-            }
-            row_pitch_lod = width * get_pixel_size(imageInfo->format);
+            // Adjust image dimensions as per miplevel. The array size stays
+            // in height or depth for array types.
+            const image_descriptor &levelInfo = pyramid.levels[lod].info;
+            width = levelInfo.width;
+            if (imageInfo->type == CL_MEM_OBJECT_IMAGE2D
+                || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY
+                || imageInfo->type == CL_MEM_OBJECT_IMAGE3D)
+                height = levelInfo.height;
+            if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D)
+                depth = levelInfo.depth;
+            row_pitch_lod = levelInfo.rowPitch;
             slice_pitch_lod = row_pitch_lod * height;
             region[0] = width;
             region[1] = height;
@@ -528,7 +530,7 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
         size_t data_lod_offset = 0;
         if (create_mipmaps)
         {
-            data_lod_offset = compute_mip_level_offset(imageInfo, lod);
+            data_lod_offset = pyramid.levels[lod].offset;
         }
 
         char *src = static_cast<char *>(data) + data_lod_offset;
@@ -556,20 +558,12 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
                     dstPitch2D = mappedSlice;
                     break;
             }
-            for (size_t z = 0; z < depth; z++)
-            {
-                for (size_t y = 0; y < height; y++)
-                {
-                    memcpy(dst, src, scanlineSize);
-                    dst += dstPitch2D;
-                    src += scanlineSize;
-                }
-
-                // mappedSlicePad is incorrect for 2D images here, but we will
-                // exit the z loop before this is a problem.
-                dst += mappedSlicePad;
-                src += sliceSize;
-            }
+            // mappedSlicePad is incorrect for 2D images here, but there is
+            // only one slice to copy then.
+            copy_pitched_region(dst, dstPitch2D,
+                                dstPitch2D * height + mappedSlicePad, src,
+                                scanlineSize, scanlineSize * height + sliceSize,
+                                scanlineSize, height, depth);
         }
 
         // Unmap the image.
@@ -584,3 +578,332 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
     }
     return img;
 }
+
+static void report_image_test_job(const ImageTestJob &job, int result)
+{
+    gTestCount++;
+    if (result)
+    {
+        gFailCount++;
+        log_error("FAILED: ");
+        job.describe(true);
+        log_info("\n");
+    }
+}
+
+struct ImageTestJobState
+{
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue_properties queueProps;
+    const std::vector<ImageTestJob> *jobs;
+    std::vector<int> results;
+    std::atomic<size_t> next;
+};
+
+// Set while a job runs on this thread
+static thread_local const cl_uint *tJobSeed = nullptr;
+
+cl_uint image_test_job_seed() { return tJobSeed ? *tJobSeed : gRandomSeed; }
+
+static int run_image_test_job(const ImageTestJob &job, size_t index,
+                              cl_command_queue queue)
+{
+    // Spread the indices so that neighbouring jobs get unrelated streams
+    cl_uint seed = gRandomSeed + (cl_uint)index * 0x9e3779b9u;
+    tJobSeed = &seed;
+    int result = job.run(queue);
+    tJobSeed = nullptr;
+    return result;
+}
+
+static void image_test_job_worker(ImageTestJobState *state)
+{
+    // Worker threads start with the default floating point state, so undo
+    // denorm flushing for the host references as the mains do
+    FPUStateGuard fpState;
+    fpState.SetFTZ(false);
+
+    cl_int error;
+    clCommandQueueWrapper queue = clCreateCommandQueue(
+        state->context, state->device, state->queueProps, &error);
+
+    const std::vector<ImageTestJob> &jobs = *state->jobs;
+    for (size_t i = state->next++; i < jobs.size(); i = state->next++)
+    {
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "Unable to create a queue for a test job");
+            state->results[i] = error;
+            continue;
+        }
+        jobs[i].describe(false);
+        state->results[i] = run_image_test_job(jobs[i], i, queue);
+    }
+}
+
+// DetectFloatToHalfRoundingMode() sets gFloatToHalfRoundingMode the first
+// time a job needs it, so run it before the workers start rather than let
+// several of them write it at once. Returns false if the jobs have to run
+// serially because it could not be detected.
+static bool detect_half_rounding_before_jobs(cl_context context,
+                                             cl_command_queue queue)
+{
+    std::vector<cl_image_format> formats;
+    if (get_format_list(context, CL_MEM_OBJECT_IMAGE2D, formats,
+                        CL_MEM_WRITE_ONLY))
+        return false;
+
+    for (const cl_image_format &format : formats)
+        if (format.image_channel_order == CL_RGBA
+            && format.image_channel_data_type == CL_HALF_FLOAT)
+            return DetectFloatToHalfRoundingMode(queue) == CL_SUCCESS;
+
+    // No job can write half images, so none of them will need the mode
+    return true;
+}
+
+int run_image_test_jobs(cl_device_id device, cl_context context,
+                        cl_command_queue queue,
+                        const std::vector<ImageTestJob> &jobs)
+{
+    int failures = 0;
+    size_t workerCount = std::min((size_t)GetThreadCount(), jobs.size());
+
+    // The rounding tests step the shared gRoundingStartValue ramp from every
+    // job, so they can only run one job at a time.
+    if (!gParallelImageMatrix || gTestRounding || workerCount < 2
+        || !detect_half_rounding_before_jobs(context, queue))
+    {
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            jobs[i].describe(false);
+            int result = run_image_test_job(jobs[i], i, queue);
+            report_image_test_job(jobs[i], result);
+            failures += result != 0;
+        }
+        return failures;
+    }
+
+    ImageTestJobState state;
+    state.device = device;
+    state.context = context;
+    state.jobs = &jobs;
+    state.results.resize(jobs.size(), 0);
+    state.next = 0;
+    cl_int error =
+        clGetCommandQueueInfo(queue, CL_QUEUE_PROPERTIES,
+                              sizeof(state.queueProps), &state.queueProps,
+                              nullptr);
+    test_error(error, "Unable to get the queue properties");
+
+    // Job seeds are derived from gRandomSeed, so leave it alone until every
+    // job has started
+    cl_uint reSeed = gReSeed;
+    gReSeed = 0;
+
+    log_info("Running %zu test combinations on %zu threads\n", jobs.size(),
+             workerCount);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < workerCount; i++)
+        workers.emplace_back(image_test_job_worker, &state);
+    for (std::thread &worker : workers) worker.join();
+
+    gReSeed = reSeed;
+    if (gReSeed)
+    {
+        MTdataHolder d(gRandomSeed);
+        gRandomSeed = genrand_int32(d);
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        report_image_test_job(jobs[i], state.results[i]);
+        failures += state.results[i] != 0;
+    }
+    return failures;
+}
+
+bool use_tiled_image_verification(const image_descriptor *imageInfo)
+{
+    return gTestMaxImages && !gTestMipmaps
+        && get_image_size(imageInfo) > IMAGE_TILE_BUDGET;
+}
+
+struct ImageTile
+{
+    size_t origin[3];
+    size_t region[3];
+    BufferOwningPtr<char> input;
+    std::vector<char> result;
+    clEventWrapper readEvent;
+};
+
+// Waits for tile to be read back and compares it row by row with its input
+static int verify_image_tile(ImageTile &tile, const image_descriptor *imageInfo)
+{
+    if (!tile.readEvent) return 0;
+
+    cl_int error = clWaitForEvents(1, &tile.readEvent);
+    test_error(error, "Unable to wait for an image tile to be read");
+    tile.readEvent = nullptr;
+
+    size_t rowSize = tile.region[0] * get_pixel_size(imageInfo->format);
+    for (size_t y = 0; y < tile.region[1]; y++)
+    {
+        const char *expected = tile.input + y * rowSize;
+        const char *actual = tile.result.data() + y * rowSize;
+        size_t where = compare_pixels(imageInfo->format, expected, actual,
+                                      tile.region[0]);
+        if (where < tile.region[0])
+        {
+            log_error("ERROR: Tile at origin %zu,%zu,%zu region %zu,%zu,%zu "
+                      "of image %zu,%zu,%zu did not verify\n",
+                      tile.origin[0], tile.origin[1], tile.origin[2],
+                      tile.region[0], tile.region[1], tile.region[2],
+                      imageInfo->width, imageInfo->height,
+                      imageInfo->depth ? imageInfo->depth
+                                       : imageInfo->arraySize);
+            image_descriptor tileInfo = *imageInfo;
+            tileInfo.width = tile.region[0];
+            tileInfo.rowPitch = rowSize;
+            print_first_pixel_difference_error(
+                tile.origin[0] + where,
+                expected + where * get_pixel_size(imageInfo->format),
+                actual + where * get_pixel_size(imageInfo->format), &tileInfo,
+                tile.origin[1] + y, tile.origin[2]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_image_tiled(cl_context context, cl_command_queue queue,
+                     image_descriptor *imageInfo, cl_mem_flags flags,
+                     MTdata d, size_t tileBytes)
+{
+    cl_int error;
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+
+    cl_image_desc imageDesc = {};
+    imageDesc.image_type = imageInfo->type;
+    imageDesc.image_width = imageInfo->width;
+    imageDesc.image_height = imageInfo->height;
+    imageDesc.image_depth = imageInfo->depth;
+    imageDesc.image_array_size = imageInfo->arraySize;
+
+    clMemWrapper buffer;
+    if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_BUFFER)
+    {
+        buffer = clCreateBuffer(context, flags, imageInfo->width * pixelSize,
+                                nullptr, &error);
+        test_error(error, "Unable to create the buffer for a 1D image buffer");
+        imageDesc.mem_object = buffer;
+    }
+
+    clMemWrapper image = clCreateImage(context, flags, imageInfo->format,
+                                       &imageDesc, nullptr, &error);
+    if (error != CL_SUCCESS)
+    {
+        log_error("ERROR: Unable to create %s of size %zu,%zu,%zu (%s)\n",
+                  convert_image_type_to_string(imageInfo->type),
+                  imageInfo->width, imageInfo->height,
+                  imageInfo->depth ? imageInfo->depth : imageInfo->arraySize,
+                  IGetErrorString(error));
+        return -1;
+    }
+
+    // Rows and slices in the sense of clEnqueueReadImage origins
+    size_t rows = 1, slices = 1;
+    switch (imageInfo->type)
+    {
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY: rows = imageInfo->arraySize; break;
+        case CL_MEM_OBJECT_IMAGE2D: rows = imageInfo->height; break;
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            rows = imageInfo->height;
+            slices = imageInfo->arraySize;
+            break;
+        case CL_MEM_OBJECT_IMAGE3D:
+            rows = imageInfo->height;
+            slices = imageInfo->depth;
+            break;
+        default: break;
+    }
+
+    size_t rowSize = imageInfo->width * pixelSize;
+    size_t tileWidth = imageInfo->width, tileRows = 1;
+    if (rowSize <= tileBytes)
+        tileRows = std::min(rows, tileBytes / rowSize);
+    else
+        tileWidth = std::max(tileBytes / pixelSize, (size_t)1);
+
+    if (gDebugTrace)
+        log_info(" - Verifying in tiles of %zu x %zu pixels\n", tileWidth,
+                 tileRows);
+
+    ImageTile tiles[2];
+    size_t tileCount = 0;
+    auto transfer_and_verify = [&]() -> int {
+        for (size_t z = 0; z < slices; z++)
+        {
+            for (size_t y = 0; y < rows; y += tileRows)
+            {
+                for (size_t x = 0; x < imageInfo->width; x += tileWidth)
+                {
+                    // Reuse the buffers of the tile before last once it
+                    // verifies
+                    ImageTile &tile = tiles[tileCount++ % 2];
+                    if (verify_image_tile(tile, imageInfo)) return -1;
+
+                    tile.origin[0] = x;
+                    tile.origin[1] = y;
+                    tile.origin[2] = z;
+                    tile.region[0] =
+                        std::min(tileWidth, imageInfo->width - x);
+                    tile.region[1] = std::min(tileRows, rows - y);
+                    tile.region[2] = 1;
+
+                    image_descriptor tileInfo = {};
+                    tileInfo.type = CL_MEM_OBJECT_IMAGE2D;
+                    tileInfo.format = imageInfo->format;
+                    tileInfo.width = tile.region[0];
+                    tileInfo.height = tile.region[1];
+                    tileInfo.rowPitch = tile.region[0] * pixelSize;
+                    if (!generate_random_image_data(&tileInfo, tile.input,
+                                                    d))
+                        return -1;
+                    tile.result.assign(tileInfo.rowPitch * tileInfo.height,
+                                       (char)0xff);
+
+                    // 1D image arrays take the array index as the second
+                    // origin component, which is where rows already put it
+                    clEventWrapper writeEvent;
+                    error = clEnqueueWriteImage(queue, image, CL_FALSE,
+                                                tile.origin, tile.region, 0, 0,
+                                                tile.input, 0, nullptr,
+                                                &writeEvent);
+                    test_error(error, "Unable to write an image tile");
+                    error = clEnqueueReadImage(
+                        queue, image, CL_FALSE, tile.origin, tile.region, 0,
+                        0, tile.result.data(), 1, &writeEvent,
+                        &tile.readEvent);
+                    test_error(error, "Unable to read an image tile");
+                    error = clFlush(queue);
+                    test_error(error, "Unable to flush the queue");
+                }
+            }
+        }
+
+        for (size_t i = 0; i < 2; i++)
+            if (verify_image_tile(tiles[(tileCount + i) % 2], imageInfo))
+                return -1;
+        return 0;
+    };
+    int result = transfer_and_verify();
+
+    // An early return can leave the transfers of the other tile in flight,
+    // and they target the host memory of tiles
+    error = clFinish(queue);
+    test_error(error, "Unable to finish the image tile transfers");
+    return result;
+}
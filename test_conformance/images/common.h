@@ -22,6 +22,7 @@
 #include "harness/conversions.h"
 
 #include <array>
+#include <functional>
 #include <vector>
 
 extern cl_channel_type gChannelTypeToUse;
@@ -55,4 +56,51 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
                           image_descriptor *imageInfo, bool enable_pitch,
                           bool create_mipmaps, int *error);
 
+// One combination of a test matrix, such as a format with a sampler. run
+// performs the test on the queue it is given and returns nonzero on failure;
+// describe prints the combination the way the test loops print their headers.
+struct ImageTestJob
+{
+    std::function<int(cl_command_queue queue)> run;
+    std::function<void(bool error)> describe;
+};
+
+// Runs every job, counting them in gTestCount and gFailCount and reporting
+// the failures in job order. Jobs run one after another on queue unless
+// gParallelImageMatrix is set, in which case up to GetThreadCount() of them
+// run at once, each worker on a queue of its own. Runs with gTestRounding set
+// stay serial, since the rounding ramp is shared between jobs. Each job
+// starts from a seed of its own, derived from gRandomSeed and its index, so
+// the results do not depend on the order in which the jobs are picked up.
+// Reseeding waits until every job has finished.
+// Returns the number of jobs that failed.
+int run_image_test_jobs(cl_device_id device, cl_context context,
+                        cl_command_queue queue,
+                        const std::vector<ImageTestJob> &jobs);
+
+// The seed for the job running on the calling thread, or gRandomSeed outside
+// run_image_test_jobs()
+cl_uint image_test_job_seed();
+
+// Host bytes above which clReadWriteImage max_images runs verify an image in
+// tiles
+#define IMAGE_TILE_BUDGET ((size_t)256 * 1024 * 1024)
+
+// Whether imageInfo is large enough that test_image_tiled() should be used in
+// place of a whole image host copy. Only the clReadWriteImage round trips can
+// be tiled this way. kernel_read_write reads and writes its images from
+// kernels over whole-image host arrays, so its max_images paths still hold
+// full copies.
+bool use_tiled_image_verification(const image_descriptor *imageInfo);
+
+// Creates an image for imageInfo, then writes random data to it and reads it
+// back with clEnqueueWriteImage/clEnqueueReadImage one tile of at most
+// tileBytes at a time. Tiles are runs of whole rows where a row fits, so at
+// most two tiles of input and results are held on the host, and a tile is
+// verified while the next one is transferred. Mipmapped images are not
+// supported.
+int test_image_tiled(cl_context context, cl_command_queue queue,
+                     image_descriptor *imageInfo, cl_mem_flags flags,
+                     MTdata d, size_t tileBytes = IMAGE_TILE_BUDGET / 4);
+
 #endif // IMAGES_COMMON_H
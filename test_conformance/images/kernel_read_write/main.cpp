@@ -20,6 +20,7 @@
 #include "../harness/compat.h"
 #include "../harness/fpcontrol.h"
 #include "../harness/parseParameters.h"
+#include "../harness/rounding_mode.h"
 
 #if defined(__PPC__)
 // Global varaiable used to hold the FPU control register state. The FPSCR register can not
@@ -398,6 +399,8 @@ int main(int argc, const char *argv[])
             gTestMaxImages = true;
         else if( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if( strcmp( argv[i], "parallel_matrix" ) == 0 )
+            gParallelImageMatrix = true;
         else if( strcmp( argv[i], "rounding" ) == 0 )
             gTestRounding = true;
         else if( strcmp( argv[i], "extra_validate" ) == 0 )
@@ -471,8 +474,8 @@ int main(int argc, const char *argv[])
     // where reference is being computed to make sure we get non-flushed reference result. If implementation
     // returns flushed result, we correctly take care of that in verification code.
 
-    FPU_mode_type oldMode;
-    DisableFTZ(&oldMode);
+    FPUStateGuard fpState;
+    fpState.SetFTZ(false);
 
     int ret = runTestHarnessWithCheck(
         argCount, argList, test_registry::getInstance().num_tests(),
@@ -480,7 +483,7 @@ int main(int argc, const char *argv[])
         verifyImageSupport);
 
     // Restore FP state before leaving
-    RestoreFPState(&oldMode);
+    fpState.Restore();
 
     free(argList);
     return ret;
@@ -534,6 +537,7 @@ static void printUsage( const char *execName )
     log_info( "\tdebug_trace - Enables additional debug info logging\n" );
     log_info( "\textra_validate - Enables additional validation failure debug information\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info( "\tparallel_matrix - Runs independent format and sampler combinations concurrently, one queue per worker thread (see CL_TEST_NUM_THREADS)\n" );
     log_info( "\ttest_mipmaps - Enables mipmapped images\n");
     log_info( "\n" );
     log_info( "Test names:\n" );
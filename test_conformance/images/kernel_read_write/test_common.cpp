@@ -16,7 +16,12 @@
 
 #include "test_common.h"
 
+#include "harness/randomPool.h"
+#include "harness/rounding_mode.h"
+#include "harness/ThreadPool.h"
+
 #include <algorithm>
+#include <vector>
 
 cl_sampler create_sampler(cl_context context, image_sampler_data *sdata, bool test_mipmaps, cl_int *error) {
     cl_sampler sampler = nullptr;
@@ -75,6 +80,17 @@ bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
     return get_image_dimensions(imageInfo, width, height, depth, ignoreMe);
 }
 
+static void generate_coordinate_jitter(char *data, size_t size, MTdata d)
+{
+    for (size_t i = 0; i < size; i++) data[i] = random_in_range(-10, 10, d);
+}
+
+void fill_coordinate_jitter(cl_char *jitter, size_t count, MTdata d)
+{
+    static const RandomPool pool(1024 * 1024, generate_coordinate_jitter);
+    pool.Fill(jitter, count, d);
+}
+
 static bool InitFloatCoordsCommon(image_descriptor *imageInfo,
                                   image_sampler_data *imageSampler,
                                   float *xOffsets, float *yOffsets,
@@ -105,24 +121,21 @@ static bool InitFloatCoordsCommon(image_descriptor *imageInfo,
         }
         else
         {
+            std::vector<cl_char> jitter(3 * width_loop);
             for (size_t z = 0; z < depth_loop; z++)
             {
                 for (size_t y = 0; y < height_loop; y++)
                 {
-                    for (size_t x = 0; x < width_loop; x++, i++)
+                    fill_coordinate_jitter(jitter.data(), jitter.size(), d);
+                    const cl_char *j = jitter.data();
+                    for (size_t x = 0; x < width_loop; x++, i++, j += 3)
                     {
                         xOffsets[i] =
-                            (float)(xfract
-                                    + (double)((int)x
-                                               + random_in_range(-10, 10, d)));
+                            (float)(xfract + (double)((int)x + j[0]));
                         yOffsets[i] =
-                            (float)(yfract
-                                    + (double)((int)y
-                                               + random_in_range(-10, 10, d)));
+                            (float)(yfract + (double)((int)y + j[1]));
                         zOffsets[i] =
-                            (float)(zfract
-                                    + (double)((int)z
-                                               + random_in_range(-10, 10, d)));
+                            (float)(zfract + (double)((int)z + j[2]));
                     }
                 }
             }
@@ -278,6 +291,370 @@ static size_t get_image_num_pixels(image_descriptor *imageInfo, size_t width,
     return image_size;
 }
 
+// Which of the result checks in test_read_image applies
+enum ReadVerifyKind
+{
+    kReadVerifyDepth,
+    kReadVerifySRGB,
+    kReadVerifyFloat,
+    kReadVerifyUInt,
+    kReadVerifyInt
+};
+
+static ReadVerifyKind get_read_verify_kind(image_descriptor *imageInfo,
+                                           ExplicitType outputType)
+{
+    if (outputType == kFloat)
+    {
+        if (imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY
+            && imageInfo->format->image_channel_order == CL_DEPTH)
+            return kReadVerifyDepth;
+        if (is_sRGBA_order(imageInfo->format->image_channel_order))
+            return kReadVerifySRGB;
+        return kReadVerifyFloat;
+    }
+    return outputType == kUInt ? kReadVerifyUInt : kReadVerifyInt;
+}
+
+// Range of the normalized coordinate offsets tried for float results. For
+// the normalized case on a GPU we put in offsets to the X, Y and Z to see if
+// we land on the right pixel. This addresses the significant inaccuracy in
+// GPU normalization in OpenCL 1.0.
+static float get_float_norm_offset(image_sampler_data *imageSampler)
+{
+    if (!imageSampler->normalized_coords
+        || imageSampler->filter_mode != CL_FILTER_NEAREST || NORM_OFFSET == 0
+#if defined(__APPLE__)
+        // Apple requires its CPU implementation to do correctly rounded
+        // address arithmetic in all modes
+        || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+#endif
+    )
+        return 0.0f; // Loop only once
+    return NORM_OFFSET;
+}
+
+typedef struct ReadVerifyInfo_
+{
+    ReadVerifyKind kind;
+    char *imagePtr;
+    image_descriptor *imageInfo;
+    image_sampler_data *imageSampler;
+    const float *xOffsets;
+    const float *yOffsets;
+    const float *zOffsets;
+    const char *results;
+    size_t resultStride; // bytes per result pixel
+    int num_dimensions;
+    bool image_type_3D;
+    int lod;
+    double formatAbsoluteError;
+    float maxErr;
+    size_t pixelCount;
+    size_t pixelsPerJob;
+    cl_uchar *found; // per pixel, nonzero if the pixel verified
+    size_t *failures; // per job
+} ReadVerifyInfo;
+
+// Samples the reference for several pixels of the results at once, at one
+// set of normalized coordinate offsets.
+static void sample_verify_pixels(const ReadVerifyInfo *info,
+                                 const size_t *pixels, size_t count,
+                                 float norm_offset_x, float norm_offset_y,
+                                 float norm_offset_z, float *expected,
+                                 FloatPixel *maxPixels, int *hasDenormals)
+{
+    bool hasY = info->num_dimensions > 1;
+    std::vector<float> x(count), y(count), z(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        x[i] = info->xOffsets[pixels[i]];
+        if (hasY) y[i] = info->yOffsets[pixels[i]];
+        if (info->image_type_3D) z[i] = info->zOffsets[pixels[i]];
+    }
+
+    sample_image_pixels_float_offset(
+        info->imagePtr, info->imageInfo, x.data(), hasY ? y.data() : NULL,
+        info->image_type_3D ? z.data() : NULL, count, norm_offset_x,
+        hasY ? norm_offset_y : 0.0f,
+        info->image_type_3D ? norm_offset_z : 0.0f, info->imageSampler,
+        expected, maxPixels, hasDenormals, info->lod);
+}
+
+static float clamp_format_error(const ReadVerifyInfo *info, float err)
+{
+    // Clamp to the minimum absolute error for the format
+    return (err > 0 && err < info->formatAbsoluteError) ? 0.0f : err;
+}
+
+static const float *float_result(const ReadVerifyInfo *info, size_t j)
+{
+    return (const float *)(info->results + j * info->resultStride);
+}
+
+// Compares a float result with its reference for step 1 of the checks below.
+// flushed is set for the second try with the denormals flushed to zero, where
+// the max error needs to be adjusted in case the implementation flushes
+// subnormals to zero.
+static bool float_pixel_matches(const ReadVerifyInfo *info,
+                                const float *resultPtr, const float *expected,
+                                const FloatPixel &maxPixel, bool flushed)
+{
+    switch (info->kind)
+    {
+        case kReadVerifyDepth: {
+            float err1 = ABS_ERROR(resultPtr[0], expected[0]);
+            float maxErr1 = std::max(info->maxErr * maxPixel.p[0], FLT_MIN);
+            if (flushed)
+                maxErr1 += 4 * FLT_MIN;
+            else
+                err1 = clamp_format_error(info, err1);
+            return err1 <= maxErr1;
+        }
+        case kReadVerifySRGB: {
+            float err[4];
+            for (int c = 0; c < 3; c++)
+                err[c] = ABS_ERROR(sRGBmap(resultPtr[c]), sRGBmap(expected[c]));
+            err[3] = ABS_ERROR(resultPtr[3], expected[3]);
+            float maxErr = 0.5;
+            if (flushed)
+                maxErr += 4 * FLT_MIN;
+            else
+                for (int c = 0; c < 4; c++)
+                    err[c] = clamp_format_error(info, err[c]);
+            return (err[0] <= maxErr) && (err[1] <= maxErr)
+                && (err[2] <= maxErr) && (err[3] <= maxErr);
+        }
+        default: {
+            bool passed = true;
+            for (int c = 0; c < 4; c++)
+            {
+                float err = ABS_ERROR(resultPtr[c], expected[c]);
+                float maxErr = std::max(info->maxErr * maxPixel.p[c], FLT_MIN);
+                if (flushed)
+                    maxErr += 4 * FLT_MIN;
+                else
+                    err = clamp_format_error(info, err);
+                passed = passed && (err <= maxErr);
+            }
+            return passed;
+        }
+    }
+}
+
+// Step 1 of the checks below for the float results of a tile: go through and
+// see if each result verifies for any of the normalized coordinate offsets.
+// The reference is sampled for all pixels still unverified at each offset in
+// turn, which tries the same offsets per pixel as looping over the offsets
+// pixel by pixel. Returns the number of pixels that did not verify.
+static size_t verify_float_tile(const ReadVerifyInfo *info, size_t start,
+                                size_t end)
+{
+    size_t count = end - start;
+    std::vector<size_t> pending(count), retry;
+    std::vector<float> expected(4 * count);
+    std::vector<FloatPixel> maxPixels(count), retryMaxPixels;
+    std::vector<int> hasDenormals(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        pending[i] = start + i;
+        info->found[start + i] = 0;
+    }
+
+    float offset = get_float_norm_offset(info->imageSampler);
+    for (float norm_offset_x = -offset;
+         norm_offset_x <= offset && !pending.empty();
+         norm_offset_x += NORM_OFFSET)
+    {
+        for (float norm_offset_y = -offset;
+             norm_offset_y <= offset && !pending.empty();
+             norm_offset_y += NORM_OFFSET)
+        {
+            for (float norm_offset_z = -offset;
+                 norm_offset_z <= NORM_OFFSET && !pending.empty();
+                 norm_offset_z += NORM_OFFSET)
+            {
+                size_t n = pending.size(), kept = 0;
+                sample_verify_pixels(info, pending.data(), n, norm_offset_x,
+                                     norm_offset_y, norm_offset_z,
+                                     expected.data(), maxPixels.data(),
+                                     hasDenormals.data());
+
+                retry.clear();
+                retryMaxPixels.clear();
+                for (size_t i = 0; i < n; i++)
+                {
+                    size_t j = pending[i];
+                    if (float_pixel_matches(info, float_result(info, j),
+                                            &expected[4 * i], maxPixels[i],
+                                            false))
+                    {
+                        info->found[j] = 1;
+                    }
+                    else if (hasDenormals[i])
+                    {
+                        retry.push_back(j);
+                        retryMaxPixels.push_back(maxPixels[i]);
+                    }
+                    else
+                    {
+                        pending[kept++] = j;
+                    }
+                }
+
+                // Try flushing the denormals
+                if (!retry.empty())
+                {
+                    sample_verify_pixels(info, retry.data(), retry.size(),
+                                         norm_offset_x, norm_offset_y,
+                                         norm_offset_z, expected.data(), NULL,
+                                         NULL);
+                    for (size_t i = 0; i < retry.size(); i++)
+                    {
+                        size_t j = retry[i];
+                        if (float_pixel_matches(info, float_result(info, j),
+                                                &expected[4 * i],
+                                                retryMaxPixels[i], true))
+                            info->found[j] = 1;
+                        else
+                            pending[kept++] = j;
+                    }
+                }
+                pending.resize(kept);
+            }
+        }
+    }
+    return pending.size();
+}
+
+static inline cl_uint abs_diff_pixel(unsigned int x, unsigned int y)
+{
+    return abs_diff_uint(x, y);
+}
+
+static inline cl_uint abs_diff_pixel(int x, int y)
+{
+    return abs_diff_int(x, y);
+}
+
+template <class T>
+static bool verify_integer_pixel(const ReadVerifyInfo *info, size_t j,
+                                 const T *resultPtr)
+{
+    image_sampler_data *imageSampler = info->imageSampler;
+    bool hasY = info->num_dimensions > 1;
+    T expected[4];
+    int checkOnlyOnePixel = 0;
+    bool found_pixel = false;
+
+    for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET
+         && !found_pixel && !checkOnlyOnePixel;
+         norm_offset_x += NORM_OFFSET)
+    {
+        for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET
+             && !found_pixel && !checkOnlyOnePixel;
+             norm_offset_y += NORM_OFFSET)
+        {
+            for (float norm_offset_z = -NORM_OFFSET;
+                 norm_offset_z <= NORM_OFFSET && !found_pixel
+                 && !checkOnlyOnePixel;
+                 norm_offset_z += NORM_OFFSET)
+            {
+                // If we are not on a GPU, or we are not normalized, then only
+                // test with offsets (0.0, 0.0) E.g., test one pixel.
+                if (!imageSampler->normalized_coords
+                    || !(gDeviceType & CL_DEVICE_TYPE_GPU) || NORM_OFFSET == 0)
+                {
+                    norm_offset_x = 0.0f;
+                    norm_offset_y = 0.0f;
+                    norm_offset_z = 0.0f;
+                    checkOnlyOnePixel = 1;
+                }
+
+                sample_image_pixel_offset<T>(
+                    info->imagePtr, info->imageInfo, info->xOffsets[j],
+                    hasY ? info->yOffsets[j] : 0.0f,
+                    info->image_type_3D ? info->zOffsets[j] : 0.0f,
+                    norm_offset_x, hasY ? norm_offset_y : 0.0f,
+                    info->image_type_3D ? norm_offset_z : 0.0f, imageSampler,
+                    expected, info->lod);
+
+                float error =
+                    errMax(errMax(abs_diff_pixel(expected[0], resultPtr[0]),
+                                  abs_diff_pixel(expected[1], resultPtr[1])),
+                           errMax(abs_diff_pixel(expected[2], resultPtr[2]),
+                                  abs_diff_pixel(expected[3], resultPtr[3])));
+
+                if (error < MAX_ERR) found_pixel = true;
+            }
+        }
+    }
+    return found_pixel;
+}
+
+// Runs step 1 of the verification for one tile of consecutive pixels, which
+// is a run of whole rows or slices unless the rows are very long. Failures
+// are only counted here; they are reported in pixel order by the caller so
+// the log does not depend on the number of threads.
+static cl_int verify_read_tile(cl_uint job_id, cl_uint thread_id,
+                               void *userInfo)
+{
+    const ReadVerifyInfo *info = (const ReadVerifyInfo *)userInfo;
+    size_t start = job_id * info->pixelsPerJob;
+    size_t end = std::min(start + info->pixelsPerJob, info->pixelCount);
+    size_t failures = 0;
+
+    // The reference must not flush denormals on the worker threads either
+    FPUStateGuard fpState;
+    fpState.SetFTZ(false);
+
+    if (info->kind != kReadVerifyUInt && info->kind != kReadVerifyInt)
+    {
+        info->failures[job_id] = verify_float_tile(info, start, end);
+        return CL_SUCCESS;
+    }
+
+    for (size_t j = start; j < end; j++)
+    {
+        const char *resultPtr = info->results + j * info->resultStride;
+        bool found_pixel = info->kind == kReadVerifyUInt
+            ? verify_integer_pixel<unsigned int>(
+                info, j, (const unsigned int *)resultPtr)
+            : verify_integer_pixel<int>(info, j, (const int *)resultPtr);
+        info->found[j] = found_pixel;
+        failures += !found_pixel;
+    }
+
+    info->failures[job_id] = failures;
+    return CL_SUCCESS;
+}
+
+// Checks every pixel of the results on the thread pool and returns the number
+// of pixels that did not verify in failureCount.
+static int verify_read_results(ReadVerifyInfo *info, size_t rowWidth,
+                               size_t *failureCount)
+{
+    // A few tiles per thread keep the workers balanced when some pixels need
+    // all the offsets tried and others verify on the first one
+    const size_t minPixelsPerJob = 256;
+    size_t jobCount = 4 * (size_t)GetThreadCount();
+    size_t pixelsPerJob = std::max(
+        (info->pixelCount + jobCount - 1) / jobCount, minPixelsPerJob);
+    if (pixelsPerJob >= rowWidth)
+        pixelsPerJob = (pixelsPerJob + rowWidth - 1) / rowWidth * rowWidth;
+    jobCount = (info->pixelCount + pixelsPerJob - 1) / pixelsPerJob;
+
+    std::vector<size_t> failures(jobCount, 0);
+    info->pixelsPerJob = pixelsPerJob;
+    info->failures = failures.data();
+    int error = ThreadPool_Do(verify_read_tile, (cl_uint)jobCount, info);
+    if (error != CL_SUCCESS) return error;
+
+    *failureCount = 0;
+    for (size_t f : failures) *failureCount += f;
+    return CL_SUCCESS;
+}
+
 int test_read_image(cl_context context, cl_command_queue queue,
                     cl_kernel kernel, image_descriptor *imageInfo,
                     image_sampler_data *imageSampler, bool useFloatCoords,
@@ -595,6 +972,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
         }
     }
 
+    ReadVerifyKind verifyKind = get_read_verify_kind(imageInfo, outputType);
     int nextLevelOffset = 0;
     size_t width_lod = width_size, height_lod = height_size,
            depth_lod = depth_size;
@@ -610,6 +988,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
         size_t resultValuesSize =
             image_lod_size * get_explicit_type_size(outputType) * 4;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
+        std::vector<cl_uchar> pixelFound(image_lod_size);
         float lod_float = (float)lod;
         if (gTestMipmaps)
         {
@@ -673,11 +1052,40 @@ int test_read_image(cl_context context, cl_command_queue queue,
             test_error(error, "Unable to read results from kernel");
             if (gDebugTrace) log_info("    results read\n");
 
-            // Validate results element by element
+            // Validate results element by element. The pixels are checked
+            // on the thread pool first, then the ones that failed are
+            // reported in order on this thread.
             char *imagePtr = (char *)imageValues + nextLevelOffset;
-            if (((imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
-                 && (imageInfo->format->image_channel_order == CL_DEPTH))
-                && (outputType == kFloat))
+            ReadVerifyInfo verifyInfo;
+            verifyInfo.kind = verifyKind;
+            verifyInfo.imagePtr = imagePtr;
+            verifyInfo.imageInfo = imageInfo;
+            verifyInfo.imageSampler = imageSampler;
+            verifyInfo.xOffsets = xOffsetValues;
+            verifyInfo.yOffsets = yOffsetValues;
+            verifyInfo.zOffsets = zOffsetValues;
+            verifyInfo.results = resultValues;
+            verifyInfo.resultStride = verifyKind == kReadVerifyDepth
+                ? sizeof(float)
+                : get_explicit_type_size(outputType) * 4;
+            verifyInfo.num_dimensions = num_dimensions;
+            verifyInfo.image_type_3D = image_type_3D;
+            verifyInfo.lod = lod;
+            verifyInfo.formatAbsoluteError = formatAbsoluteError;
+            verifyInfo.maxErr = outputType == kFloat
+                ? get_max_relative_error(
+                    imageInfo->format, imageSampler, image_type_3D,
+                    CL_FILTER_LINEAR == imageSampler->filter_mode)
+                : 0.0f;
+            verifyInfo.pixelCount = image_lod_size;
+            verifyInfo.found = pixelFound.data();
+
+            size_t failureCount = 0;
+            error = verify_read_results(&verifyInfo, width_lod, &failureCount);
+            test_error(error, "Unable to verify results");
+            if (0 == failureCount) continue;
+
+            if (verifyKind == kReadVerifyDepth)
             {
                 // Validate float results
                 float *resultPtr = (float *)(char *)resultValues;
@@ -692,96 +1100,10 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     {
                         for (size_t x = 0; x < width_lod; x++, j++)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
+                            // Step 1 ran on the thread pool
                             int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            float offset = NORM_OFFSET;
-                            if (!imageSampler->normalized_coords
-                                || imageSampler->filter_mode
-                                    != CL_FILTER_NEAREST
-                                || NORM_OFFSET == 0
-#if defined(__APPLE__)
-                                // Apple requires its CPU implementation to do
-                                // correctly rounded address arithmetic in all
-                                // modes
-                                || !(gDeviceType & CL_DEVICE_TYPE_GPU)
-#endif
-                            )
-                                offset = 0.0f; // Loop only once
-
-                            for (float norm_offset_x = -offset;
-                                 norm_offset_x <= offset && !found_pixel;
-                                 norm_offset_x += NORM_OFFSET)
-                            {
-                                for (float norm_offset_y = -offset;
-                                     norm_offset_y <= offset && !found_pixel;
-                                     norm_offset_y += NORM_OFFSET)
-                                {
-                                    for (float norm_offset_z = -offset;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
-
-                                        int hasDenormals = 0;
-                                        FloatPixel maxPixel =
-                                            sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
-                                                xOffsetValues[j],
-                                                yOffsetValues[j],
-                                                zOffsetValues[j], norm_offset_x,
-                                                norm_offset_y, norm_offset_z,
-                                                imageSampler, expected, 0,
-                                                &hasDenormals, lod);
-
-                                        float err1 = ABS_ERROR(resultPtr[0],
-                                                               expected[0]);
-                                        // Clamp to the minimum absolute error
-                                        // for the format
-                                        if (err1 > 0
-                                            && err1 < formatAbsoluteError)
-                                        {
-                                            err1 = 0.0f;
-                                        }
-                                        float maxErr1 = std::max(
-                                            maxErr * maxPixel.p[0], FLT_MIN);
-
-                                        if (!(err1 <= maxErr1))
-                                        {
-                                            // Try flushing the denormals
-                                            if (hasDenormals)
-                                            {
-                                                // If implementation decide to
-                                                // flush subnormals to zero, max
-                                                // error needs to be adjusted
-                                                maxErr1 += 4 * FLT_MIN;
-
-                                                maxPixel =
-                                                    sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
-                                                        xOffsetValues[j],
-                                                        yOffsetValues[j],
-                                                        zOffsetValues[j],
-                                                        norm_offset_x,
-                                                        norm_offset_y,
-                                                        norm_offset_z,
-                                                        imageSampler, expected,
-                                                        0, NULL, lod);
-
-                                                err1 = ABS_ERROR(resultPtr[0],
-                                                                 expected[0]);
-                                            }
-                                        }
-
-                                        found_pixel = (err1 <= maxErr1);
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                            int found_pixel = pixelFound[j];
+                            float offset = get_float_norm_offset(imageSampler);
 
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
@@ -925,8 +1247,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
             /*
              * FLOAT output type
              */
-            else if (is_sRGBA_order(imageInfo->format->image_channel_order)
-                     && (outputType == kFloat))
+            else if (verifyKind == kReadVerifySRGB)
             {
                 // Validate float results
                 float *resultPtr = (float *)(char *)resultValues;
@@ -941,150 +1262,10 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     {
                         for (size_t x = 0; x < width_lod; x++, j++)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
+                            // Step 1 ran on the thread pool
                             int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            float offset = NORM_OFFSET;
-                            if (!imageSampler->normalized_coords
-                                || imageSampler->filter_mode
-                                    != CL_FILTER_NEAREST
-                                || NORM_OFFSET == 0
-#if defined(__APPLE__)
-                                // Apple requires its CPU implementation to do
-                                // correctly rounded address arithmetic in all
-                                // modes
-                                || !(gDeviceType & CL_DEVICE_TYPE_GPU)
-#endif
-                            )
-                                offset = 0.0f; // Loop only once
-
-                            for (float norm_offset_x = -offset;
-                                 norm_offset_x <= offset && !found_pixel;
-                                 norm_offset_x += NORM_OFFSET)
-                            {
-                                for (float norm_offset_y = -offset;
-                                     norm_offset_y <= offset && !found_pixel;
-                                     norm_offset_y += NORM_OFFSET)
-                                {
-                                    for (float norm_offset_z = -offset;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
-
-                                        int hasDenormals = 0;
-                                        FloatPixel maxPixel =
-                                            sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
-                                                xOffsetValues[j],
-                                                (num_dimensions > 1)
-                                                    ? yOffsetValues[j]
-                                                    : 0.0f,
-                                                image_type_3D ? zOffsetValues[j]
-                                                              : 0.0f,
-                                                norm_offset_x,
-                                                (num_dimensions > 1)
-                                                    ? norm_offset_y
-                                                    : 0.0f,
-                                                image_type_3D ? norm_offset_z
-                                                              : 0.0f,
-                                                imageSampler, expected, 0,
-                                                &hasDenormals, lod);
-
-                                        float err1 =
-                                            ABS_ERROR(sRGBmap(resultPtr[0]),
-                                                      sRGBmap(expected[0]));
-                                        float err2 =
-                                            ABS_ERROR(sRGBmap(resultPtr[1]),
-                                                      sRGBmap(expected[1]));
-                                        float err3 =
-                                            ABS_ERROR(sRGBmap(resultPtr[2]),
-                                                      sRGBmap(expected[2]));
-                                        float err4 = ABS_ERROR(resultPtr[3],
-                                                               expected[3]);
-                                        // Clamp to the minimum absolute error
-                                        // for the format
-                                        if (err1 > 0
-                                            && err1 < formatAbsoluteError)
-                                        {
-                                            err1 = 0.0f;
-                                        }
-                                        if (err2 > 0
-                                            && err2 < formatAbsoluteError)
-                                        {
-                                            err2 = 0.0f;
-                                        }
-                                        if (err3 > 0
-                                            && err3 < formatAbsoluteError)
-                                        {
-                                            err3 = 0.0f;
-                                        }
-                                        if (err4 > 0
-                                            && err4 < formatAbsoluteError)
-                                        {
-                                            err4 = 0.0f;
-                                        }
-                                        float maxErr = 0.5;
-
-                                        if (!(err1 <= maxErr)
-                                            || !(err2 <= maxErr)
-                                            || !(err3 <= maxErr)
-                                            || !(err4 <= maxErr))
-                                        {
-                                            // Try flushing the denormals
-                                            if (hasDenormals)
-                                            {
-                                                // If implementation decide to
-                                                // flush subnormals to zero, max
-                                                // error needs to be adjusted
-                                                maxErr += 4 * FLT_MIN;
-
-                                                maxPixel =
-                                                    sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
-                                                        xOffsetValues[j],
-                                                        (num_dimensions > 1)
-                                                            ? yOffsetValues[j]
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? zOffsetValues[j]
-                                                            : 0.0f,
-                                                        norm_offset_x,
-                                                        (num_dimensions > 1)
-                                                            ? norm_offset_y
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? norm_offset_z
-                                                            : 0.0f,
-                                                        imageSampler, expected,
-                                                        0, NULL, lod);
-
-                                                err1 = ABS_ERROR(
-                                                    sRGBmap(resultPtr[0]),
-                                                    sRGBmap(expected[0]));
-                                                err2 = ABS_ERROR(
-                                                    sRGBmap(resultPtr[1]),
-                                                    sRGBmap(expected[1]));
-                                                err3 = ABS_ERROR(
-                                                    sRGBmap(resultPtr[2]),
-                                                    sRGBmap(expected[2]));
-                                                err4 = ABS_ERROR(resultPtr[3],
-                                                                 expected[3]);
-                                            }
-                                        }
-
-                                        found_pixel = (err1 <= maxErr)
-                                            && (err2 <= maxErr)
-                                            && (err3 <= maxErr)
-                                            && (err4 <= maxErr);
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                            int found_pixel = pixelFound[j];
+                            float offset = get_float_norm_offset(imageSampler);
 
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
@@ -1304,7 +1485,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
             /*
              * FLOAT output type
              */
-            else if (outputType == kFloat)
+            else if (verifyKind == kReadVerifyFloat)
             {
                 // Validate float results
                 float *resultPtr = (float *)(char *)resultValues;
@@ -1319,154 +1500,10 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     {
                         for (size_t x = 0; x < width_lod; x++, j++)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
+                            // Step 1 ran on the thread pool
                             int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            float offset = NORM_OFFSET;
-                            if (!imageSampler->normalized_coords
-                                || imageSampler->filter_mode
-                                    != CL_FILTER_NEAREST
-                                || NORM_OFFSET == 0
-#if defined(__APPLE__)
-                                // Apple requires its CPU implementation to do
-                                // correctly rounded address arithmetic in all
-                                // modes
-                                || !(gDeviceType & CL_DEVICE_TYPE_GPU)
-#endif
-                            )
-                                offset = 0.0f; // Loop only once
-
-                            for (float norm_offset_x = -offset;
-                                 norm_offset_x <= offset && !found_pixel;
-                                 norm_offset_x += NORM_OFFSET)
-                            {
-                                for (float norm_offset_y = -offset;
-                                     norm_offset_y <= offset && !found_pixel;
-                                     norm_offset_y += NORM_OFFSET)
-                                {
-                                    for (float norm_offset_z = -offset;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
-
-                                        int hasDenormals = 0;
-                                        FloatPixel maxPixel =
-                                            sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
-                                                xOffsetValues[j],
-                                                (num_dimensions > 1)
-                                                    ? yOffsetValues[j]
-                                                    : 0.0f,
-                                                image_type_3D ? zOffsetValues[j]
-                                                              : 0.0f,
-                                                norm_offset_x,
-                                                (num_dimensions > 1)
-                                                    ? norm_offset_y
-                                                    : 0.0f,
-                                                image_type_3D ? norm_offset_z
-                                                              : 0.0f,
-                                                imageSampler, expected, 0,
-                                                &hasDenormals, lod);
-
-                                        float err1 = ABS_ERROR(resultPtr[0],
-                                                               expected[0]);
-                                        float err2 = ABS_ERROR(resultPtr[1],
-                                                               expected[1]);
-                                        float err3 = ABS_ERROR(resultPtr[2],
-                                                               expected[2]);
-                                        float err4 = ABS_ERROR(resultPtr[3],
-                                                               expected[3]);
-                                        // Clamp to the minimum absolute error
-                                        // for the format
-                                        if (err1 > 0
-                                            && err1 < formatAbsoluteError)
-                                        {
-                                            err1 = 0.0f;
-                                        }
-                                        if (err2 > 0
-                                            && err2 < formatAbsoluteError)
-                                        {
-                                            err2 = 0.0f;
-                                        }
-                                        if (err3 > 0
-                                            && err3 < formatAbsoluteError)
-                                        {
-                                            err3 = 0.0f;
-                                        }
-                                        if (err4 > 0
-                                            && err4 < formatAbsoluteError)
-                                        {
-                                            err4 = 0.0f;
-                                        }
-                                        float maxErr1 = std::max(
-                                            maxErr * maxPixel.p[0], FLT_MIN);
-                                        float maxErr2 = std::max(
-                                            maxErr * maxPixel.p[1], FLT_MIN);
-                                        float maxErr3 = std::max(
-                                            maxErr * maxPixel.p[2], FLT_MIN);
-                                        float maxErr4 = std::max(
-                                            maxErr * maxPixel.p[3], FLT_MIN);
-
-                                        if (!(err1 <= maxErr1)
-                                            || !(err2 <= maxErr2)
-                                            || !(err3 <= maxErr3)
-                                            || !(err4 <= maxErr4))
-                                        {
-                                            // Try flushing the denormals
-                                            if (hasDenormals)
-                                            {
-                                                // If implementation decide to
-                                                // flush subnormals to zero, max
-                                                // error needs to be adjusted
-                                                maxErr1 += 4 * FLT_MIN;
-                                                maxErr2 += 4 * FLT_MIN;
-                                                maxErr3 += 4 * FLT_MIN;
-                                                maxErr4 += 4 * FLT_MIN;
-
-                                                maxPixel =
-                                                    sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
-                                                        xOffsetValues[j],
-                                                        (num_dimensions > 1)
-                                                            ? yOffsetValues[j]
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? zOffsetValues[j]
-                                                            : 0.0f,
-                                                        norm_offset_x,
-                                                        (num_dimensions > 1)
-                                                            ? norm_offset_y
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? norm_offset_z
-                                                            : 0.0f,
-                                                        imageSampler, expected,
-                                                        0, NULL, lod);
-
-                                                err1 = ABS_ERROR(resultPtr[0],
-                                                                 expected[0]);
-                                                err2 = ABS_ERROR(resultPtr[1],
-                                                                 expected[1]);
-                                                err3 = ABS_ERROR(resultPtr[2],
-                                                                 expected[2]);
-                                                err4 = ABS_ERROR(resultPtr[3],
-                                                                 expected[3]);
-                                            }
-                                        }
-
-                                        found_pixel = (err1 <= maxErr1)
-                                            && (err2 <= maxErr2)
-                                            && (err3 <= maxErr3)
-                                            && (err4 <= maxErr4);
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                            int found_pixel = pixelFound[j];
+                            float offset = get_float_norm_offset(imageSampler);
 
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
@@ -1694,7 +1731,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
             /*
              * UINT output type
              */
-            else if (outputType == kUInt)
+            else if (verifyKind == kReadVerifyUInt)
             {
                 // Validate unsigned integer results
                 unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
@@ -1706,75 +1743,9 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     {
                         for (size_t x = 0; x < width_lod; x++, j++)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
+                            // Step 1 ran on the thread pool
                             int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            for (float norm_offset_x = -NORM_OFFSET;
-                                 norm_offset_x <= NORM_OFFSET && !found_pixel
-                                 && !checkOnlyOnePixel;
-                                 norm_offset_x += NORM_OFFSET)
-                            {
-                                for (float norm_offset_y = -NORM_OFFSET;
-                                     norm_offset_y <= NORM_OFFSET
-                                     && !found_pixel && !checkOnlyOnePixel;
-                                     norm_offset_y += NORM_OFFSET)
-                                {
-                                    for (float norm_offset_z = -NORM_OFFSET;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel && !checkOnlyOnePixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
-
-                                        // If we are not on a GPU, or we are not
-                                        // normalized, then only test with
-                                        // offsets (0.0, 0.0) E.g., test one
-                                        // pixel.
-                                        if (!imageSampler->normalized_coords
-                                            || !(gDeviceType
-                                                 & CL_DEVICE_TYPE_GPU)
-                                            || NORM_OFFSET == 0)
-                                        {
-                                            norm_offset_x = 0.0f;
-                                            norm_offset_y = 0.0f;
-                                            norm_offset_z = 0.0f;
-                                            checkOnlyOnePixel = 1;
-                                        }
-
-                                        sample_image_pixel_offset<unsigned int>(
-                                            imagePtr, imageInfo,
-                                            xOffsetValues[j],
-                                            (num_dimensions > 1)
-                                                ? yOffsetValues[j]
-                                                : 0.0f,
-                                            image_type_3D ? zOffsetValues[j]
-                                                          : 0.0f,
-                                            norm_offset_x,
-                                            (num_dimensions > 1) ? norm_offset_y
-                                                                 : 0.0f,
-                                            image_type_3D ? norm_offset_z
-                                                          : 0.0f,
-                                            imageSampler, expected, lod);
-
-                                        error = errMax(
-                                            errMax(abs_diff_uint(expected[0],
-                                                                 resultPtr[0]),
-                                                   abs_diff_uint(expected[1],
-                                                                 resultPtr[1])),
-                                            errMax(
-                                                abs_diff_uint(expected[2],
-                                                              resultPtr[2]),
-                                                abs_diff_uint(expected[3],
-                                                              resultPtr[3])));
-
-                                        if (error < MAX_ERR) found_pixel = 1;
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                            int found_pixel = pixelFound[j];
 
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
@@ -1913,74 +1884,9 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     {
                         for (size_t x = 0; x < width_lod; x++, j++)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
+                            // Step 1 ran on the thread pool
                             int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            for (float norm_offset_x = -NORM_OFFSET;
-                                 norm_offset_x <= NORM_OFFSET && !found_pixel
-                                 && !checkOnlyOnePixel;
-                                 norm_offset_x += NORM_OFFSET)
-                            {
-                                for (float norm_offset_y = -NORM_OFFSET;
-                                     norm_offset_y <= NORM_OFFSET
-                                     && !found_pixel && !checkOnlyOnePixel;
-                                     norm_offset_y += NORM_OFFSET)
-                                {
-                                    for (float norm_offset_z = -NORM_OFFSET;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel && !checkOnlyOnePixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
-
-                                        // If we are not on a GPU, or we are not
-                                        // normalized, then only test with
-                                        // offsets (0.0, 0.0) E.g., test one
-                                        // pixel.
-                                        if (!imageSampler->normalized_coords
-                                            || !(gDeviceType
-                                                 & CL_DEVICE_TYPE_GPU)
-                                            || NORM_OFFSET == 0)
-                                        {
-                                            norm_offset_x = 0.0f;
-                                            norm_offset_y = 0.0f;
-                                            norm_offset_z = 0.0f;
-                                            checkOnlyOnePixel = 1;
-                                        }
-
-                                        sample_image_pixel_offset<int>(
-                                            imagePtr, imageInfo,
-                                            xOffsetValues[j],
-                                            (num_dimensions > 1)
-                                                ? yOffsetValues[j]
-                                                : 0.0f,
-                                            image_type_3D ? zOffsetValues[j]
-                                                          : 0.0f,
-                                            norm_offset_x,
-                                            (num_dimensions > 1) ? norm_offset_y
-                                                                 : 0.0f,
-                                            image_type_3D ? norm_offset_z
-                                                          : 0.0f,
-                                            imageSampler, expected, lod);
-
-                                        error = errMax(
-                                            errMax(abs_diff_int(expected[0],
-                                                                resultPtr[0]),
-                                                   abs_diff_int(expected[1],
-                                                                resultPtr[1])),
-                                            errMax(abs_diff_int(expected[2],
-                                                                resultPtr[2]),
-                                                   abs_diff_int(expected[3],
-                                                                resultPtr[3])));
-
-                                        if (error < MAX_ERR) found_pixel = 1;
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                            int found_pixel = pixelFound[j];
 
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
@@ -45,6 +45,10 @@ extern int test_read_image(cl_context context, cl_command_queue queue,
 extern bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
                                  size_t &height, size_t &depth);
 
+// Fills jitter with count random coordinate offsets in [-10, 10], taken from
+// a pool generated once per run. The values depend only on d.
+extern void fill_coordinate_jitter(cl_char *jitter, size_t count, MTdata d);
+
 template <class T>
 int determine_validation_error_offset(
     void *imagePtr, image_descriptor *imageInfo,
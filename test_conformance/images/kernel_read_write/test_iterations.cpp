@@ -14,10 +14,12 @@
 // limitations under the License.
 //
 #include "test_common.h"
+#include "../common.h"
 #include <float.h>
 
 #include <algorithm>
 #include <cinttypes>
+#include <vector>
 
 #if defined( __APPLE__ )
     #include <signal.h>
@@ -310,12 +312,15 @@ static void InitFloatCoords( image_descriptor *imageInfo, image_sampler_data *im
     }
     else
     {
+        std::vector<cl_char> jitter( 2 * width_lod );
         for( size_t y = 0; y < height_lod; y++ )
         {
-            for( size_t x = 0; x < width_lod; x++, i++ )
+            fill_coordinate_jitter( jitter.data(), jitter.size(), d );
+            const cl_char *j = jitter.data();
+            for( size_t x = 0; x < width_lod; x++, i++, j += 2 )
             {
-                xOffsets[ i ] = (float) (xfract + (double) ((int) x + random_in_range( -10, 10, d )));
-                yOffsets[ i ] = (float) (yfract + (double) ((int) y + random_in_range( -10, 10, d )));
+                xOffsets[ i ] = (float) (xfract + (double) ((int) x + j[ 0 ]));
+                yOffsets[ i ] = (float) (yfract + (double) ((int) y + j[ 1 ]));
             }
         }
     }
@@ -1142,47 +1147,16 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
 
 bool validate_float_write_results( float *expected, float *actual, image_descriptor *imageInfo )
 {
-    bool pass = true;
-    // Compare floats
-    if( memcmp( expected, actual, sizeof( cl_float ) * get_format_channel_count( imageInfo->format ) ) != 0 )
-    {
-        // 8.3.3 Fix up cases where we have NaNs or flushed denorms; "all other values must be preserved"
-        for ( size_t j = 0; j < get_format_channel_count( imageInfo->format ); j++ )
-        {
-            if ( isnan( expected[j] ) && isnan( actual[j] ) )
-                continue;
-            if ( IsFloatSubnormal( expected[j] ) && actual[j] == 0.0f )
-                continue;
-            if (expected[j] != actual[j])
-            {
-                pass = false;
-                break;
-            }
-        }
-    }
-    return pass;
+    // 8.3.3 NaNs and flushed denorms are allowed; "all other values must be preserved"
+    return compare_pixels( imageInfo->format, (const char *)expected, (const char *)actual, 1,
+                           kPixelCompareFloatTolerant ) == 1;
 }
 
 bool validate_half_write_results( cl_half *expected, cl_half *actual, image_descriptor *imageInfo )
 {
-    bool pass = true;
-    // Compare half floats
-    if (memcmp(expected, actual, sizeof( cl_half ) * get_format_channel_count(imageInfo->format)) != 0) {
-
-        // 8.3.2 Fix up cases where we have NaNs or generated half denormals
-        for ( size_t j = 0; j < get_format_channel_count( imageInfo->format ); j++ ) {
-            if ( is_half_nan( expected[j] ) && is_half_nan( actual[j] ) )
-                continue;
-            if ( is_half_denorm( expected[j] ) && is_half_zero( actual[j] ) )
-                continue;
-            if (expected[j] != actual[j])
-            {
-                pass = false;
-                break;
-            }
-        }
-    }
-    return pass;
+    // 8.3.2 NaNs and generated half denormals are allowed
+    return compare_pixels( imageInfo->format, (const char *)expected, (const char *)actual, 1,
+                           kPixelCompareFloatTolerant ) == 1;
 }
 
 int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel kernel,
@@ -1595,7 +1569,7 @@ int test_read_image_set_2D(cl_device_id device, cl_context context,
     }
 
 
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     int error;
 
     // Get our operating params
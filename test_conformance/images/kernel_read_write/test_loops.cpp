@@ -50,12 +50,47 @@ extern int test_read_image_set_2D_array(cl_device_id device, cl_context context,
                                         bool floatCoords,
                                         ExplicitType outputType);
 
-int test_read_image_type(cl_device_id device, cl_context context,
-                         cl_command_queue queue, const cl_image_format *format,
-                         bool floatCoords, image_sampler_data *imageSampler,
-                         ExplicitType outputType, cl_mem_object_type imageType)
+static int test_read_image_set(cl_device_id device, cl_context context,
+                               cl_command_queue queue,
+                               const cl_image_format *format,
+                               image_sampler_data *imageSampler,
+                               bool floatCoords, ExplicitType outputType,
+                               cl_mem_object_type imageType)
+{
+    switch (imageType)
+    {
+        case CL_MEM_OBJECT_IMAGE1D:
+            return test_read_image_set_1D(device, context, queue, format,
+                                          imageSampler, floatCoords,
+                                          outputType);
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            return test_read_image_set_1D_array(device, context, queue, format,
+                                                imageSampler, floatCoords,
+                                                outputType);
+        case CL_MEM_OBJECT_IMAGE2D:
+            return test_read_image_set_2D(device, context, queue, format,
+                                          imageSampler, floatCoords,
+                                          outputType);
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            return test_read_image_set_2D_array(device, context, queue, format,
+                                                imageSampler, floatCoords,
+                                                outputType);
+        case CL_MEM_OBJECT_IMAGE3D:
+            return test_read_image_set_3D(device, context, queue, format,
+                                          imageSampler, floatCoords,
+                                          outputType);
+    }
+    return 0;
+}
+
+static void add_read_image_jobs(std::vector<ImageTestJob> &jobs,
+                                cl_device_id device, cl_context context,
+                                const cl_image_format *format,
+                                bool floatCoords,
+                                const image_sampler_data *imageSampler,
+                                ExplicitType outputType,
+                                cl_mem_object_type imageType)
 {
-    int ret = 0;
     cl_addressing_mode *addressModes = NULL;
 
     // The sampler-less read image functions behave exactly as the corresponding
@@ -91,15 +126,13 @@ int test_read_image_type(cl_device_id device, cl_context context,
     {
         log_info("--- Skipping CL_RGB CL_UNORM_INT_101010 format with "
                  "CL_FILTER_LINEAR on GPU.\n");
-        return 0;
+        return;
     }
 #endif
 
     for (int adMode = 0; addressModes[adMode] != (cl_addressing_mode)-1;
          adMode++)
     {
-        imageSampler->addressing_mode = addressModes[adMode];
-
         if ((addressModes[adMode] == CL_ADDRESS_REPEAT
              || addressModes[adMode] == CL_ADDRESS_MIRRORED_REPEAT)
             && !(imageSampler->normalized_coords))
@@ -107,7 +140,7 @@ int test_read_image_type(cl_device_id device, cl_context context,
 
         // Use this run if we were told to only run a certain filter mode
         if (gAddressModeToUse != (cl_addressing_mode)-1
-            && imageSampler->addressing_mode != gAddressModeToUse)
+            && addressModes[adMode] != gAddressModeToUse)
             continue;
 
         /*
@@ -117,50 +150,24 @@ int test_read_image_type(cl_device_id device, cl_context context,
          imageSampler->addressing_mode == CL_ADDRESS_REPEAT ) continue; //repeat
          mode requires normalized coordinates
          */
-        print_read_header(format, imageSampler, false);
 
-        gTestCount++;
-
-        int retCode = 0;
-        switch (imageType)
-        {
-            case CL_MEM_OBJECT_IMAGE1D:
-                retCode = test_read_image_set_1D(device, context, queue, format,
-                                                 imageSampler, floatCoords,
-                                                 outputType);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retCode = test_read_image_set_1D_array(device, context, queue,
-                                                       format, imageSampler,
-                                                       floatCoords, outputType);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retCode = test_read_image_set_2D(device, context, queue, format,
-                                                 imageSampler, floatCoords,
-                                                 outputType);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retCode = test_read_image_set_2D_array(device, context, queue,
-                                                       format, imageSampler,
-                                                       floatCoords, outputType);
-                break;
-            case CL_MEM_OBJECT_IMAGE3D:
-                retCode = test_read_image_set_3D(device, context, queue, format,
-                                                 imageSampler, floatCoords,
-                                                 outputType);
-                break;
-        }
-        if (retCode != 0)
-        {
-            gFailCount++;
-            log_error("FAILED: ");
-            print_read_header(format, imageSampler, true);
-            log_info("\n");
-        }
-        ret |= retCode;
+        // Each job owns its format and sampler, since the caller's copies
+        // change before the jobs run
+        image_sampler_data sampler = *imageSampler;
+        sampler.addressing_mode = addressModes[adMode];
+        cl_image_format imageFormat = *format;
+
+        ImageTestJob job;
+        job.run = [=](cl_command_queue queue) mutable {
+            return test_read_image_set(device, context, queue, &imageFormat,
+                                       &sampler, floatCoords, outputType,
+                                       imageType);
+        };
+        job.describe = [=](bool error) mutable {
+            print_read_header(&imageFormat, &sampler, error);
+        };
+        jobs.push_back(job);
     }
-
-    return ret;
 }
 
 int test_read_image_formats(cl_device_id device, cl_context context,
@@ -225,17 +232,16 @@ int test_read_image_formats(cl_device_id device, cl_context context,
                                              : "integer",
                      get_explicit_type_name(outputType));
 
+            std::vector<ImageTestJob> jobs;
             for (unsigned int i = 0; i < formatList.size(); i++)
             {
                 if (filterFlags[i]) continue;
 
-                const cl_image_format &imageFormat = formatList[i];
-
-                ret |=
-                    test_read_image_type(device, context, queue, &imageFormat,
-                                         flipFlop[floatCoordIdx], imageSampler,
-                                         outputType, imageType);
+                add_read_image_jobs(jobs, device, context, &formatList[i],
+                                    flipFlop[floatCoordIdx], imageSampler,
+                                    outputType, imageType);
             }
+            ret |= run_image_test_jobs(device, context, queue, jobs);
         }
     }
     return ret;
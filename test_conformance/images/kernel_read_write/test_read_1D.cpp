@@ -15,6 +15,7 @@
 //
 
 #include "test_common.h"
+#include "../common.h"
 #include <float.h>
 
 #include <algorithm>
@@ -69,7 +70,7 @@ int test_read_image_set_1D(cl_device_id device, cl_context context,
     const char *readFormat;
     clProgramWrapper program;
     clKernelWrapper kernel;
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     int error;
 
     // Get our operating params
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "test_common.h"
+#include "../common.h"
 #include <float.h>
 
 #include <algorithm>
@@ -76,7 +77,7 @@ int test_read_image_set_1D_array(cl_device_id device, cl_context context,
     const char *readFormat;
     clProgramWrapper program;
     clKernelWrapper kernel;
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     int error;
     const char *KernelSourcePattern = NULL;
 
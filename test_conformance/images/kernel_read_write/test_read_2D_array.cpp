@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "test_common.h"
+#include "../common.h"
 #include <float.h>
 
 #include <algorithm>
@@ -94,7 +95,7 @@ int test_read_image_set_2D_array(cl_device_id device, cl_context context,
     char programSrc[10240];
     const char *ptr;
     const char *readFormat;
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
 
     const char *KernelSourcePattern = NULL;
 
@@ -15,6 +15,7 @@
 //
 #include "../testBase.h"
 #include "test_common.h"
+#include "../common.h"
 
 #if !defined(_WIN32)
 #include <sys/mman.h>
@@ -898,7 +899,7 @@ int test_write_image_formats(cl_device_id device, cl_context context,
     log_info( "write_image (%s input) *****************************\n", get_explicit_type_name( inputType ) );
 
 
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
 
     for (unsigned int i = 0; i < formatList.size(); i++)
     {
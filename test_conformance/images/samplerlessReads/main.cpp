@@ -20,6 +20,7 @@
 #include "../harness/compat.h"
 #include "../harness/fpcontrol.h"
 #include "../harness/parseParameters.h"
+#include "../harness/rounding_mode.h"
 
 #if defined(__PPC__)
 // Global varaiable used to hold the FPU control register state. The FPSCR register can not
@@ -101,6 +102,8 @@ int main(int argc, const char *argv[])
             gTestMaxImages = true;
         else if ( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if ( strcmp( argv[i], "parallel_matrix" ) == 0 )
+            gParallelImageMatrix = true;
 
         else if ( strcmp( argv[i], "int" ) == 0 )
             gTypesToTest |= kTestInt;
@@ -141,8 +144,8 @@ int main(int argc, const char *argv[])
     // where reference is being computed to make sure we get non-flushed reference result. If implementation
     // returns flushed result, we correctly take care of that in verification code.
 
-    FPU_mode_type oldMode;
-    DisableFTZ(&oldMode);
+    FPUStateGuard fpState;
+    fpState.SetFTZ(false);
 
     int ret = runTestHarnessWithCheck(
         argCount, argList, test_registry::getInstance().num_tests(),
@@ -150,7 +153,7 @@ int main(int argc, const char *argv[])
         verifyImageSupport);
 
     // Restore FP state before leaving
-    RestoreFPState(&oldMode);
+    fpState.Restore();
 
     free(argList);
     return ret;
@@ -179,6 +182,7 @@ static void printUsage( const char *execName )
     log_info( "\n" );
     log_info( "\tdebug_trace - Enables additional debug info logging\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info( "\tparallel_matrix - Runs independent format and sampler combinations concurrently, one queue per worker thread (see CL_TEST_NUM_THREADS)\n" );
     log_info( "\n" );
     log_info( "Test names:\n" );
     for (size_t i = 0; i < test_registry::getInstance().num_tests(); i++)
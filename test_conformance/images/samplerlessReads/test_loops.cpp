@@ -57,11 +57,6 @@ int test_read_image_type(cl_device_id device, cl_context context,
                          ExplicitType outputType, cl_mem_object_type imageType)
 {
     int ret = 0;
-    imageSampler->addressing_mode = CL_ADDRESS_NONE;
-
-    print_read_header( format, imageSampler, false );
-
-    gTestCount++;
 
     switch (imageType)
     {
@@ -85,13 +80,6 @@ int test_read_image_type(cl_device_id device, cl_context context,
             break;
     }
 
-    if ( ret != 0 )
-    {
-        gFailCount++;
-        log_error( "FAILED: " );
-        print_read_header( format, imageSampler, true );
-        log_info( "\n" );
-    }
     return ret;
 }
 
@@ -108,15 +96,27 @@ int test_read_image_formats(cl_device_id device, cl_context context,
     log_info( "read_image (%s coords, %s results) *****************************\n",
               "integer", get_explicit_type_name( outputType ) );
 
+    std::vector<ImageTestJob> jobs;
     for (unsigned int i = 0; i < formatList.size(); i++)
     {
         if ( filterFlags[i] )
             continue;
 
-        const cl_image_format &imageFormat = formatList[i];
-
-        ret |= test_read_image_type( device, context, queue, &imageFormat, imageSampler, outputType, imageType );
+        cl_image_format imageFormat = formatList[i];
+        image_sampler_data sampler = *imageSampler;
+        sampler.addressing_mode = CL_ADDRESS_NONE;
+
+        ImageTestJob job;
+        job.run = [=](cl_command_queue queue) mutable {
+            return test_read_image_type(device, context, queue, &imageFormat,
+                                        &sampler, outputType, imageType);
+        };
+        job.describe = [=](bool error) mutable {
+            print_read_header(&imageFormat, &sampler, error);
+        };
+        jobs.push_back(job);
     }
+    ret |= run_image_test_jobs(device, context, queue, jobs);
     return ret;
 }
 
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 #include <float.h>
 
 #if defined( __APPLE__ )
@@ -173,7 +174,7 @@ int test_read_image_set_1D_buffer(cl_device_id device, cl_context context,
     const char *dataType;
     clProgramWrapper program;
     clKernelWrapper kernel;
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
     int error;
 
     // Get our operating params
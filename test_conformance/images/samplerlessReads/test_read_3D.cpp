@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 #include <float.h>
 
 extern bool gTestReadWrite;
@@ -176,7 +177,7 @@ int test_read_image_set_3D(cl_device_id device, cl_context context,
     const char *ptr;
     const char *readFormat;
     const char *dataType;
-    RandomSeed seed( gRandomSeed );
+    RandomSeed seed( image_test_job_seed() );
 
     int error;
 
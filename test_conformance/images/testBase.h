@@ -27,6 +27,7 @@ extern bool gTestSmallImages;
 extern bool gEnablePitch;
 extern bool gTestMaxImages;
 extern bool gTestMipmaps;
+extern bool gParallelImageMatrix;
 
 // Amount to offset pixels for checking normalized reads
 #define NORM_OFFSET 0.1f
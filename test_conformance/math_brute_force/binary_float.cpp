@@ -214,7 +214,6 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_float *s = 0;
     cl_float *s2 = 0;
     cl_int copysign_test = 0;
-    RoundingMode oldRoundMode;
     int skipVerification = 0;
 
     if (relaxedMode)
@@ -380,16 +379,15 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         return CL_SUCCESS;
     }
 
-    FPU_mode_type oldMode;
-    oldRoundMode = kRoundToNearestEven;
+    // Also restores the host state on the early error returns below
+    FPUStateGuard fpState;
     if (isFDim)
     {
         // Calculate the correctly rounded reference result
-        memset(&oldMode, 0, sizeof(oldMode));
-        if (ftz || relaxedMode) ForceFTZ(&oldMode);
+        if (ftz || relaxedMode) fpState.SetFTZ(true);
 
         // Set the rounding mode to match the device
-        if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
+        if (gIsInRTZMode) fpState.SetRound(kRoundTowardZero, kfloat);
     }
 
     if (!strcmp(name, "copysign")) copysign_test = 1;
@@ -416,7 +414,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             r[j] = (float)ref_func(s[j], s2[j]);
     }
 
-    if (isFDim && ftz) RestoreFPState(&oldMode);
+    // The device rounding mode stays on for the verification below
+    if (isFDim && ftz) fpState.SetFTZ(false);
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
@@ -694,7 +693,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    if (isFDim && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    fpState.Restore();
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
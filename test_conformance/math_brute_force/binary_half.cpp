@@ -113,7 +113,6 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     std::vector<float> s(0), s2(0);
     cl_uint j = 0;
 
-    RoundingMode oldRoundMode;
     cl_int copysign_test = 0;
 
     // start the map of the output arrays
@@ -256,18 +255,17 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     cl_half_rounding_mode halfRoundingMode = CL_HALF_RTE;
-    FPU_mode_type oldMode;
-    oldRoundMode = kRoundToNearestEven;
+    // Also restores the host state on the early error returns below
+    FPUStateGuard fpState;
     if (isFDim)
     {
         // Calculate the correctly rounded reference result
-        memset(&oldMode, 0, sizeof(oldMode));
-        if (ftz) ForceFTZ(&oldMode);
+        if (ftz) fpState.SetFTZ(true);
 
         // Set the rounding mode to match the device
         if (gIsInRTZMode)
         {
-            oldRoundMode = set_round(kRoundTowardZero, kfloat);
+            fpState.SetRound(kRoundTowardZero, kfloat);
             halfRoundingMode = CL_HALF_RTZ;
         }
     }
@@ -292,7 +290,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
             r[j] = cl_half_from_float(ref_func(s[j], s2[j]), halfRoundingMode);
     }
 
-    if (isFDim && ftz) RestoreFPState(&oldMode);
+    // The device rounding mode stays on for the verification below
+    if (isFDim && ftz) fpState.SetFTZ(false);
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
     for (j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
@@ -582,7 +581,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    if (isFDim && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    fpState.Restore();
 
     for (j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
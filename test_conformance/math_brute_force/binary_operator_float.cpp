@@ -206,7 +206,6 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_float *r = 0;
     cl_float *s = 0;
     cl_float *s2 = 0;
-    RoundingMode oldRoundMode;
 
     if (relaxedMode)
     {
@@ -377,13 +376,11 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     // Calculate the correctly rounded reference result
-    FPU_mode_type oldMode;
-    memset(&oldMode, 0, sizeof(oldMode));
-    if (ftz || relaxedMode) ForceFTZ(&oldMode);
+    FPUStateGuard fpState;
+    if (ftz || relaxedMode) fpState.SetFTZ(true);
 
     // Set the rounding mode to match the device
-    oldRoundMode = kRoundToNearestEven;
-    if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
+    if (gIsInRTZMode) fpState.SetRound(kRoundTowardZero, kfloat);
 
     // Calculate the correctly rounded reference result
     r = (float *)gOut_Ref + thread_id * buffer_elements;
@@ -405,9 +402,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    if (gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
-
-    if (ftz || relaxedMode) RestoreFPState(&oldMode);
+    fpState.Restore();
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
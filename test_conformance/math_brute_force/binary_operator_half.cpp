@@ -118,7 +118,6 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     const char *name = job->f->name;
     cl_half *r = 0;
     std::vector<float> s(0), s2(0);
-    RoundingMode oldRoundMode;
 
     cl_event e[VECTOR_SIZE_COUNT];
     cl_half *out[VECTOR_SIZE_COUNT];
@@ -259,13 +258,12 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     // Calculate the correctly rounded reference result
-    FPU_mode_type oldMode;
-    memset(&oldMode, 0, sizeof(oldMode));
-    if (ftz) ForceFTZ(&oldMode);
+    // Also restores the host state on the early error returns below
+    FPUStateGuard fpState;
+    if (ftz) fpState.SetFTZ(true);
 
     // Set the rounding mode to match the device
-    oldRoundMode = kRoundToNearestEven;
-    if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
+    if (gIsInRTZMode) fpState.SetRound(kRoundTowardZero, kfloat);
 
     // Calculate the correctly rounded reference result
     r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
@@ -279,7 +277,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         r[j] = HFF(func.f_ff(s[j], s2[j]));
     }
 
-    if (ftz) RestoreFPState(&oldMode);
+    // The device rounding mode stays on for the verification below
+    if (ftz) fpState.SetFTZ(false);
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
@@ -488,7 +487,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    if (gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    fpState.Restore();
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
@@ -47,9 +47,21 @@ test_status InitCL(cl_device_id device) {
   return TEST_PASS;
 }
 
+bool gPipeBenchmark = false;
+
 int main(int argc, const char *argv[])
 {
+    // Larger and repeated pipe throughput runs. The flag may appear anywhere
+    // on the command line and is removed before the harness parses it.
+    int argCount = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-benchmark") == 0)
+            gPipeBenchmark = true;
+        else
+            argv[argCount++] = argv[i];
+    }
     return runTestHarnessWithCheck(
-        argc, argv, test_registry::getInstance().num_tests(),
+        argCount, argv, test_registry::getInstance().num_tests(),
         test_registry::getInstance().definitions(), false, 0, InitCL);
 }
@@ -0,0 +1,328 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "harness/testHarness.h"
+#include "harness/errorHelpers.h"
+#include "harness/typeWrappers.h"
+#include "harness/verifyHelpers.h"
+
+// Pipe throughput: a writer kernel fills a pipe with uniquely numbered
+// packets and a reader kernel drains it, for several packet sizes, numbers
+// of packets reserved per work-item and reservation scopes. Each packet is a
+// uintN whose components all hold the packet's number, so the packets read
+// back are checked in linear time against a bitmap of the numbers written.
+
+extern bool gPipeBenchmark;
+
+enum PipeReserveScope
+{
+    PIPE_RESERVE_WORK_ITEM,
+    PIPE_RESERVE_WORK_GROUP,
+    PIPE_RESERVE_SUB_GROUP
+};
+
+static const char *pipe_reserve_scope_name(PipeReserveScope scope)
+{
+    switch (scope)
+    {
+        case PIPE_RESERVE_WORK_ITEM: return "work_item";
+        case PIPE_RESERVE_WORK_GROUP: return "work_group";
+        case PIPE_RESERVE_SUB_GROUP: return "sub_group";
+    }
+    return "unknown";
+}
+
+// Writes and reads per_item packets for each work-item of one reservation
+static void create_throughput_kernel_source(std::stringstream &stream,
+                                            const char *type,
+                                            PipeReserveScope scope)
+{
+    const char *prefix = "";
+    const char *count = "per_item";
+    const char *base = "0";
+    switch (scope)
+    {
+        case PIPE_RESERVE_WORK_ITEM: break;
+        case PIPE_RESERVE_WORK_GROUP:
+            prefix = "work_group_";
+            count = "get_local_size(0) * per_item";
+            base = "get_local_id(0) * per_item";
+            break;
+        case PIPE_RESERVE_SUB_GROUP:
+            prefix = "sub_group_";
+            count = "get_sub_group_size() * per_item";
+            base = "get_sub_group_local_id() * per_item";
+            stream << "#pragma OPENCL EXTENSION cl_khr_subgroups : enable\n";
+            break;
+    }
+
+    // clang-format off
+    stream << R"(
+        __kernel void test_pipe_throughput_write(__write_only pipe )" << type << R"( out_pipe, uint per_item)
+        {
+            uint gid = get_global_id(0);
+            reserve_id_t res_id = )" << prefix << "reserve_write_pipe(out_pipe, " << count << R"();
+            if(is_valid_reserve_id(res_id))
+            {
+                uint base = )" << base << R"(;
+                for(uint k = 0; k < per_item; k++)
+                {
+                    )" << type << " packet = (" << type << R"()(gid * per_item + k);
+                    write_pipe(out_pipe, res_id, base + k, &packet);
+                }
+                )" << prefix << R"(commit_write_pipe(out_pipe, res_id);
+            }
+        }
+
+        __kernel void test_pipe_throughput_read(__read_only pipe )" << type << " in_pipe, __global " << type << R"( *dst, uint per_item)
+        {
+            uint gid = get_global_id(0);
+            reserve_id_t res_id = )" << prefix << "reserve_read_pipe(in_pipe, " << count << R"();
+            if(is_valid_reserve_id(res_id))
+            {
+                uint base = )" << base << R"(;
+                for(uint k = 0; k < per_item; k++)
+                    read_pipe(in_pipe, res_id, base + k, &dst[gid * per_item + k]);
+                )" << prefix << R"(commit_read_pipe(in_pipe, res_id);
+            }
+        }
+        )";
+    // clang-format on
+}
+
+// Every packet read must have equal components, and the packet numbers must
+// be a permutation of [0, packets). Unread slots keep the fill pattern, which
+// lies outside that range.
+static bool verify_throughput_packets(const cl_uint *out, size_t packets,
+                                      size_t width)
+{
+    PermutationVerifier<cl_uint> verifier(0, packets);
+    for (size_t i = 0; i < packets; i++)
+    {
+        const cl_uint *packet = out + i * width;
+        for (size_t c = 1; c < width; c++)
+        {
+            if (packet[c] != packet[0])
+            {
+                log_error("ERROR: Packet %zu component %zu holds %u, expected "
+                          "%u\n",
+                          i, c, packet[c], packet[0]);
+                return false;
+            }
+        }
+        if (!verifier.add(packet[0])) return false;
+    }
+    return verifier.complete();
+}
+
+static cl_ulong profiling_time(cl_event event, cl_profiling_info param)
+{
+    cl_ulong value = 0;
+    cl_int error =
+        clGetEventProfilingInfo(event, param, sizeof(value), &value, NULL);
+    if (error != CL_SUCCESS)
+    {
+        print_error(error, "clGetEventProfilingInfo failed");
+        return 0;
+    }
+    return value;
+}
+
+struct PipeThroughputResult
+{
+    double packets_per_second;
+    double latency_us; // from the end of the writer to the start of the reader
+};
+
+static int run_pipe_throughput(cl_context context, cl_command_queue queue,
+                               cl_kernel writer, cl_kernel reader,
+                               PipeReserveScope scope, size_t packet_size,
+                               size_t width, cl_uint per_item, size_t items,
+                               PipeThroughputResult *result)
+{
+    cl_int err;
+    size_t packets = items * per_item;
+    size_t local_size = 0;
+    const size_t *local = NULL;
+    if (scope != PIPE_RESERVE_WORK_ITEM)
+    {
+        // Whole work-groups, so that every reservation is the same size
+        err = get_max_common_work_group_size(context, writer, items,
+                                             &local_size);
+        test_error(err, "Unable to get work group size to use");
+        size_t reader_local = 0;
+        err = get_max_common_work_group_size(context, reader, items,
+                                             &reader_local);
+        test_error(err, "Unable to get work group size to use");
+        local_size = std::min(local_size, reader_local);
+        while (items % local_size) local_size--;
+        local = &local_size;
+    }
+
+    clMemWrapper pipe = clCreatePipe(context, CL_MEM_HOST_NO_ACCESS,
+                                     (cl_uint)packet_size, (cl_uint)packets,
+                                     NULL, &err);
+    test_error(err, "clCreatePipe failed");
+    clMemWrapper dst = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                      packet_size * packets, NULL, &err);
+    test_error(err, "clCreateBuffer failed");
+
+    const cl_uint pattern = CL_UINT_MAX;
+    err = clEnqueueFillBuffer(queue, dst, &pattern, sizeof(pattern), 0,
+                              packet_size * packets, 0, NULL, NULL);
+    test_error(err, "clEnqueueFillBuffer failed");
+
+    err = clSetKernelArg(writer, 0, sizeof(cl_mem), &pipe);
+    err |= clSetKernelArg(writer, 1, sizeof(cl_uint), &per_item);
+    err |= clSetKernelArg(reader, 0, sizeof(cl_mem), &pipe);
+    err |= clSetKernelArg(reader, 1, sizeof(cl_mem), &dst);
+    err |= clSetKernelArg(reader, 2, sizeof(cl_uint), &per_item);
+    test_error(err, "clSetKernelArg failed");
+
+    clEventWrapper write_event;
+    clEventWrapper read_event;
+    err = clEnqueueNDRangeKernel(queue, writer, 1, NULL, &items, local, 0,
+                                 NULL, &write_event);
+    test_error(err, "clEnqueueNDRangeKernel failed");
+    err = clEnqueueNDRangeKernel(queue, reader, 1, NULL, &items, local, 1,
+                                 &write_event, &read_event);
+    test_error(err, "clEnqueueNDRangeKernel failed");
+
+    std::vector<cl_uint> out(packets * width);
+    err = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0, packet_size * packets,
+                              out.data(), 1, &read_event, NULL);
+    test_error(err, "clEnqueueReadBuffer failed");
+
+    if (!verify_throughput_packets(out.data(), packets, width))
+        return TEST_FAIL;
+
+    cl_ulong write_start =
+        profiling_time(write_event, CL_PROFILING_COMMAND_START);
+    cl_ulong write_end = profiling_time(write_event, CL_PROFILING_COMMAND_END);
+    cl_ulong read_start =
+        profiling_time(read_event, CL_PROFILING_COMMAND_START);
+    cl_ulong read_end = profiling_time(read_event, CL_PROFILING_COMMAND_END);
+    double seconds = (read_end - write_start) * 1e-9;
+    result->packets_per_second = seconds > 0 ? packets / seconds : 0.0;
+    result->latency_us =
+        read_start > write_end ? (read_start - write_end) * 1e-3 : 0.0;
+    return TEST_PASS;
+}
+
+REGISTER_TEST(pipe_readwrite_throughput)
+{
+    static const cl_uint widths[] = { 1, 2, 4, 8, 16 };
+    static const cl_uint per_item_counts[] = { 1, 4, 16 };
+    // The benchmark mode runs more packets and keeps the best of a few runs
+    const int repetitions = gPipeBenchmark ? 5 : 1;
+    const size_t scale = gPipeBenchmark ? 16 : 1;
+
+    cl_int err;
+    cl_uint max_packet_size = 0;
+    err = clGetDeviceInfo(device, CL_DEVICE_PIPE_MAX_PACKET_SIZE,
+                          sizeof(max_packet_size), &max_packet_size, NULL);
+    test_error(err, "Unable to get pipe max packet size");
+
+    // Timings come from event profiling, so use a queue of our own
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper profiling_queue =
+        clCreateCommandQueueWithProperties(context, device, props, &err);
+    test_error(err, "clCreateCommandQueueWithProperties failed");
+
+    std::vector<PipeReserveScope> scopes = { PIPE_RESERVE_WORK_ITEM,
+                                             PIPE_RESERVE_WORK_GROUP };
+    if (is_extension_available(device, "cl_khr_subgroups"))
+        scopes.push_back(PIPE_RESERVE_SUB_GROUP);
+
+    int total_errors = 0;
+    log_info("%-10s %-10s %8s %10s %14s %12s\n", "type", "reserve", "per item",
+             "packets", "Mpackets/s", "latency us");
+    for (cl_uint width : widths)
+    {
+        size_t packet_size = width * sizeof(cl_uint);
+        if (packet_size > max_packet_size) continue;
+        char type[16];
+        if (width == 1)
+            sprintf(type, "uint");
+        else
+            sprintf(type, "uint%u", width);
+
+        for (PipeReserveScope scope : scopes)
+        {
+            std::stringstream source;
+            create_throughput_kernel_source(source, type, scope);
+            std::string kernel_source = source.str();
+            const char *sources[] = { kernel_source.c_str() };
+
+            clProgramWrapper program;
+            clKernelWrapper writer;
+            err = create_single_kernel_helper(context, &program, &writer, 1,
+                                              sources,
+                                              "test_pipe_throughput_write");
+            test_error_ret(err, " Error creating program", -1);
+            clKernelWrapper reader =
+                clCreateKernel(program, "test_pipe_throughput_read", &err);
+            test_error_ret(err, " Error creating kernel", -1);
+
+            for (cl_uint per_item : per_item_counts)
+            {
+                size_t items =
+                    std::max<size_t>(1, num_elements * scale / per_item);
+                PipeThroughputResult best = { 0.0, 0.0 };
+                bool passed = true;
+                for (int r = 0; r < repetitions && passed; r++)
+                {
+                    PipeThroughputResult result;
+                    err = run_pipe_throughput(
+                        context, profiling_queue, writer, reader, scope,
+                        packet_size, width, per_item, items, &result);
+                    if (err != TEST_PASS)
+                    {
+                        passed = false;
+                        break;
+                    }
+                    if (r == 0
+                        || result.packets_per_second > best.packets_per_second)
+                        best = result;
+                }
+
+                if (!passed)
+                {
+                    log_error("%s %s reservations of %u packets per work-item "
+                              "failed\n",
+                              type, pipe_reserve_scope_name(scope), per_item);
+                    total_errors++;
+                    continue;
+                }
+                log_info("%-10s %-10s %8u %10zu %14.2f %12.1f\n", type,
+                         pipe_reserve_scope_name(scope), per_item,
+                         items * per_item, best.packets_per_second * 1e-6,
+                         best.latency_us);
+            }
+        }
+    }
+
+    return total_errors;
+}
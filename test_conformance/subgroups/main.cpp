@@ -22,6 +22,7 @@
 
 MTdata gMTdata;
 cl_half_rounding_mode g_rounding_mode;
+bool gWorkGroupSweep = false;
 
 static test_status InitCL(cl_device_id device)
 {
@@ -67,7 +68,18 @@ static test_status InitCL(cl_device_id device)
 int main(int argc, const char *argv[])
 {
     gMTdata = init_genrand(0);
+    // Sweep every local size and several global sizes, with timings. The
+    // flag may appear anywhere on the command line and is removed before the
+    // harness parses it.
+    int argCount = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-sweep") == 0)
+            gWorkGroupSweep = true;
+        else
+            argv[argCount++] = argv[i];
+    }
     return runTestHarnessWithCheck(
-        argc, argv, test_registry::getInstance().num_tests(),
+        argCount, argv, test_registry::getInstance().num_tests(),
         test_registry::getInstance().definitions(), false, 0, InitCL);
 }
@@ -19,6 +19,7 @@
 #include "typeWrappers.h"
 #include "CL/cl_half.h"
 #include "subhelpers.h"
+#include "harness/scanReduceReference.h"
 #include <set>
 #include <algorithm>
 
@@ -346,6 +347,34 @@ inline subgroups::cl_half calculate(subgroups::cl_half a, subgroups::cl_half b,
     return to_half(0);
 }
 
+// Binds an ArithmeticOp at compile time for the scan and reduce references
+template <ArithmeticOp operation> struct ArithmeticReference
+{
+    template <typename Ty> static Ty combine(Ty a, Ty b)
+    {
+        return calculate<Ty>(a, b, operation);
+    }
+};
+
+// Gathers the inputs of the work items of a sub group of n items that are
+// set in work_items_mask, and their local ids.
+template <typename Ty>
+void gather_active_work_items(const Ty *mx, int n, const bs128 &work_items_mask,
+                              std::vector<Ty> &active_inputs,
+                              std::vector<int> &active_ids)
+{
+    active_inputs.clear();
+    active_ids.clear();
+    for (int i = 0; i < n; ++i)
+    {
+        if (work_items_mask.test(i))
+        {
+            active_inputs.push_back(mx[i]);
+            active_ids.push_back(i);
+        }
+    }
+}
+
 template <typename Ty> bool is_floating_point()
 {
     return std::is_floating_point<Ty>::value
@@ -583,13 +612,15 @@ template <typename Ty, ArithmeticOp operation> struct SCEX_NU
     static test_status chk(Ty *x, Ty *y, Ty *mx, Ty *my, cl_int *m,
                            const WorkGroupParams &test_params)
     {
-        int ii, i, j, k, n;
+        int ii, j, k, n;
         int nw = test_params.local_workgroup_size;
         int ns = test_params.subgroup_size;
         int ng = test_params.global_workgroup_size;
         bs128 work_items_mask = test_params.work_items_mask;
         int nj = (nw + ns - 1) / ns;
         Ty tr, rr;
+        std::vector<Ty> active_inputs, expected(ns);
+        std::vector<int> active_ids;
         ng = ng / nw;
 
         std::string func_name = (test_params.all_work_item_masks.size() > 0
@@ -613,37 +644,24 @@ template <typename Ty, ArithmeticOp operation> struct SCEX_NU
             {
                 ii = j * ns;
                 n = ii + ns > nw ? nw - ii : ns;
-                std::set<int> active_work_items;
-                for (i = 0; i < n; ++i)
-                {
-                    if (work_items_mask.test(i))
-                    {
-                        active_work_items.insert(i);
-                    }
-                }
-                if (active_work_items.empty())
-                {
-                    continue;
-                }
-                else
+                gather_active_work_items(mx + ii, n, work_items_mask,
+                                         active_inputs, active_ids);
+                reference_scan_exclusive<ArithmeticReference<operation>>(
+                    active_inputs.data(), expected.data(), active_ids.size(),
+                    TypeManager<Ty>::identify_limits(operation));
+                for (size_t a = 0; a < active_ids.size(); ++a)
                 {
-                    tr = TypeManager<Ty>::identify_limits(operation);
-                    for (const int &active_work_item : active_work_items)
+                    tr = expected[a];
+                    rr = my[ii + active_ids[a]];
+                    if (!compare_ordered(rr, tr))
                     {
-                        rr = my[ii + active_work_item];
-                        if (!compare_ordered(rr, tr))
-                        {
-                            log_error(
-                                "ERROR: %s_%s(%s) "
-                                "mismatch for local id %d in sub group %d in "
-                                "group %d %s\n",
-                                func_name.c_str(), operation_names(operation),
-                                TypeManager<Ty>::name(), i, j, k,
-                                print_expected_obtained(tr, rr).c_str());
-                            return TEST_FAIL;
-                        }
-                        tr = calculate<Ty>(tr, mx[ii + active_work_item],
-                                           operation);
+                        log_error("ERROR: %s_%s(%s) "
+                                  "mismatch for local id %d in sub group %d in "
+                                  "group %d %s\n",
+                                  func_name.c_str(), operation_names(operation),
+                                  TypeManager<Ty>::name(), active_ids[a], j, k,
+                                  print_expected_obtained(tr, rr).c_str());
+                        return TEST_FAIL;
                     }
                 }
             }
@@ -682,7 +700,7 @@ template <typename Ty, ArithmeticOp operation> struct SCIN_NU
     static test_status chk(Ty *x, Ty *y, Ty *mx, Ty *my, cl_int *m,
                            const WorkGroupParams &test_params)
     {
-        int ii, i, j, k, n;
+        int ii, j, k, n;
         int nw = test_params.local_workgroup_size;
         int ns = test_params.subgroup_size;
         int ng = test_params.global_workgroup_size;
@@ -690,6 +708,8 @@ template <typename Ty, ArithmeticOp operation> struct SCIN_NU
 
         int nj = (nw + ns - 1) / ns;
         Ty tr, rr;
+        std::vector<Ty> active_inputs, expected(ns);
+        std::vector<int> active_ids;
         ng = ng / nw;
 
         std::string func_name = (test_params.all_work_item_masks.size() > 0
@@ -715,51 +735,30 @@ template <typename Ty, ArithmeticOp operation> struct SCIN_NU
             {
                 ii = j * ns;
                 n = ii + ns > nw ? nw - ii : ns;
-                std::set<int> active_work_items;
-                int catch_frist_active = -1;
-
-                for (i = 0; i < n; ++i)
-                {
-                    if (work_items_mask.test(i))
-                    {
-                        if (catch_frist_active == -1)
-                        {
-                            catch_frist_active = i;
-                        }
-                        active_work_items.insert(i);
-                    }
-                }
-                if (active_work_items.empty())
-                {
-                    continue;
-                }
+                gather_active_work_items(mx + ii, n, work_items_mask,
+                                         active_inputs, active_ids);
+                // A single active work item gets its own value back
+                if (active_ids.size() == 1)
+                    expected[0] = active_inputs[0];
                 else
+                    reference_scan_inclusive<ArithmeticReference<operation>>(
+                        active_inputs.data(), expected.data(),
+                        active_ids.size(),
+                        TypeManager<Ty>::identify_limits(operation));
+                for (size_t a = 0; a < active_ids.size(); ++a)
                 {
-                    tr = TypeManager<Ty>::identify_limits(operation);
-                    for (const int &active_work_item : active_work_items)
+                    tr = expected[a];
+                    rr = my[ii + active_ids[a]];
+                    if (!compare_ordered<Ty>(rr, tr))
                     {
-                        rr = my[ii + active_work_item];
-                        if (active_work_items.size() == 1)
-                        {
-                            tr = mx[ii + catch_frist_active];
-                        }
-                        else
-                        {
-                            tr = calculate<Ty>(tr, mx[ii + active_work_item],
-                                               operation);
-                        }
-                        if (!compare_ordered<Ty>(rr, tr))
-                        {
-                            log_error(
-                                "ERROR: %s_%s(%s) "
-                                "mismatch for local id %d in sub group %d "
-                                "in "
-                                "group %d %s\n",
-                                func_name.c_str(), operation_names(operation),
-                                TypeManager<Ty>::name(), active_work_item, j, k,
-                                print_expected_obtained(tr, rr).c_str());
-                            return TEST_FAIL;
-                        }
+                        log_error("ERROR: %s_%s(%s) "
+                                  "mismatch for local id %d in sub group %d "
+                                  "in "
+                                  "group %d %s\n",
+                                  func_name.c_str(), operation_names(operation),
+                                  TypeManager<Ty>::name(), active_ids[a], j, k,
+                                  print_expected_obtained(tr, rr).c_str());
+                        return TEST_FAIL;
                     }
                 }
             }
@@ -798,7 +797,7 @@ template <typename Ty, ArithmeticOp operation> struct RED_NU
     static test_status chk(Ty *x, Ty *y, Ty *mx, Ty *my, cl_int *m,
                            const WorkGroupParams &test_params)
     {
-        int ii, i, j, k, n;
+        int ii, j, k, n;
         int nw = test_params.local_workgroup_size;
         int ns = test_params.subgroup_size;
         int ng = test_params.global_workgroup_size;
@@ -806,6 +805,8 @@ template <typename Ty, ArithmeticOp operation> struct RED_NU
         int nj = (nw + ns - 1) / ns;
         ng = ng / nw;
         Ty tr, rr;
+        std::vector<Ty> active_inputs;
+        std::vector<int> active_ids;
 
         std::string func_name = (test_params.all_work_item_masks.size() > 0
                                      ? "sub_group_non_uniform_reduce"
@@ -830,30 +831,16 @@ template <typename Ty, ArithmeticOp operation> struct RED_NU
             {
                 ii = j * ns;
                 n = ii + ns > nw ? nw - ii : ns;
-                std::set<int> active_work_items;
-                int catch_frist_active = -1;
-                for (i = 0; i < n; ++i)
-                {
-                    if (work_items_mask.test(i))
-                    {
-                        if (catch_frist_active == -1)
-                        {
-                            catch_frist_active = i;
-                            tr = mx[ii + i];
-                            active_work_items.insert(i);
-                            continue;
-                        }
-                        active_work_items.insert(i);
-                        tr = calculate<Ty>(tr, mx[ii + i], operation);
-                    }
-                }
-
-                if (active_work_items.empty())
+                gather_active_work_items(mx + ii, n, work_items_mask,
+                                         active_inputs, active_ids);
+                if (active_ids.empty())
                 {
                     continue;
                 }
+                tr = reference_reduce<ArithmeticReference<operation>>(
+                    active_inputs.data(), active_ids.size());
 
-                for (const int &active_work_item : active_work_items)
+                for (int active_work_item : active_ids)
                 {
                     rr = my[ii + active_work_item];
                     if (!compare_ordered<Ty>(rr, tr))
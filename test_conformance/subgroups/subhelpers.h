@@ -20,6 +20,7 @@
 #include "kernelHelpers.h"
 #include "typeWrappers.h"
 #include "imageHelpers.h"
+#include "workGroupSweep.h"
 
 #include <limits>
 #include <vector>
@@ -27,8 +28,10 @@
 #include <bitset>
 #include <regex>
 #include <map>
+#include <memory>
 
 extern MTdata gMTdata;
+extern bool gWorkGroupSweep;
 typedef std::bitset<128> bs128;
 extern cl_half_rounding_mode g_rounding_mode;
 
@@ -1302,6 +1305,8 @@ public:
     {
         has_status = false;
         run_failed = false;
+        time_dispatch = false;
+        best_dispatch_seconds = 0.0;
     }
     cl_context context;
     cl_command_queue queue;
@@ -1318,6 +1323,9 @@ public:
     size_t osize;
     size_t tsize;
     bool run_failed;
+    // When set each NDRange is timed on its own, and the fastest kept
+    bool time_dispatch;
+    double best_dispatch_seconds;
 
 private:
     bool has_status;
@@ -1372,9 +1380,21 @@ public:
         error = clEnqueueWriteBuffer(queue, xy, CL_FALSE, 0, msize, mdata, 0,
                                      NULL, NULL);
         test_error(error, "clEnqueueWriteBuffer failed");
-        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, &local,
-                                       0, NULL, NULL);
-        test_error(error, "clEnqueueNDRangeKernel failed");
+        if (time_dispatch)
+        {
+            double seconds;
+            error = time_work_group_dispatch(queue, kernel, { global, local },
+                                             &seconds);
+            if (error != CL_SUCCESS) return error;
+            if (best_dispatch_seconds == 0.0 || seconds < best_dispatch_seconds)
+                best_dispatch_seconds = seconds;
+        }
+        else
+        {
+            error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global,
+                                           &local, 0, NULL, NULL);
+            test_error(error, "clEnqueueNDRangeKernel failed");
+        }
 
         error = clEnqueueReadBuffer(queue, xy, CL_FALSE, 0, msize, mdata, 0,
                                     NULL, NULL);
@@ -1446,13 +1466,43 @@ public:
     }
 };
 
-// Driver for testing a single built in function
+// Extension pragmas, XY macro and Type typedef preceding the kernel source of
+// every test of type Ty
+template <typename Ty>
+std::string subgroup_kernel_prefix(const WorkGroupParams &test_params)
+{
+    std::stringstream kernel_sstr;
+    if (strstr(TypeManager<Ty>::name(), "double"))
+    {
+        kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp64: enable\n";
+    }
+    else if (strstr(TypeManager<Ty>::name(), "half"))
+    {
+        kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp16: enable\n";
+    }
+    if (test_params.use_core_subgroups)
+    {
+        kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_subgroups : enable\n";
+    }
+    kernel_sstr << "#define XY(M,I) M[I].x = get_sub_group_local_id(); "
+                   "M[I].y = get_sub_group_id();\n";
+    kernel_sstr << TypeManager<Ty>::add_typedef();
+    return kernel_sstr.str();
+}
+
+// Driver for testing a single built in function. When batch_program is given
+// the kernel is taken from it instead of being built from src. When
+// sweep_table is given the work-group size must be used as is, the fastest
+// dispatch is recorded in the table and the caller logs the test once for the
+// whole sweep.
 template <typename Ty, typename Fns, size_t TSIZE = 0> struct subgroup_test
 {
     static test_status run(cl_device_id device, cl_context context,
                            cl_command_queue queue, int num_elements,
                            const char *kname, const char *src,
-                           WorkGroupParams test_params)
+                           WorkGroupParams test_params,
+                           cl_program batch_program = nullptr,
+                           WorkGroupSweepTable *sweep_table = nullptr)
     {
         size_t tmp;
         cl_int error;
@@ -1468,9 +1518,8 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct subgroup_test
         mapin.resize(local);
         std::vector<Ty> mapout;
         mapout.resize(local);
-        std::stringstream kernel_sstr;
 
-        Fns::log_test(test_params, "");
+        if (!sweep_table) Fns::log_test(test_params, "");
 
         // Make sure a test of type Ty is supported by the device
         if (!TypeManager<Ty>::type_supported(device))
@@ -1479,33 +1528,25 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct subgroup_test
             return TEST_SKIPPED_ITSELF;
         }
 
-        if (strstr(TypeManager<Ty>::name(), "double"))
-        {
-            kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp64: enable\n";
-        }
-        else if (strstr(TypeManager<Ty>::name(), "half"))
-        {
-            kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp16: enable\n";
-        }
-
         error = clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform),
                                 (void *)&platform, NULL);
         test_error_fail(error, "clGetDeviceInfo failed for CL_DEVICE_PLATFORM");
-        if (test_params.use_core_subgroups)
+
+        if (batch_program != nullptr)
         {
-            kernel_sstr
-                << "#pragma OPENCL EXTENSION cl_khr_subgroups : enable\n";
+            kernel = clCreateKernel(batch_program, kname, &error);
+            test_error_fail(error, "Unable to create kernel from batch");
         }
-        kernel_sstr << "#define XY(M,I) M[I].x = get_sub_group_local_id(); "
-                       "M[I].y = get_sub_group_id();\n";
-        kernel_sstr << TypeManager<Ty>::add_typedef();
-        kernel_sstr << src;
-        const std::string &kernel_str = kernel_sstr.str();
-        const char *kernel_src = kernel_str.c_str();
+        else
+        {
+            const std::string kernel_str =
+                subgroup_kernel_prefix<Ty>(test_params) + src;
+            const char *kernel_src = kernel_str.c_str();
 
-        error = create_single_kernel_helper(context, &program, &kernel, 1,
-                                            &kernel_src, kname);
-        if (error != CL_SUCCESS) return TEST_FAIL;
+            error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                                &kernel_src, kname);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+        }
 
         // Determine some local dimensions to use for the test.
         error = get_max_common_work_group_size(
@@ -1516,6 +1557,8 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct subgroup_test
         // Ideally this will still be large enough to give us multiple
         if (local > test_params.local_workgroup_size)
             local = test_params.local_workgroup_size;
+        if (sweep_table && local != test_params.local_workgroup_size)
+            return TEST_SKIPPED_ITSELF;
 
 
         // Get the sub group info
@@ -1601,6 +1644,7 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct subgroup_test
             input_array_size * sizeof(Ty), mapin.data(), mapout.data(),
             sgmap.data(), global * sizeof(cl_int4), odata.data(),
             output_array_size * sizeof(Ty), TSIZE * sizeof(Ty));
+        executor.time_dispatch = sweep_table != nullptr;
 
         // Run the kernel once on zeroes to get the map
         memset(idata.data(), 0, input_array_size * sizeof(Ty));
@@ -1631,6 +1675,11 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct subgroup_test
         {
             status = executor.run_and_check(test_params);
         }
+        if (sweep_table)
+        {
+            sweep_table->add(std::string(kname) + " " + TypeManager<Ty>::name(),
+                             { global, local }, executor.best_dispatch_seconds);
+        }
         // Detailed failure and skip messages should be logged by
         // run_and_check.
         if (status == TEST_PASS)
@@ -1672,25 +1721,56 @@ static void set_randomdata_for_subgroup(Ty *workgroup, int wg_offset,
     }
 }
 
+// One function of a RunTestForType::run_batch list; Fns tests the kernel
+// of function_name.
+template <typename Fns> struct BatchEntry
+{
+    const char *function_name;
+};
+
+template <typename Fns> BatchEntry<Fns> batch_entry(const char *function_name)
+{
+    return BatchEntry<Fns>{ function_name };
+}
+
 struct RunTestForType
 {
     RunTestForType(cl_device_id device, cl_context context,
                    cl_command_queue queue, int num_elements,
                    WorkGroupParams test_params)
         : device_(device), context_(context), queue_(queue),
-          num_elements_(num_elements), test_params_(test_params)
+          num_elements_(num_elements), test_params_(test_params),
+          batch_programs_(std::make_shared<BatchPrograms>())
     {}
+    // Builds the kernels of all entries for type T as one program, then runs
+    // them in order with their kernels created from it. If the combined
+    // build fails each function falls back to building its own program.
+    template <typename T, typename... Fns>
+    int run_batch(BatchEntry<Fns>... entries)
+    {
+        build_batch<T>({ entries.function_name... });
+        int error = TEST_PASS;
+        // Braced initializers are evaluated in order
+        int results[] = {
+            (error |= run_impl<T, Fns>(entries.function_name))...
+        };
+        (void)results;
+        return error;
+    }
     template <typename T, typename U>
     int run_impl(const std::string &function_name)
     {
         int error = TEST_PASS;
-        std::string source =
-            std::regex_replace(test_params_.get_kernel_source(function_name),
-                               std::regex("\\%s"), function_name);
+        std::string source = kernel_source(function_name);
         std::string kernel_name = "test_" + function_name;
-        error = subgroup_test<T, U>::run(device_, context_, queue_,
-                                         num_elements_, kernel_name.c_str(),
-                                         source.c_str(), test_params_);
+        cl_program batch_program = nullptr;
+        auto batch = batch_programs_->find(batch_key<T>(function_name));
+        if (batch != batch_programs_->end()) batch_program = batch->second;
+        if (gWorkGroupSweep && TypeManager<T>::type_supported(device_))
+            return run_sweep<T, U>(kernel_name, source, batch_program);
+        error = subgroup_test<T, U>::run(
+            device_, context_, queue_, num_elements_, kernel_name.c_str(),
+            source.c_str(), test_params_, batch_program);
 
         // If we return TEST_SKIPPED_ITSELF here, then an entire suite may be
         // reported as having been skipped even if some tests within it
@@ -1699,11 +1779,114 @@ struct RunTestForType
     }
 
 private:
+    // Records one program holding the kernels of all function_names for
+    // type T, for run_impl to create its kernels from.
+    template <typename T>
+    void build_batch(const std::vector<std::string> &function_names)
+    {
+        if (function_names.size() < 2
+            || !TypeManager<T>::type_supported(device_))
+            return;
+
+        std::string source = subgroup_kernel_prefix<T>(test_params_);
+        for (const std::string &function_name : function_names)
+            source += kernel_source(function_name);
+        const char *batch_src = source.c_str();
+        std::string first_kernel = "test_" + function_names.front();
+
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        int error = create_single_kernel_helper(context_, &program, &kernel, 1,
+                                                &batch_src,
+                                                first_kernel.c_str());
+        if (error != CL_SUCCESS)
+        {
+            log_info("Batched build for %s failed, building each function "
+                     "separately\n",
+                     TypeManager<T>::name());
+            return;
+        }
+        for (const std::string &function_name : function_names)
+            (*batch_programs_)[batch_key<T>(function_name)] = program;
+    }
+    // Runs the function over every local size up to the device maximum, each
+    // with a few multiples of it as the global size. The checks assume full
+    // work-groups, so no non-uniform sizes are swept. Functions outside a
+    // batch are built once here and every configuration reuses the program.
+    template <typename T, typename U>
+    int run_sweep(const std::string &kernel_name, const std::string &source,
+                  cl_program batch_program)
+    {
+        U::log_test(test_params_, "");
+
+        clProgramWrapper program;
+        if (batch_program == nullptr)
+        {
+            const std::string kernel_str =
+                subgroup_kernel_prefix<T>(test_params_) + source;
+            const char *kernel_src = kernel_str.c_str();
+            clKernelWrapper kernel;
+            if (create_single_kernel_helper(context_, &program, &kernel, 1,
+                                            &kernel_src, kernel_name.c_str())
+                != CL_SUCCESS)
+                return TEST_FAIL;
+            batch_program = program;
+        }
+
+        size_t max_local;
+        cl_int error =
+            clGetDeviceInfo(device_, CL_DEVICE_MAX_WORK_GROUP_SIZE,
+                            sizeof(max_local), &max_local, NULL);
+        test_error_fail(error,
+                        "clGetDeviceInfo failed for "
+                        "CL_DEVICE_MAX_WORK_GROUP_SIZE");
+
+        WorkGroupSweepTable table;
+        int result = TEST_PASS;
+        for (const WorkGroupSweepConfig &config :
+             work_group_sweep_configs(max_local, false))
+        {
+            WorkGroupParams params = test_params_;
+            params.global_workgroup_size = config.global;
+            params.local_workgroup_size = config.local;
+            if (subgroup_test<T, U>::run(device_, context_, queue_,
+                                         num_elements_, kernel_name.c_str(),
+                                         source.c_str(), params, batch_program,
+                                         &table)
+                == TEST_FAIL)
+            {
+                log_error("ERROR: %s(%s) failed for global size %zu, local "
+                          "size %zu\n",
+                          kernel_name.c_str(), TypeManager<T>::name(),
+                          config.global, config.local);
+                result = TEST_FAIL;
+            }
+        }
+        table.print();
+        return result;
+    }
+
+    // Keyed by type name and function name; shared by the copies of this
+    // object handed to the per-type run functions.
+    typedef std::map<std::string, clProgramWrapper> BatchPrograms;
+
+    std::string kernel_source(const std::string &function_name)
+    {
+        return std::regex_replace(test_params_.get_kernel_source(function_name),
+                                  std::regex("\\%s"), function_name);
+    }
+    template <typename T>
+    std::string batch_key(const std::string &function_name) const
+    {
+        return std::string(TypeManager<T>::name()) + " " + function_name;
+    }
+
     cl_device_id device_;
     cl_context context_;
     cl_command_queue queue_;
     int num_elements_;
     WorkGroupParams test_params_;
+    std::shared_ptr<BatchPrograms> batch_programs_;
 };
 
 #endif
@@ -72,6 +72,7 @@ template <typename Ty, ArithmeticOp operation> struct RED_CLU
         int ng = test_params.global_workgroup_size;
         int nj = (nw + ns - 1) / ns;
         ng = ng / nw;
+        std::vector<Ty> expected(ns);
 
         for (int k = 0; k < ng; ++k)
         {
@@ -101,27 +102,16 @@ template <typename Ty, ArithmeticOp operation> struct RED_CLU
             {
                 int ii = j * ns;
                 int n = ii + ns > nw ? nw - ii : ns;
-                std::vector<Ty> clusters_results;
-                int clusters_counter = (ns + test_params.cluster_size - 1)
-                    / test_params.cluster_size;
-                clusters_results.resize(clusters_counter);
 
                 // Compute target
-                Ty tr = mx[ii];
-                for (int i = 0; i < n; ++i)
-                {
-                    if (i % test_params.cluster_size == 0)
-                        tr = mx[ii + i];
-                    else
-                        tr = calculate<Ty>(tr, mx[ii + i], operation);
-                    clusters_results[i / test_params.cluster_size] = tr;
-                }
+                reference_clustered_reduce<ArithmeticReference<operation>>(
+                    mx + ii, expected.data(), n, test_params.cluster_size);
 
                 // Check result
                 for (int i = 0; i < n; ++i)
                 {
                     Ty rr = my[ii + i];
-                    tr = clusters_results[i / test_params.cluster_size];
+                    Ty tr = expected[i];
                     if (!compare(rr, tr))
                     {
                         log_error(
@@ -146,37 +136,36 @@ template <typename Ty, ArithmeticOp operation> struct RED_CLU
 template <typename T>
 int run_cluster_red_add_max_min_mul_for_type(RunTestForType rft)
 {
-    int error = rft.run_impl<T, RED_CLU<T, ArithmeticOp::add_>>(
-        "sub_group_clustered_reduce_add");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::max_>>(
-        "sub_group_clustered_reduce_max");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::min_>>(
-        "sub_group_clustered_reduce_min");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::mul_>>(
-        "sub_group_clustered_reduce_mul");
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<RED_CLU<T, ArithmeticOp::add_>>(
+            "sub_group_clustered_reduce_add"),
+        batch_entry<RED_CLU<T, ArithmeticOp::max_>>(
+            "sub_group_clustered_reduce_max"),
+        batch_entry<RED_CLU<T, ArithmeticOp::min_>>(
+            "sub_group_clustered_reduce_min"),
+        batch_entry<RED_CLU<T, ArithmeticOp::mul_>>(
+            "sub_group_clustered_reduce_mul"));
 }
 template <typename T> int run_cluster_and_or_xor_for_type(RunTestForType rft)
 {
-    int error = rft.run_impl<T, RED_CLU<T, ArithmeticOp::and_>>(
-        "sub_group_clustered_reduce_and");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::or_>>(
-        "sub_group_clustered_reduce_or");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::xor_>>(
-        "sub_group_clustered_reduce_xor");
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<RED_CLU<T, ArithmeticOp::and_>>(
+            "sub_group_clustered_reduce_and"),
+        batch_entry<RED_CLU<T, ArithmeticOp::or_>>(
+            "sub_group_clustered_reduce_or"),
+        batch_entry<RED_CLU<T, ArithmeticOp::xor_>>(
+            "sub_group_clustered_reduce_xor"));
 }
 template <typename T>
 int run_cluster_logical_and_or_xor_for_type(RunTestForType rft)
 {
-    int error = rft.run_impl<T, RED_CLU<T, ArithmeticOp::logical_and>>(
-        "sub_group_clustered_reduce_logical_and");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::logical_or>>(
-        "sub_group_clustered_reduce_logical_or");
-    error |= rft.run_impl<T, RED_CLU<T, ArithmeticOp::logical_xor>>(
-        "sub_group_clustered_reduce_logical_xor");
-
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<RED_CLU<T, ArithmeticOp::logical_and>>(
+            "sub_group_clustered_reduce_logical_and"),
+        batch_entry<RED_CLU<T, ArithmeticOp::logical_or>>(
+            "sub_group_clustered_reduce_logical_or"),
+        batch_entry<RED_CLU<T, ArithmeticOp::logical_xor>>(
+            "sub_group_clustered_reduce_logical_xor"));
 }
 }
 
@@ -29,25 +29,22 @@ template <typename T> int run_broadcast_for_extended_type(RunTestForType rft)
 
 template <typename T> int run_scan_reduction_for_type(RunTestForType rft)
 {
-    int error =
-        rft.run_impl<T, RED_NU<T, ArithmeticOp::add_>>("sub_group_reduce_add");
-    error |=
-        rft.run_impl<T, RED_NU<T, ArithmeticOp::max_>>("sub_group_reduce_max");
-    error |=
-        rft.run_impl<T, RED_NU<T, ArithmeticOp::min_>>("sub_group_reduce_min");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::add_>>(
-        "sub_group_scan_inclusive_add");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::max_>>(
-        "sub_group_scan_inclusive_max");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::min_>>(
-        "sub_group_scan_inclusive_min");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::add_>>(
-        "sub_group_scan_exclusive_add");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::max_>>(
-        "sub_group_scan_exclusive_max");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::min_>>(
-        "sub_group_scan_exclusive_min");
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<RED_NU<T, ArithmeticOp::add_>>("sub_group_reduce_add"),
+        batch_entry<RED_NU<T, ArithmeticOp::max_>>("sub_group_reduce_max"),
+        batch_entry<RED_NU<T, ArithmeticOp::min_>>("sub_group_reduce_min"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::add_>>(
+            "sub_group_scan_inclusive_add"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::max_>>(
+            "sub_group_scan_inclusive_max"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::min_>>(
+            "sub_group_scan_inclusive_min"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::add_>>(
+            "sub_group_scan_exclusive_add"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::max_>>(
+            "sub_group_scan_exclusive_max"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::min_>>(
+            "sub_group_scan_exclusive_min"));
 }
 
 
@@ -44,78 +44,78 @@ std::string sub_group_non_uniform_arithmetic_source = R"(
 template <typename T>
 int run_functions_add_mul_max_min_for_type(RunTestForType rft)
 {
-    int error = rft.run_impl<T, SCIN_NU<T, ArithmeticOp::add_>>(
-        "sub_group_non_uniform_scan_inclusive_add");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::mul_>>(
-        "sub_group_non_uniform_scan_inclusive_mul");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::max_>>(
-        "sub_group_non_uniform_scan_inclusive_max");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::min_>>(
-        "sub_group_non_uniform_scan_inclusive_min");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::add_>>(
-        "sub_group_non_uniform_scan_exclusive_add");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::mul_>>(
-        "sub_group_non_uniform_scan_exclusive_mul");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::max_>>(
-        "sub_group_non_uniform_scan_exclusive_max");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::min_>>(
-        "sub_group_non_uniform_scan_exclusive_min");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::add_>>(
-        "sub_group_non_uniform_reduce_add");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::mul_>>(
-        "sub_group_non_uniform_reduce_mul");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::max_>>(
-        "sub_group_non_uniform_reduce_max");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::min_>>(
-        "sub_group_non_uniform_reduce_min");
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<SCIN_NU<T, ArithmeticOp::add_>>(
+            "sub_group_non_uniform_scan_inclusive_add"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::mul_>>(
+            "sub_group_non_uniform_scan_inclusive_mul"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::max_>>(
+            "sub_group_non_uniform_scan_inclusive_max"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::min_>>(
+            "sub_group_non_uniform_scan_inclusive_min"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::add_>>(
+            "sub_group_non_uniform_scan_exclusive_add"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::mul_>>(
+            "sub_group_non_uniform_scan_exclusive_mul"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::max_>>(
+            "sub_group_non_uniform_scan_exclusive_max"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::min_>>(
+            "sub_group_non_uniform_scan_exclusive_min"),
+        batch_entry<RED_NU<T, ArithmeticOp::add_>>(
+            "sub_group_non_uniform_reduce_add"),
+        batch_entry<RED_NU<T, ArithmeticOp::mul_>>(
+            "sub_group_non_uniform_reduce_mul"),
+        batch_entry<RED_NU<T, ArithmeticOp::max_>>(
+            "sub_group_non_uniform_reduce_max"),
+        batch_entry<RED_NU<T, ArithmeticOp::min_>>(
+            "sub_group_non_uniform_reduce_min"));
 }
 
 template <typename T> int run_functions_and_or_xor_for_type(RunTestForType rft)
 {
-    int error = rft.run_impl<T, SCIN_NU<T, ArithmeticOp::and_>>(
-        "sub_group_non_uniform_scan_inclusive_and");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::or_>>(
-        "sub_group_non_uniform_scan_inclusive_or");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::xor_>>(
-        "sub_group_non_uniform_scan_inclusive_xor");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::and_>>(
-        "sub_group_non_uniform_scan_exclusive_and");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::or_>>(
-        "sub_group_non_uniform_scan_exclusive_or");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::xor_>>(
-        "sub_group_non_uniform_scan_exclusive_xor");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::and_>>(
-        "sub_group_non_uniform_reduce_and");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::or_>>(
-        "sub_group_non_uniform_reduce_or");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::xor_>>(
-        "sub_group_non_uniform_reduce_xor");
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<SCIN_NU<T, ArithmeticOp::and_>>(
+            "sub_group_non_uniform_scan_inclusive_and"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::or_>>(
+            "sub_group_non_uniform_scan_inclusive_or"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::xor_>>(
+            "sub_group_non_uniform_scan_inclusive_xor"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::and_>>(
+            "sub_group_non_uniform_scan_exclusive_and"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::or_>>(
+            "sub_group_non_uniform_scan_exclusive_or"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::xor_>>(
+            "sub_group_non_uniform_scan_exclusive_xor"),
+        batch_entry<RED_NU<T, ArithmeticOp::and_>>(
+            "sub_group_non_uniform_reduce_and"),
+        batch_entry<RED_NU<T, ArithmeticOp::or_>>(
+            "sub_group_non_uniform_reduce_or"),
+        batch_entry<RED_NU<T, ArithmeticOp::xor_>>(
+            "sub_group_non_uniform_reduce_xor"));
 }
 
 template <typename T>
 int run_functions_logical_and_or_xor_for_type(RunTestForType rft)
 {
-    int error = rft.run_impl<T, SCIN_NU<T, ArithmeticOp::logical_and>>(
-        "sub_group_non_uniform_scan_inclusive_logical_and");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::logical_or>>(
-        "sub_group_non_uniform_scan_inclusive_logical_or");
-    error |= rft.run_impl<T, SCIN_NU<T, ArithmeticOp::logical_xor>>(
-        "sub_group_non_uniform_scan_inclusive_logical_xor");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::logical_and>>(
-        "sub_group_non_uniform_scan_exclusive_logical_and");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::logical_or>>(
-        "sub_group_non_uniform_scan_exclusive_logical_or");
-    error |= rft.run_impl<T, SCEX_NU<T, ArithmeticOp::logical_xor>>(
-        "sub_group_non_uniform_scan_exclusive_logical_xor");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::logical_and>>(
-        "sub_group_non_uniform_reduce_logical_and");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::logical_or>>(
-        "sub_group_non_uniform_reduce_logical_or");
-    error |= rft.run_impl<T, RED_NU<T, ArithmeticOp::logical_xor>>(
-        "sub_group_non_uniform_reduce_logical_xor");
-    return error;
+    return rft.run_batch<T>(
+        batch_entry<SCIN_NU<T, ArithmeticOp::logical_and>>(
+            "sub_group_non_uniform_scan_inclusive_logical_and"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::logical_or>>(
+            "sub_group_non_uniform_scan_inclusive_logical_or"),
+        batch_entry<SCIN_NU<T, ArithmeticOp::logical_xor>>(
+            "sub_group_non_uniform_scan_inclusive_logical_xor"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::logical_and>>(
+            "sub_group_non_uniform_scan_exclusive_logical_and"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::logical_or>>(
+            "sub_group_non_uniform_scan_exclusive_logical_or"),
+        batch_entry<SCEX_NU<T, ArithmeticOp::logical_xor>>(
+            "sub_group_non_uniform_scan_exclusive_logical_xor"),
+        batch_entry<RED_NU<T, ArithmeticOp::logical_and>>(
+            "sub_group_non_uniform_reduce_logical_and"),
+        batch_entry<RED_NU<T, ArithmeticOp::logical_or>>(
+            "sub_group_non_uniform_reduce_logical_or"),
+        batch_entry<RED_NU<T, ArithmeticOp::logical_xor>>(
+            "sub_group_non_uniform_reduce_logical_xor"));
 }
 
 }
@@ -56,9 +56,22 @@ test_status InitCL(cl_device_id device) {
   return TEST_PASS;
 }
 
+bool gWorkGroupSweep = false;
+
 int main(int argc, const char *argv[]) {
+    // Sweep every local size and several global sizes, with timings. The
+    // flag may appear anywhere on the command line and is removed before the
+    // harness parses it.
+    int argCount = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-sweep") == 0)
+            gWorkGroupSweep = true;
+        else
+            argv[argCount++] = argv[i];
+    }
     return runTestHarnessWithCheck(
-        argc, argv, test_registry::getInstance().num_tests(),
+        argCount, argv, test_registry::getInstance().num_tests(),
         test_registry::getInstance().definitions(), false, 0, InitCL);
 }
 
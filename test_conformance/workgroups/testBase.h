@@ -29,4 +29,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+// Set by -sweep: run each test over every local size and several global
+// sizes and print the dispatch times
+extern bool gWorkGroupSweep;
+
 #endif // _testBase_h
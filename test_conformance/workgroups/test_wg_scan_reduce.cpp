@@ -14,6 +14,8 @@
 // limitations under the License.
 //
 #include "harness/compat.h"
+#include "harness/scanReduceReference.h"
+#include "harness/workGroupSweep.h"
 
 #include <algorithm>
 #include <limits>
@@ -100,27 +102,20 @@ template <typename C> struct Reduce
     static int verify(Type *inptr, Type *outptr, size_t n_elems,
                       size_t max_wg_size)
     {
-        for (size_t i = 0; i < n_elems; i += max_wg_size)
-        {
-            size_t wg_size = std::min(max_wg_size, n_elems - i);
-
-            Type result = C::identityValue;
-            for (size_t j = 0; j < wg_size; j++)
-            {
-                result = C::combine(result, inptr[i + j]);
-            }
-
-            for (size_t j = 0; j < wg_size; j++)
-            {
-                if (result != outptr[i + j])
+        return reference_for_each_segment(
+            n_elems, max_wg_size, [&](size_t i, size_t wg_size) {
+                Type result = reference_reduce<C>(inptr + i, wg_size);
+                for (size_t j = 0; j < wg_size; j++)
                 {
-                    log_info("%s_%s: Error at %zu\n", testName, testOpName,
-                             i + j);
-                    return -1;
+                    if (result != outptr[i + j])
+                    {
+                        log_info("%s_%s: Error at %zu\n", testName,
+                                 testOpName, i + j);
+                        return -1;
+                    }
                 }
-            }
-        }
-        return 0;
+                return 0;
+            });
     }
 };
 
@@ -136,23 +131,22 @@ template <typename C> struct ScanInclusive
     static int verify(Type *inptr, Type *outptr, size_t n_elems,
                       size_t max_wg_size)
     {
-        for (size_t i = 0; i < n_elems; i += max_wg_size)
-        {
-            size_t wg_size = std::min(max_wg_size, n_elems - i);
-
-            Type result = C::identityValue;
-            for (size_t j = 0; j < wg_size; ++j)
-            {
-                result = C::combine(result, inptr[i + j]);
-                if (result != outptr[i + j])
+        std::vector<Type> expected(n_elems);
+        return reference_for_each_segment(
+            n_elems, max_wg_size, [&](size_t i, size_t wg_size) {
+                reference_scan_inclusive<C>(inptr + i, expected.data() + i,
+                                            wg_size, C::identityValue);
+                for (size_t j = 0; j < wg_size; ++j)
                 {
-                    log_info("%s_%s: Error at %zu\n", testName, testOpName,
-                             i + j);
-                    return -1;
+                    if (expected[i + j] != outptr[i + j])
+                    {
+                        log_info("%s_%s: Error at %zu\n", testName,
+                                 testOpName, i + j);
+                        return -1;
+                    }
                 }
-            }
-        }
-        return 0;
+                return 0;
+            });
     }
 };
 
@@ -168,58 +162,37 @@ template <typename C> struct ScanExclusive
     static int verify(Type *inptr, Type *outptr, size_t n_elems,
                       size_t max_wg_size)
     {
-        for (size_t i = 0; i < n_elems; i += max_wg_size)
-        {
-            size_t wg_size = std::min(max_wg_size, n_elems - i);
-
-            Type result = C::identityValue;
-            for (size_t j = 0; j < wg_size; ++j)
-            {
-                if (result != outptr[i + j])
+        std::vector<Type> expected(n_elems);
+        return reference_for_each_segment(
+            n_elems, max_wg_size, [&](size_t i, size_t wg_size) {
+                reference_scan_exclusive<C>(inptr + i, expected.data() + i,
+                                            wg_size, C::identityValue);
+                for (size_t j = 0; j < wg_size; ++j)
                 {
-                    log_info("%s_%s: Error at %zu\n", testName, testOpName,
-                             i + j);
-                    return -1;
+                    if (expected[i + j] != outptr[i + j])
+                    {
+                        log_info("%s_%s: Error at %zu\n", testName,
+                                 testOpName, i + j);
+                        return -1;
+                    }
                 }
-                result = C::combine(result, inptr[i + j]);
-            }
-        }
-        return 0;
+                return 0;
+            });
     }
 };
 
+// Runs kernel over one NDRange on fresh random input and verifies the result.
+// With a table the dispatch is timed on its own and recorded.
 template <typename TestInfo>
-static int run_test(cl_device_id device, cl_context context,
-                    cl_command_queue queue, int n_elems)
+static int run_config(cl_context context, cl_command_queue queue,
+                      cl_kernel kernel, const WorkGroupSweepConfig &config,
+                      const std::string &kernelName,
+                      WorkGroupSweepTable *table)
 {
     using T = typename TestInfo::Type;
 
     cl_int err = CL_SUCCESS;
-
-    clProgramWrapper program;
-    clKernelWrapper kernel;
-
-    std::string funcName = TestInfo::testName;
-    funcName += "_";
-    funcName += TestInfo::testOpName;
-
-    std::string kernelName = TestInfo::kernelName;
-    kernelName += "_";
-    kernelName += TestInfo::testOpName;
-    kernelName += "_";
-    kernelName += TestInfo::deviceTypeName;
-
-    std::string kernelString =
-        make_kernel_string(TestInfo::deviceTypeName, kernelName, funcName);
-
-    const char *kernel_source = kernelString.c_str();
-    err = create_single_kernel_helper(context, &program, &kernel, 1,
-                                      &kernel_source, kernelName.c_str());
-    test_error(err, "Unable to create test kernel");
-
-    size_t wg_size[1];
-    err = get_max_allowed_1d_work_group_size_on_device(device, kernel, wg_size);
-    test_error(err, "get_max_allowed_1d_work_group_size_on_device failed");
+    size_t n_elems = config.global;
 
     clMemWrapper src = clCreateBuffer(context, CL_MEM_READ_WRITE,
                                       sizeof(T) * n_elems, NULL, &err);
@@ -232,7 +205,7 @@ static int run_test(cl_device_id device, cl_context context,
     std::vector<T> input_ptr(n_elems);
 
     MTdataHolder d(gRandomSeed);
-    for (int i = 0; i < n_elems; i++)
+    for (size_t i = 0; i < n_elems; i++)
     {
         input_ptr[i] = (T)genrand_int64(d);
     }
@@ -246,10 +219,19 @@ static int run_test(cl_device_id device, cl_context context,
     err |= clSetKernelArg(kernel, 1, sizeof(dst), &dst);
     test_error(err, "Unable to set dst buffer kernel arg");
 
-    size_t global_work_size[] = { (size_t)n_elems };
-    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, global_work_size,
-                                 wg_size, 0, NULL, NULL);
-    test_error(err, "Unable to enqueue test kernel");
+    if (table)
+    {
+        double seconds;
+        err = time_work_group_dispatch(queue, kernel, config, &seconds);
+        if (err != CL_SUCCESS) return err;
+        table->add(kernelName, config, seconds);
+    }
+    else
+    {
+        err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &config.global,
+                                     &config.local, 0, NULL, NULL);
+        test_error(err, "Unable to enqueue test kernel");
+    }
 
     std::vector<T> output_ptr(n_elems);
 
@@ -260,12 +242,72 @@ static int run_test(cl_device_id device, cl_context context,
     test_error(err, "clEnqueueReadBuffer to read read dst buffer failed");
 
     if (TestInfo::verify(input_ptr.data(), output_ptr.data(), n_elems,
-                         wg_size[0]))
+                         config.local))
     {
-        log_error("%s_%s %s failed\n", TestInfo::testName, TestInfo::testOpName,
-                  TestInfo::deviceTypeName);
+        log_error("%s_%s %s failed for global size %zu, local size %zu\n",
+                  TestInfo::testName, TestInfo::testOpName,
+                  TestInfo::deviceTypeName, config.global, config.local);
         return TEST_FAIL;
     }
+    return TEST_PASS;
+}
+
+template <typename TestInfo>
+static int run_test(cl_device_id device, cl_context context,
+                    cl_command_queue queue, int n_elems)
+{
+    cl_int err = CL_SUCCESS;
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+
+    std::string funcName = TestInfo::testName;
+    funcName += "_";
+    funcName += TestInfo::testOpName;
+
+    std::string kernelName = TestInfo::kernelName;
+    kernelName += "_";
+    kernelName += TestInfo::testOpName;
+    kernelName += "_";
+    kernelName += TestInfo::deviceTypeName;
+
+    std::string kernelString =
+        make_kernel_string(TestInfo::deviceTypeName, kernelName, funcName);
+
+    const char *kernel_source = kernelString.c_str();
+    err = create_single_kernel_helper(context, &program, &kernel, 1,
+                                      &kernel_source, kernelName.c_str());
+    test_error(err, "Unable to create test kernel");
+
+    size_t wg_size[1];
+    err = get_max_allowed_1d_work_group_size_on_device(device, kernel, wg_size);
+    test_error(err, "get_max_allowed_1d_work_group_size_on_device failed");
+
+    if (gWorkGroupSweep)
+    {
+        WorkGroupSweepTable table;
+        int result = TEST_PASS;
+        for (const WorkGroupSweepConfig &config : work_group_sweep_configs(
+                 wg_size[0], work_group_sweep_non_uniform(device)))
+        {
+            err = run_config<TestInfo>(context, queue, kernel, config,
+                                       kernelName, &table);
+            if (err == TEST_FAIL)
+                result = TEST_FAIL;
+            else if (err != CL_SUCCESS)
+                return TEST_FAIL;
+        }
+        table.print();
+        if (result != TEST_PASS) return result;
+    }
+    else
+    {
+        WorkGroupSweepConfig config = { (size_t)n_elems, wg_size[0] };
+        err = run_config<TestInfo>(context, queue, kernel, config, kernelName,
+                                   NULL);
+        if (err == TEST_FAIL) return TEST_FAIL;
+        test_error(err, "Unable to run test kernel");
+    }
 
     log_info("%s_%s %s passed\n", TestInfo::testName, TestInfo::testOpName,
              TestInfo::deviceTypeName);